@@ -1,135 +1,262 @@
 #include <stdint.h>
 
-const uint8_t fontBMP[5168] =
+// one byte per glyph row, MSB is the leftmost pixel
+const uint8_t fontBMP[1280] =
 {
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,1,1,0,1,1,0,0,1,1,1,1,1,1,1,0,0,1,1,0,1,1,0,0,1,1,1,1,1,1,1,0,0,1,1,0,1,1,0,0,
-	0,1,1,1,1,1,1,0,1,1,0,1,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,1,0,1,1,0,1,1,1,1,1,1,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,1,1,0,0,1,1,0,0,1,1,0,
-	0,0,1,1,0,0,0,0,0,1,0,0,1,0,0,0,0,0,1,1,1,0,1,0,0,1,0,0,0,1,0,0,0,0,1,1,1,0,1,0,
-	0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,
-	0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,
-	0,1,0,0,0,1,0,0,0,0,1,1,1,0,0,0,0,1,1,1,1,1,0,0,0,0,1,1,1,0,0,0,0,1,0,0,0,1,0,0,
-	0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,
-	0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,1,1,1,0,0,1,1,1,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,0,0,1,1,0,0,0,0,0,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,
-	0,1,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,0,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,1,0,
-	0,1,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,0,0,0,0,0,0,0,1,1,0,0,1,1,1,1,1,0,0,
-	0,0,0,1,1,1,0,0,0,0,1,1,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,1,1,1,1,0,0,0,0,0,1,1,0,0,
-	0,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,1,1,1,1,1,0,0,
-	0,0,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,1,1,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,1,0,0,0,0,0,0,1,1,0,0,1,1,1,1,1,0,0,
-	0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,
-	0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,
-	0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,
-	0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,
-	0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,
-	0,1,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,1,1,1,0,0,1,1,0,1,1,1,0,0,1,1,0,0,0,0,0,0,0,1,1,1,1,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,
-	0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,
-	0,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,1,0,
-	0,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,
-	0,0,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,1,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,1,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,
-	0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,
-	0,1,1,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,1,1,1,1,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,0,1,1,0,
-	0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,1,0,
-	0,1,0,0,0,0,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,
-	0,1,1,0,0,1,1,0,0,1,1,1,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,1,1,1,0,0,1,1,0,0,1,1,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,0,1,1,0,1,1,0,
-	0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,0,1,1,0,
-	0,0,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,1,1,1,1,1,0,0,
-	0,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,0,0,0,0,1,0,
-	0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,
-	0,1,1,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,1,1,0,
-	0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,
-	0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,1,0,
-	0,0,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,1,1,1,1,0,0,
-	0,0,0,1,0,0,0,0,0,0,1,1,1,0,0,0,0,1,1,0,1,1,0,0,0,1,0,0,0,1,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,
-	0,0,1,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,
-	0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,
-	0,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,1,0,
-	0,1,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,
-	0,0,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,1,1,0,1,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,1,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,
-	0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,
-	0,1,1,1,1,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,1,1,1,1,0,0,0,0,1,1,0,1,1,0,0,0,1,1,0,0,1,1,0,
-	0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,1,1,0,
-	0,1,0,0,0,0,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,
-	0,1,1,0,0,1,1,0,0,1,1,1,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,1,1,1,0,0,1,1,0,0,1,1,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,
-	0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,1,1,0,0,0,0,1,1,0,1,1,0,
-	0,1,1,1,1,1,0,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,0,0,0,1,1,0,1,1,0,0,0,1,1,0,0,1,1,0,
-	0,0,1,1,1,1,1,0,0,1,1,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,1,1,0,0,1,1,1,1,1,0,0,
-	0,1,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,1,1,1,1,0,0,1,1,0,0,1,1,0,0,1,0,0,0,0,1,0,
-	0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,0,0,0,1,1,0,0,1,1,0,
-	0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0,0,0,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,
-	0,1,1,1,1,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,0,0,0,0,0,1,1,1,1,1,1,0,
-	0,0,0,1,1,1,0,0,0,0,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,1,1,0,0,
-	0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,
-	0,0,1,1,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,0,0,0,0,1,1,1,0,0,0,
-	0,0,1,1,1,0,1,1,0,1,1,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,1,1,0,0,0,0,1,1,0,1,1,0,0,0,1,1,1,1,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x18,0x18,0x18,0x00,0x18,
+	0x66,0x66,0x00,0x00,0x00,
+	0x6C,0xFE,0x6C,0xFE,0x6C,
+	0x7E,0xD0,0x7C,0x16,0xFC,
+	0x66,0x6C,0x18,0x36,0x66,
+	0x30,0x48,0x3A,0x44,0x3A,
+	0x0C,0x0C,0x18,0x00,0x00,
+	0x0C,0x18,0x18,0x18,0x0C,
+	0x18,0x0C,0x0C,0x0C,0x18,
+	0x44,0x38,0x7C,0x38,0x44,
+	0x10,0x10,0x7C,0x10,0x10,
+	0x00,0x00,0x00,0x0C,0x18,
+	0x00,0x00,0x7C,0x00,0x00,
+	0x00,0x00,0x00,0x18,0x18,
+	0x06,0x0C,0x18,0x30,0x60,
+	0x3C,0x6E,0x76,0x66,0x3C,
+	0x18,0x38,0x18,0x18,0x3C,
+	0x7C,0x06,0x3C,0x60,0x7E,
+	0x7C,0x06,0x1C,0x06,0x7C,
+	0x1C,0x3C,0x6C,0x7E,0x0C,
+	0x7E,0x60,0x7C,0x06,0x7C,
+	0x3E,0x60,0x7C,0x66,0x3C,
+	0x7E,0x06,0x0C,0x18,0x18,
+	0x3C,0x66,0x3C,0x66,0x3C,
+	0x3C,0x66,0x3E,0x06,0x7C,
+	0x18,0x18,0x00,0x18,0x18,
+	0x18,0x18,0x00,0x18,0x30,
+	0x0C,0x18,0x30,0x18,0x0C,
+	0x00,0x3C,0x00,0x3C,0x00,
+	0x30,0x18,0x0C,0x18,0x30,
+	0x7C,0x06,0x1C,0x00,0x18,
+	0x3C,0x6E,0x6E,0x60,0x3C,
+	0x3C,0x66,0x7E,0x66,0x66,
+	0x7C,0x66,0x7C,0x66,0x7C,
+	0x3C,0x66,0x60,0x66,0x3C,
+	0x7C,0x66,0x66,0x66,0x7C,
+	0x7E,0x60,0x78,0x60,0x7E,
+	0x7E,0x60,0x78,0x60,0x60,
+	0x3E,0x60,0x6E,0x66,0x3E,
+	0x66,0x66,0x7E,0x66,0x66,
+	0x3C,0x18,0x18,0x18,0x3C,
+	0x7E,0x06,0x06,0x66,0x3C,
+	0x66,0x6C,0x78,0x6C,0x66,
+	0x60,0x60,0x60,0x60,0x7E,
+	0x42,0x66,0x7E,0x66,0x66,
+	0x66,0x76,0x7E,0x6E,0x66,
+	0x3C,0x66,0x66,0x66,0x3C,
+	0x7C,0x66,0x7C,0x60,0x60,
+	0x3C,0x66,0x66,0x6C,0x36,
+	0x7C,0x66,0x7C,0x6C,0x66,
+	0x3E,0x60,0x3C,0x06,0x7C,
+	0x7E,0x18,0x18,0x18,0x18,
+	0x66,0x66,0x66,0x66,0x3C,
+	0x66,0x66,0x66,0x3C,0x18,
+	0x66,0x66,0x7E,0x66,0x42,
+	0x66,0x3C,0x18,0x3C,0x66,
+	0x66,0x66,0x3C,0x18,0x18,
+	0x7E,0x0C,0x18,0x30,0x7E,
+	0x3C,0x30,0x30,0x30,0x3C,
+	0x60,0x30,0x18,0x0C,0x06,
+	0x3C,0x0C,0x0C,0x0C,0x3C,
+	0x10,0x38,0x6C,0x44,0x00,
+	0x00,0x00,0x00,0x00,0x7E,
+	0x30,0x18,0x00,0x00,0x00,
+	0x3C,0x66,0x7E,0x66,0x66,
+	0x7C,0x66,0x7C,0x66,0x7C,
+	0x3C,0x66,0x60,0x66,0x3C,
+	0x7C,0x66,0x66,0x66,0x7C,
+	0x7E,0x60,0x78,0x60,0x7E,
+	0x7E,0x60,0x78,0x60,0x60,
+	0x3E,0x60,0x6E,0x66,0x3E,
+	0x66,0x66,0x7E,0x66,0x66,
+	0x3C,0x18,0x18,0x18,0x3C,
+	0x7E,0x06,0x06,0x66,0x3C,
+	0x66,0x6C,0x78,0x6C,0x66,
+	0x60,0x60,0x60,0x60,0x7E,
+	0x42,0x66,0x7E,0x66,0x66,
+	0x66,0x76,0x7E,0x6E,0x66,
+	0x3C,0x66,0x66,0x66,0x3C,
+	0x7C,0x66,0x7C,0x60,0x60,
+	0x3C,0x66,0x66,0x6C,0x36,
+	0x7C,0x66,0x7C,0x6C,0x66,
+	0x3E,0x60,0x3C,0x06,0x7C,
+	0x7E,0x18,0x18,0x18,0x18,
+	0x66,0x66,0x66,0x66,0x3C,
+	0x66,0x66,0x66,0x3C,0x18,
+	0x66,0x66,0x7E,0x66,0x42,
+	0x66,0x3C,0x18,0x3C,0x66,
+	0x66,0x66,0x3C,0x18,0x18,
+	0x7E,0x0C,0x18,0x30,0x7E,
+	0x1C,0x20,0x60,0x20,0x1C,
+	0x18,0x18,0x18,0x18,0x18,
+	0x38,0x04,0x06,0x04,0x38,
+	0x3B,0x6E,0x00,0x00,0x00,
+	0x60,0x60,0x78,0x6C,0x78,
+	0x00,0x00,0x18,0x18,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00
 };
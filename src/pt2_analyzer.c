@@ -0,0 +1,284 @@
+/* Module analyzer (--analyze). Writes one JSON line per module to stdout:
+**
+** {"file":"x.mod","format":"FORMAT_MK","title":"...","patterns":12,"orders":20,
+**  "usedSamples":[1,2],"unusedSamples":[5],"sampleBytes":123456,"duration":181.352,
+**  "effects":["0","C","E9"],"maxVoices":4,"loops":true,"loopOrder":0,"loopRow":0}
+**
+** or {"file":"x.mod","error":"..."} if the module couldn't be loaded.
+**
+** The song stats come from stepping the replayer through the song without mixing
+** (calcSongStats()). The replayer uses global state, so files are spread over one
+** worker process per CPU core (not on Windows, where there's no fork()).
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdarg.h>
+#include <SDL2/SDL.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+#include "pt2_header.h"
+#include "pt2_cli.h"
+#include "pt2_analyzer.h"
+
+static const char *formatNames[FORMAT_UNKNOWN+1] =
+{
+	"FORMAT_MK", "FORMAT_MK2", "FORMAT_FLT4", "FORMAT_1CHN", "FORMAT_2CHN", "FORMAT_3CHN",
+	"FORMAT_4CHN", "FORMAT_STK", "FORMAT_NT", "FORMAT_FEST", "FORMAT_UNKNOWN"
+};
+
+static char line[ANALYZER_LINE_LEN];
+static int32_t lineLen;
+
+static void lineAdd(const char *fmt, ...)
+{
+	int32_t len;
+	va_list args;
+
+	if (lineLen >= ANALYZER_LINE_LEN-1)
+		return;
+
+	va_start(args, fmt);
+	len = vsnprintf(&line[lineLen], ANALYZER_LINE_LEN - lineLen, fmt, args);
+	va_end(args);
+
+	if (len > 0)
+		lineLen += len;
+
+	if (lineLen > ANALYZER_LINE_LEN-1)
+		lineLen = ANALYZER_LINE_LEN-1;
+}
+
+// Amiga texts are treated as ISO-8859-1, file names are passed through as they are (UTF-8)
+static void lineAddString(const char *str, bool latin1)
+{
+	uint8_t c;
+
+	lineAdd("\"");
+	while (*str != '\0')
+	{
+		c = (uint8_t)*str++;
+
+		if (c == '"' || c == '\\')
+			lineAdd("\\%c", c);
+		else if (c < 0x20 || c == 0x7F || (latin1 && c >= 0x80))
+			lineAdd("\\u%04x", c);
+		else
+			lineAdd("%c", c);
+	}
+	lineAdd("\"");
+}
+
+// one write() per line, so that lines from different workers don't get mixed up
+static void lineFlush(void)
+{
+	line[lineLen++] = '\n';
+
+#ifdef _WIN32
+	fwrite(line, 1, lineLen, stdout);
+#else
+	const char *ptr = line;
+	while (lineLen > 0)
+	{
+		ssize_t written = write(STDOUT_FILENO, ptr, lineLen);
+		if (written <= 0)
+			break;
+
+		ptr += written;
+		lineLen -= (int32_t)written;
+	}
+#endif
+
+	lineLen = 0;
+}
+
+static void addSampleUsage(void)
+{
+	bool referenced[MOD_SAMPLES], first;
+	uint16_t pattern;
+	note_t *note;
+	moduleSample_t *s;
+
+	memset(referenced, 0, sizeof (referenced));
+	for (int32_t i = 0; i < modEntry->head.orderCount; i++)
+	{
+		pattern = modEntry->head.order[i];
+		if (pattern >= MAX_PATTERNS || modEntry->patterns[pattern] == NULL)
+			continue;
+
+		note = modEntry->patterns[pattern];
+		for (int32_t j = 0; j < MOD_ROWS * AMIGA_VOICES; j++, note++)
+		{
+			if (note->sample >= 1 && note->sample <= MOD_SAMPLES)
+				referenced[note->sample-1] = true;
+		}
+	}
+
+	lineAdd(",\"usedSamples\":[");
+	first = true;
+	for (int32_t i = 0; i < MOD_SAMPLES; i++)
+	{
+		s = &modEntry->samples[i];
+		if (referenced[i] && s->length > 0)
+		{
+			lineAdd(first ? "%d" : ",%d", i+1);
+			first = false;
+		}
+	}
+
+	lineAdd("],\"unusedSamples\":[");
+	first = true;
+	for (int32_t i = 0; i < MOD_SAMPLES; i++)
+	{
+		s = &modEntry->samples[i];
+		if (!referenced[i] && s->length > 0)
+		{
+			lineAdd(first ? "%d" : ",%d", i+1);
+			first = false;
+		}
+	}
+	lineAdd("]");
+}
+
+static void addModuleLine(char *fileName)
+{
+	bool first;
+	uint32_t sampleBytes;
+	songStats_t stats;
+
+	lineAdd("{\"file\":");
+	lineAddString(fileName, false);
+
+	lineAdd(",\"format\":\"%s\",\"title\":", formatNames[(modEntry->head.format <= FORMAT_UNKNOWN) ? modEntry->head.format : FORMAT_UNKNOWN]);
+	lineAddString(modEntry->head.moduleTitle, true);
+
+	lineAdd(",\"patterns\":%d,\"orders\":%d", modEntry->head.patternCount, modEntry->head.orderCount);
+
+	addSampleUsage();
+
+	sampleBytes = 0;
+	for (int32_t i = 0; i < MOD_SAMPLES; i++)
+		sampleBytes += modEntry->samples[i].length;
+
+	lineAdd(",\"sampleBytes\":%u", sampleBytes);
+
+	calcSongStats(&stats);
+
+	lineAdd(",\"duration\":%.3f,\"effects\":[", stats.dDuration);
+	first = true;
+	for (int32_t i = 0; i < 32; i++)
+	{
+		if (stats.effects & (1UL << i))
+		{
+			if (i < 16)
+				lineAdd(first ? "\"%X\"" : ",\"%X\"", i);
+			else
+				lineAdd(first ? "\"E%X\"" : ",\"E%X\"", i - 16);
+
+			first = false;
+		}
+	}
+
+	lineAdd("],\"maxVoices\":%d,\"loops\":%s", stats.maxVoices, stats.loops ? "true" : "false");
+	if (stats.loops)
+		lineAdd(",\"loopOrder\":%d,\"loopRow\":%d", stats.loopOrder, stats.loopRow);
+
+	lineAdd("}");
+	lineFlush();
+}
+
+// analyzes every n'th file, returns the number of files that couldn't be loaded
+static int32_t analyzeFiles(int32_t first, int32_t step, int32_t numFiles, char *files[])
+{
+	int32_t failed = 0;
+
+	for (int32_t i = first; i < numFiles; i += step)
+	{
+		if (!loadCliModule(files[i]))
+		{
+			lineAdd("{\"file\":");
+			lineAddString(files[i], false);
+			lineAdd(",\"error\":");
+			lineAddString(editor.ui.statusMessage, false);
+			lineAdd("}");
+			lineFlush();
+
+			failed++;
+			continue;
+		}
+
+		addModuleLine(files[i]);
+	}
+
+	return failed;
+}
+
+int32_t analyzeModules(int32_t numFiles, char *files[])
+{
+	int32_t numWorkers, failed;
+	uint64_t time64;
+	double dSeconds;
+
+	if (numFiles < 1)
+	{
+		fprintf(stderr, "usage: pt2-clone --analyze <file> [file ...]\n");
+		return 1;
+	}
+
+	if (!setupCliRenderer())
+		return 1;
+
+	time64 = SDL_GetPerformanceCounter();
+
+#ifdef _WIN32
+	numWorkers = 1;
+#else
+	numWorkers = SDL_GetCPUCount();
+	if (numWorkers > numFiles)
+		numWorkers = numFiles;
+#endif
+
+	failed = 0;
+	if (numWorkers <= 1)
+	{
+		numWorkers = 1;
+		failed = analyzeFiles(0, 1, numFiles, files);
+	}
+#ifndef _WIN32
+	else
+	{
+		int32_t status;
+		pid_t pid;
+
+		fflush(stdout);
+		fflush(stderr);
+
+		for (int32_t i = 0; i < numWorkers; i++)
+		{
+			pid = fork();
+			if (pid == 0)
+				_exit(analyzeFiles(i, numWorkers, numFiles, files) > 0);
+
+			if (pid < 0) // do this worker's files here instead
+				failed += analyzeFiles(i, numWorkers, numFiles, files);
+		}
+
+		while (wait(&status) > 0)
+		{
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+				failed++;
+		}
+	}
+#endif
+
+	dSeconds = (SDL_GetPerformanceCounter() - time64) / (double)SDL_GetPerformanceFrequency();
+	fprintf(stderr, "%d files in %.2fs (%.0f files/s, %d workers)\n", numFiles, dSeconds,
+		(dSeconds > 0.0) ? (numFiles / dSeconds) : 0.0, numWorkers);
+
+	return (failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ANALYZER_MAX_SECONDS (60 * 60) /* safety limit for songs that never end */
+#define ANALYZER_LINE_LEN 4096 /* max JSON line length, lines are written with one write() */
+
+typedef struct songStats_t // filled by calcSongStats() in pt2_modplayer.c
+{
+	bool loops, stops; // stops = ended with F00
+	uint8_t maxVoices;
+	int16_t loopOrder, loopRow; // where playback goes when the song loops
+	uint32_t effects; // bit 0..15 = 0xy..Fxy, bit 16..31 = E0x..EFx
+	double dDuration; // in seconds, until the song stops or loops
+} songStats_t;
+
+void calcSongStats(songStats_t *stats);
+int32_t analyzeModules(int32_t numFiles, char *files[]); // returns the program exit code
@@ -31,6 +31,7 @@
 #include "pt2_textout.h"
 #include "pt2_visuals.h"
 #include "pt2_scopes.h"
+#include "pt2_playlist.h"
 
 #define INITIAL_DITHER_SEED 0x12345000
 
@@ -52,6 +53,10 @@ typedef struct voice_t
 	const int8_t *data, *newData;
 	int32_t length, newLength, pos;
 	double dVolume, dDelta, dPhase, dLastDelta, dLastPhase, dPanL, dPanR;
+
+	// for the replayer trace
+	uint16_t tracePeriod;
+	uint8_t traceVolume, traceFlags;
 } paulaVoice_t;
 
 static volatile int8_t filterFlags;
@@ -60,7 +65,6 @@ static int8_t defStereoSep;
 static bool amigaPanFlag, wavRenderingDone;
 static uint16_t ch1Pan, ch2Pan, ch3Pan, ch4Pan, oldPeriod;
 static int32_t sampleCounter, maxSamplesToMix, randSeed = INITIAL_DITHER_SEED;
-static uint32_t oldScopeDelta;
 static double *dMixBufferL, *dMixBufferR, oldVoiceDelta;
 static blep_t blep[AMIGA_VOICES], blepVol[AMIGA_VOICES];
 static lossyIntegrator_t filterLo, filterHi;
@@ -297,17 +301,12 @@ static void mixerSetVoicePan(uint8_t ch, uint16_t pan) // pan = 0..256
 void mixerKillVoice(uint8_t ch)
 {
 	paulaVoice_t *v;
-	scopeChannelExt_t *s;
 
 	v = &paula[ch];
-	s = &scopeExt[ch];
 
 	v->active = false;
 	v->dVolume = 0.0;
 
-	s->active = false;
-	s->didSwapData = false;
-
 	memset(&blep[ch], 0, sizeof (blep_t));
 	memset(&blepVol[ch], 0, sizeof (blep_t));
 }
@@ -328,7 +327,8 @@ void turnOffVoices(void)
 
 void paulaStopDMA(uint8_t ch)
 {
-	scopeExt[ch].active = paula[ch].active = false;
+	paula[ch].active = false;
+	paula[ch].traceFlags |= TRACE_DMA_STOP;
 }
 
 void paulaStartDMA(uint8_t ch)
@@ -336,8 +336,6 @@ void paulaStartDMA(uint8_t ch)
 	const int8_t *dat;
 	int32_t length;
 	paulaVoice_t *v;
-	scopeChannel_t s, *sc;
-	scopeChannelExt_t *se;
 
 	// trigger voice
 
@@ -357,30 +355,7 @@ void paulaStartDMA(uint8_t ch)
 	v->length = length;
 	v->active = true;
 
-	// trigger scope
-
-	sc = &scope[ch];
-	se = &scopeExt[ch];
-	s = *sc; // cache it
-
-	dat = se->newData;
-	if (dat == NULL)
-		dat = &modEntry->sampleData[RESERVED_SAMPLE_OFFSET]; // dummy sample
-
-	s.length = length;
-	s.data = dat;
-
-	s.pos = 0;
-	s.posFrac = 0;
-
-	// data/length is already set from replayer thread (important)
-	s.loopFlag = se->newLoopFlag;
-	s.loopStart = se->newLoopStart;
-
-	se->didSwapData = false;
-	se->active = true;
-
-	*sc = s; // update it
+	v->traceFlags |= TRACE_DMA_START;
 }
 
 void resetOldPeriods(void)
@@ -394,11 +369,11 @@ void paulaSetPeriod(uint8_t ch, uint16_t period)
 	paulaVoice_t *v;
 
 	v = &paula[ch];
+	v->tracePeriod = period;
 
 	if (period == 0)
 	{
 		v->dDelta = 0.0;
-		setScopeDelta(ch, 0);
 		return;
 	}
 
@@ -409,7 +384,6 @@ void paulaSetPeriod(uint8_t ch, uint16_t period)
 	if (period == oldPeriod)
 	{
 		v->dDelta = oldVoiceDelta;
-		setScopeDelta(ch, oldScopeDelta);
 	}
 	else 
 	{
@@ -422,14 +396,6 @@ void paulaSetPeriod(uint8_t ch, uint16_t period)
 
 		v->dDelta = dPeriodToDeltaDiv / period;
 		oldVoiceDelta = v->dDelta;
-
-		// set scope rate
-
-#if SCOPE_HZ != 64
-#error Scope Hz is not 64 (2^n), change rate calc. to use doubles+round in pt_scope.c
-#endif
-		oldScopeDelta = (PAULA_PAL_CLK * (65536UL / SCOPE_HZ)) / period;
-		setScopeDelta(ch, oldScopeDelta);
 	}
 
 	// for BLEP synthesis
@@ -444,6 +410,67 @@ void paulaSetVolume(uint8_t ch, uint16_t vol)
 		vol = 64;
 
 	paula[ch].dVolume = vol * (1.0 / 64.0);
+	paula[ch].traceVolume = (uint8_t)vol;
+}
+
+/* Advances the voices by a number of output samples without mixing, and returns how
+** many were audible at the start (for the module analyzer). A voice that only plays
+** the two-byte "no loop" part of a sample is not counted.
+*/
+int32_t paulaSkipSamples(int32_t numSamples)
+{
+	int32_t audibleVoices, steps, left;
+	paulaVoice_t *v;
+
+	audibleVoices = 0;
+	for (int32_t i = 0; i < AMIGA_VOICES; i++)
+	{
+		v = &paula[i];
+		if (!v->active)
+			continue;
+
+		if (v->data != NULL && v->dVolume > 0.0 && v->dDelta > 0.0 && v->length > 2)
+			audibleVoices++;
+
+		v->dPhase += v->dDelta * numSamples;
+		steps = (int32_t)v->dPhase;
+		v->dPhase -= steps;
+
+		while (steps > 0)
+		{
+			left = v->length - v->pos;
+			if (steps < left)
+			{
+				v->pos += steps;
+				break;
+			}
+
+			steps -= left;
+
+			v->pos = 0;
+			v->length = v->newLength;
+			v->data = v->newData;
+		}
+	}
+
+	return audibleVoices;
+}
+
+// gets the values written to Paula since the last call (replayer trace)
+void paulaGetTraceState(traceVoice_t *voices)
+{
+	paulaVoice_t *v;
+
+	for (int32_t i = 0; i < AMIGA_VOICES; i++)
+	{
+		v = &paula[i];
+
+		voices[i].period = v->tracePeriod;
+		voices[i].volume = v->traceVolume;
+		voices[i].flags = v->traceFlags;
+
+		v->traceFlags = 0;
+	}
 }
 
 // our Paula simulation takes sample lengths in bytes instead of words
@@ -452,34 +479,16 @@ void paulaSetLength(uint8_t ch, uint32_t len)
 	if (len < 2)
 		len = 2; // needed safety for mixer and scopes
 
-	scopeExt[ch].newLength = paula[ch].newLength = len;
+	paula[ch].newLength = len;
 }
 
 void paulaSetData(uint8_t ch, const int8_t *src)
 {
-	uint8_t smp;
-	moduleSample_t *s;
-	scopeChannelExt_t *se, tmp;
-
-	smp = modEntry->channels[ch].n_samplenum;
-	assert(smp <= 30);
-	s = &modEntry->samples[smp];
-
 	// set voice data
 	if (src == NULL)
 		src = &modEntry->sampleData[RESERVED_SAMPLE_OFFSET]; // dummy sample
 
 	paula[ch].newData = src;
-
-	// set external scope data
-	se = &scopeExt[ch];
-	tmp = *se; // cache it
-
-	tmp.newData = src;
-	tmp.newLoopFlag = (s->loopStart + s->loopLength) > 2;
-	tmp.newLoopStart = s->loopStart;
-
-	*se = tmp; // update it
 }
 
 void toggleA500Filters(void)
@@ -499,21 +508,28 @@ void toggleA500Filters(void)
 
 void mixChannels(int32_t numSamples)
 {
+	bool tapVoices;
 	const int8_t *dataPtr;
+	int32_t j;
 	double dTempSample, dTempVolume;
+	float *fTapData;
 	blep_t *bSmp, *bVol;
 	paulaVoice_t *v;
 
 	memset(dMixBufferL, 0, numSamples * sizeof (double));
 	memset(dMixBufferR, 0, numSamples * sizeof (double));
 
+	// the scopes and real VU-meters read the voice output from the mixer tap (not when rendering)
+	tapVoices = !editor.isWAVRendering && !editor.isSMPRendering;
+
 	for (int32_t i = 0; i < AMIGA_VOICES; i++)
 	{
 		v = &paula[i];
 		bSmp = &blep[i];
 		bVol = &blepVol[i];
+		fTapData = scopeTap[i].fData;
 
-		for (int32_t j = 0; v->active && j < numSamples; j++)
+		for (j = 0; v->active && j < numSamples; j++)
 		{
 			dataPtr = v->data;
 			if (dataPtr == NULL)
@@ -545,6 +561,9 @@ void mixChannels(int32_t numSamples)
 
 			dTempSample *= dTempVolume;
 
+			if (tapVoices)
+				fTapData[(scopeTapWritePos + j) & SCOPE_TAP_MASK] = (float)dTempSample;
+
 			dMixBufferL[j] += dTempSample * v->dPanL;
 			dMixBufferR[j] += dTempSample * v->dPanR;
 
@@ -566,6 +585,12 @@ void mixChannels(int32_t numSamples)
 				}
 			}
 		}
+
+		if (tapVoices)
+		{
+			for (; j < numSamples; j++) // voice is off
+				fTapData[(scopeTapWritePos + j) & SCOPE_TAP_MASK] = 0.0f;
+		}
 	}
 }
 
@@ -656,6 +681,7 @@ static inline void processMixedSamplesA500(int32_t i, int16_t *out)
 
 void outputAudio(int16_t *target, int32_t numSamples)
 {
+	bool tapMix;
 	int16_t *outStream, out[2];
 	int32_t j;
 
@@ -682,6 +708,8 @@ void outputAudio(int16_t *target, int32_t numSamples)
 	{
 		// render to stream
 
+		tapMix = !editor.isWAVRendering; // for the spectrum analyzer
+
 		outStream = target;
 		if (filterFlags & FILTER_A500)
 		{
@@ -690,6 +718,9 @@ void outputAudio(int16_t *target, int32_t numSamples)
 				processMixedSamplesA500(j, out);
 				*outStream++ = out[0];
 				*outStream++ = out[1];
+
+				if (tapMix)
+					fMixTap[(scopeTapWritePos + j) & SCOPE_TAP_MASK] = (out[0] + out[1]) * (1.0f / 65536.0f);
 			}
 		}
 		else
@@ -699,15 +730,49 @@ void outputAudio(int16_t *target, int32_t numSamples)
 				processMixedSamplesA1200(j, out);
 				*outStream++ = out[0];
 				*outStream++ = out[1];
+
+				if (tapMix)
+					fMixTap[(scopeTapWritePos + j) & SCOPE_TAP_MASK] = (out[0] + out[1]) * (1.0f / 65536.0f);
 			}
 		}
+
+		if (tapMix)
+			publishScopeTap(numSamples);
+	}
+}
+
+static void publishVoiceState(uint64_t time64)
+{
+	scopeSnapshot_t snapshot;
+	scopeVoice_t *s;
+	paulaVoice_t *v;
+
+	snapshot.time64 = time64;
+	snapshot.tapPos = scopeTapWritePos;
+	for (int32_t i = 0; i < AMIGA_VOICES; i++)
+	{
+		v = &paula[i];
+		s = &snapshot.voice[i];
+
+		s->active = v->active;
+		s->data = v->data;
+		s->newData = v->newData;
+		s->length = v->length;
+		s->newLength = v->newLength;
+		s->pos = v->pos;
+		s->dPhase = v->dPhase;
+		s->dDelta = v->dDelta;
 	}
+
+	publishScopeSnapshot(&snapshot);
 }
 
 static void SDLCALL audioCallback(void *userdata, Uint8 *stream, int len)
 {
 	int16_t *out;
 	int32_t sampleBlock, samplesTodo;
+	uint64_t time64;
+	double dTicksPerSample;
 
 	(void)userdata;
 
@@ -719,12 +784,20 @@ static void SDLCALL audioCallback(void *userdata, Uint8 *stream, int len)
 
 	out = (int16_t *)stream;
 
+	/* The mixed block is heard after the data already queued in the device has
+	** been played, which we estimate as one audio buffer. */
+	dTicksPerSample = editor.dPerfFreq / audio.dAudioFreq;
+	time64 = SDL_GetPerformanceCounter() + (uint64_t)(audio.audioBufferSize * dTicksPerSample);
+
 	sampleBlock = len >> 2;
 	while (sampleBlock)
 	{
 		samplesTodo = (sampleBlock < sampleCounter) ? sampleBlock : sampleCounter;
 		if (samplesTodo > 0)
 		{
+			publishVoiceState(time64); // the scopes interpolate from these
+			time64 += (uint64_t)(samplesTodo * dTicksPerSample);
+
 			outputAudio(out, samplesTodo);
 			out += (samplesTodo << 1);
 
@@ -733,7 +806,9 @@ static void SDLCALL audioCallback(void *userdata, Uint8 *stream, int len)
 		}
 		else
 		{
-			if (editor.songPlaying)
+			if (editor.playlistActive)
+				playlistTick(); // can switch to the next song at this point
+			else if (editor.songPlaying)
 				intMusic();
 
 			sampleCounter = samplesPerTick;
@@ -826,6 +901,40 @@ void mixerCalcVoicePans(uint8_t stereoSeparation)
 	mixerSetVoicePan(3, ch4Pan);
 }
 
+// mixer buffers and tables, shared by the audio device and headless rendering
+static bool setupMixer(int32_t freq)
+{
+	maxSamplesToMix = (int32_t)ceil((freq * 2.5) / 32.0);
+
+	dMixBufferL = (double *)calloc(maxSamplesToMix, sizeof (double));
+	dMixBufferR = (double *)calloc(maxSamplesToMix, sizeof (double));
+	editor.mod2WavBuffer = (int16_t *)malloc(sizeof (int16_t) * 2 * maxSamplesToMix); // stereo
+
+	if (dMixBufferL == NULL || dMixBufferR == NULL || editor.mod2WavBuffer == NULL)
+	{
+		showErrorMsgBox("Out of memory!");
+		return false;
+	}
+
+	ptConfig.soundFrequency = freq;
+	audio.audioFreq = ptConfig.soundFrequency;
+	audio.dAudioFreq = (double)ptConfig.soundFrequency;
+	audio.dPeriodToDeltaDiv = PAULA_PAL_CLK / audio.dAudioFreq;
+
+	mixerCalcVoicePans(ptConfig.stereoSeparation);
+	defStereoSep = ptConfig.stereoSeparation;
+
+	filterFlags = ptConfig.a500LowPassFilter ? FILTER_A500 : 0;
+
+	calculateFilterCoeffs();
+	generateBpmTables();
+
+	samplesPerTick = 0;
+	sampleCounter = 0;
+
+	return true;
+}
+
 bool setupAudio(void)
 {
 	SDL_AudioSpec want, have;
@@ -856,36 +965,22 @@ bool setupAudio(void)
 		return false;
 	}
 
-	maxSamplesToMix = (int32_t)ceil((have.freq * 2.5) / 32.0);
-
-	dMixBufferL = (double *)calloc(maxSamplesToMix, sizeof (double));
-	dMixBufferR = (double *)calloc(maxSamplesToMix, sizeof (double));
-	editor.mod2WavBuffer = (int16_t *)malloc(sizeof (int16_t) * maxSamplesToMix);
-
-	if (dMixBufferL == NULL || dMixBufferR == NULL || editor.mod2WavBuffer == NULL)
-	{
-		showErrorMsgBox("Out of memory!");
+	if (!setupMixer(have.freq))
 		return false;
-	}
 
 	audio.audioBufferSize = have.samples;
-	ptConfig.soundFrequency = have.freq;
-	audio.audioFreq = ptConfig.soundFrequency;
-	audio.dAudioFreq = (double)ptConfig.soundFrequency;
-	audio.dPeriodToDeltaDiv = PAULA_PAL_CLK / audio.dAudioFreq;
-
-	mixerCalcVoicePans(ptConfig.stereoSeparation);
-	defStereoSep = ptConfig.stereoSeparation;
-
-	filterFlags = ptConfig.a500LowPassFilter ? FILTER_A500 : 0;
 
-	calculateFilterCoeffs();
-	generateBpmTables();
+	SDL_PauseAudioDevice(dev, false);
+	return true;
+}
 
-	samplesPerTick = 0;
-	sampleCounter = 0;
+// for command line rendering, no audio device is opened
+bool setupAudioHeadless(int32_t freq)
+{
+	if (!setupMixer(freq))
+		return false;
 
-	SDL_PauseAudioDevice(dev, false);
+	audio.audioBufferSize = ptConfig.soundBufferSize;
 	return true;
 }
 
@@ -1100,6 +1195,52 @@ bool renderToWav(char *fileName, bool checkIfFileExist)
 	return true;
 }
 
+/* Renders the song from the start until it ends or loops (same as MOD2WAV), and
+** returns a 64-bit FNV-1a hash of the 16-bit stereo output. Used for the
+** --render-hash regression mode, so it never touches the GUI.
+*/
+uint64_t renderToHash(uint32_t *outSamples)
+{
+	uint8_t smpBytes[2];
+	uint32_t size, totalSamples, maxSamples;
+	uint64_t hash;
+
+	storeTempVariables();
+	editor.isWAVRendering = true;
+	restartSong();
+	turnOffVoices(); // also resets the dither seed, for a reproducible output
+
+	maxSamples = audio.audioFreq * RENDER_HASH_MAX_SECONDS;
+
+	hash = 14695981039346656037ULL; // FNV-1a offset basis
+	totalSamples = 0;
+
+	wavRenderingDone = false;
+	while (!wavRenderingDone && totalSamples < maxSamples)
+	{
+		size = getAudioFrame(editor.mod2WavBuffer);
+		for (uint32_t i = 0; i < size; i++)
+		{
+			// little-endian bytes, so that the hash is the same on all platforms
+			smpBytes[0] = (uint8_t)((uint16_t)editor.mod2WavBuffer[i] & 0xFF);
+			smpBytes[1] = (uint8_t)((uint16_t)editor.mod2WavBuffer[i] >> 8);
+
+			hash = (hash ^ smpBytes[0]) * 1099511628211ULL;
+			hash = (hash ^ smpBytes[1]) * 1099511628211ULL;
+		}
+
+		totalSamples += size >> 1;
+	}
+
+	resetSong();
+	editor.isWAVRendering = false;
+
+	if (outSamples != NULL)
+		*outSamples = totalSamples;
+
+	return hash;
+}
+
 // for MOD2WAV - ONLY used for a visual percentage counter, so accuracy is not important
 void calcMod2WavTotalRows(void)
 {
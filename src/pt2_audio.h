@@ -5,6 +5,9 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "pt2_trace.h"
+
+#define RENDER_HASH_MAX_SECONDS (60 * 60) /* safety limit for songs that never end */
 
 typedef struct lossyIntegrator_t
 {
@@ -23,6 +26,7 @@ void normalize8bitDoubleSigned(double *dSampleData, uint32_t sampleLength);
 void setLEDFilter(bool state);
 void toggleLEDFilter(void);
 bool renderToWav(char *fileName, bool checkIfFileExist);
+uint64_t renderToHash(uint32_t *outSamples);
 void toggleAmigaPanMode(void);
 void toggleA500Filters(void);
 void paulaStopDMA(uint8_t ch);
@@ -31,6 +35,8 @@ void paulaSetPeriod(uint8_t ch, uint16_t period);
 void paulaSetVolume(uint8_t ch, uint16_t vol);
 void paulaSetLength(uint8_t ch, uint32_t len);
 void paulaSetData(uint8_t ch, const int8_t *src);
+void paulaGetTraceState(traceVoice_t *voices);
+int32_t paulaSkipSamples(int32_t numSamples);
 void lockAudio(void);
 void unlockAudio(void);
 void clearPaulaAndScopes(void);
@@ -0,0 +1,171 @@
+/* Command line modes.
+**
+** --render-hash <file> [file ...]
+**   Renders each module from start to end through the replayer and mixer, and
+**   prints "<hash> <file>" to stdout, where the hash is a 64-bit FNV-1a of the
+**   16-bit stereo output. Diff the output against a list made with a known good
+**   build to catch replayer/mixer regressions. Load and render times go to stderr.
+**   The mixer settings are fixed (48kHz, A1200 filter, 20% stereo separation),
+**   protracker.ini is not read.
+**
+** --trace [--json] <file>
+**   Renders the module like --render-hash, with the replayer trace enabled
+**   (see pt2_trace.c), and writes the trace to stdout as text or JSON lines.
+**   Only the last TRACE_RECORDS ticks are kept.
+**
+** --analyze <file> [file ...]
+**   Writes one JSON line per module to stdout (see pt2_analyzer.c), using one
+**   worker process per CPU core.
+**
+** The modes only take module files, playlists (.m3u/.m3u8) are rejected.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+#include "pt2_header.h"
+#include "pt2_audio.h"
+#include "pt2_modloader.h"
+#include "pt2_textout.h"
+#include "pt2_trace.h"
+#include "pt2_analyzer.h"
+#include "pt2_cli.h"
+
+bool setupCliRenderer(void)
+{
+	ptConfig.soundFrequency = CLI_RENDER_FREQ;
+	ptConfig.soundBufferSize = 1024;
+	ptConfig.stereoSeparation = 20;
+	ptConfig.a500LowPassFilter = false;
+
+	if (!setupAudioHeadless(CLI_RENDER_FREQ))
+		return false;
+
+	initPeriodToNoteTable();
+
+	modEntry = createNewMod();
+	return modEntry != NULL;
+}
+
+static bool isPlaylistFileName(const char *fileName)
+{
+	const size_t len = strlen(fileName);
+	return (len >= 4 && !_strnicmp(&fileName[len-4], ".M3U", 4)) || (len >= 5 && !_strnicmp(&fileName[len-5], ".M3U8", 5));
+}
+
+// on failure, the error is in editor.ui.statusMessage
+bool loadCliModule(char *fileName)
+{
+	modEntry->moduleLoaded = false;
+
+	// loadModFromArg() would start playing a playlist in the background, we need the module here
+	if (isPlaylistFileName(fileName))
+	{
+		displayErrorMsg("NOT A MODULE !");
+		return false;
+	}
+
+	loadModFromArg(fileName);
+
+	return modEntry->moduleLoaded;
+}
+
+static int32_t renderHashes(int32_t numFiles, char *files[])
+{
+	int32_t result;
+	uint32_t numSamples;
+	uint64_t hash, time64;
+	double dPerfFreq, dRenderMs, dSongMs, dLoadMs;
+
+	if (numFiles < 1)
+	{
+		fprintf(stderr, "usage: pt2-clone --render-hash <file> [file ...]\n");
+		return 1;
+	}
+
+	if (!setupCliRenderer())
+		return 1;
+
+	dPerfFreq = (double)SDL_GetPerformanceFrequency();
+
+	result = 0;
+	for (int32_t i = 0; i < numFiles; i++)
+	{
+		if (!loadCliModule(files[i]))
+		{
+			fprintf(stderr, "%s: %s\n", files[i], editor.ui.statusMessage);
+			result = 1;
+			continue;
+		}
+
+		dLoadMs = modLoadTime.dReadMs + modLoadTime.dParseMs;
+
+		time64 = SDL_GetPerformanceCounter();
+		hash = renderToHash(&numSamples);
+		dRenderMs = ((SDL_GetPerformanceCounter() - time64) * 1000.0) / dPerfFreq;
+
+		printf("%016llx  %s\n", (unsigned long long)hash, files[i]);
+		fflush(stdout);
+
+		dSongMs = (numSamples * 1000.0) / CLI_RENDER_FREQ;
+		fprintf(stderr, "%s: loaded in %.3fms (%s%s), %.2fs of audio rendered in %.2fms (%.0fx realtime)\n", files[i],
+			dLoadMs, modLoadTime.mapped ? "mapped" : "read", modLoadTime.packed ? ", powerpacked" : "",
+			dSongMs / 1000.0, dRenderMs, (dRenderMs > 0.0) ? (dSongMs / dRenderMs) : 0.0);
+	}
+
+	return result;
+}
+
+static int32_t traceModule(int32_t argc, char *argv[])
+{
+	bool json;
+
+	json = (argc >= 1 && !strcmp(argv[0], "--json"));
+	if (json)
+	{
+		argc--;
+		argv++;
+	}
+
+	if (argc != 1)
+	{
+		fprintf(stderr, "usage: pt2-clone --trace [--json] <file>\n");
+		return 1;
+	}
+
+	if (!setupCliRenderer())
+		return 1;
+
+	if (!loadCliModule(argv[0]))
+	{
+		fprintf(stderr, "%s: %s\n", argv[0], editor.ui.statusMessage);
+		return 1;
+	}
+
+	startReplayerTrace();
+	renderToHash(NULL);
+	trace.enabled = false;
+
+	return writeReplayerTrace(stdout, json) ? 0 : 1;
+}
+
+bool isCliCommand(const char *arg)
+{
+	return !strcmp(arg, "--render-hash") || !strcmp(arg, "--trace") || !strcmp(arg, "--analyze");
+}
+
+int32_t runCliCommand(int32_t argc, char *argv[])
+{
+	if (!strcmp(argv[1], "--render-hash"))
+		return renderHashes(argc - 2, &argv[2]);
+
+	if (!strcmp(argv[1], "--trace"))
+		return traceModule(argc - 2, &argv[2]);
+
+	if (!strcmp(argv[1], "--analyze"))
+		return analyzeModules(argc - 2, &argv[2]);
+
+	return 1;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// command line modes, these run without opening a window or an audio device
+
+#define CLI_RENDER_FREQ 48000 /* fixed, so that output hashes are comparable between machines */
+
+bool isCliCommand(const char *arg);
+int32_t runCliCommand(int32_t argc, char *argv[]); // returns the program exit code
+bool setupCliRenderer(void);
+bool loadCliModule(char *fileName);
@@ -57,6 +57,7 @@ void loadConfig(void)
 	ptConfig.compoMode = false;
 	ptConfig.soundBufferSize = 1024;
 	ptConfig.autoCloseDiskOp = true;
+	ptConfig.diskOpModTitles = true;
 	ptConfig.vsyncOff = false;
 	ptConfig.hwMouse = false;
 
@@ -211,6 +212,13 @@ static bool loadProTrackerDotIni(FILE *f)
 			else if (!_strnicmp(&configLine[16], "FALSE", 5)) ptConfig.hideDiskOpDates = false;
 		}
 
+		// DISKOPMODTITLES
+		else if (!_strnicmp(configLine, "DISKOPMODTITLES=", 16))
+		{
+			     if (!_strnicmp(&configLine[16], "TRUE",  4)) ptConfig.diskOpModTitles = true;
+			else if (!_strnicmp(&configLine[16], "FALSE", 5)) ptConfig.diskOpModTitles = false;
+		}
+
 		// AUTOCLOSEDISKOP
 		else if (!_strnicmp(configLine, "AUTOCLOSEDISKOP=", 16))
 		{
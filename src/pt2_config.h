@@ -6,7 +6,7 @@
 struct ptConfig_t
 {
 	char *defModulesDir, *defSamplesDir;
-	bool dottedCenterFlag, pattDots, a500LowPassFilter, compoMode, autoCloseDiskOp, hideDiskOpDates, hwMouse;
+	bool dottedCenterFlag, pattDots, a500LowPassFilter, compoMode, autoCloseDiskOp, hideDiskOpDates, diskOpModTitles, hwMouse;
 	bool transDel, fullScreenStretch, vsyncOff, modDot, blankZeroFlag, realVuMeters, rememberPlayMode;
 	int8_t stereoSeparation, videoScaleFactor, accidental;
 	uint16_t quantizeValue;
@@ -8,7 +8,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <math.h>
-#include <ctype.h> // tolower()
+#include <ctype.h> // tolower(), toupper()
 #ifdef _WIN32
 #include <direct.h>
 #include <io.h>
@@ -19,6 +19,9 @@
 #include <unistd.h>
 #include <dirent.h>
 #endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -37,16 +40,52 @@
 #include "pt2_keyboard.h"
 #include "pt2_visuals.h"
 #include "pt2_sampleloader.h"
+#include "pt2_modpreview.h"
+#include "pt2_playlist.h"
 
 typedef struct fileEntry_t
 {
 	UNICHAR *nameU;
-	char firstAnsiChar; // for handleEntryJumping();
+	char firstAnsiChar; // for jumpToEntry();
 	char dateChanged[6 + 1];
-	bool isDir;
+	bool isDir, statDone; // size/date of files are read when they're shown (statEntry())
 	int32_t filesize;
+	int64_t mtime;
+	volatile bool previewDone; // set by the preview scan (module mode)
+	modPreview_t preview;
 } fileEntry_t;
 
+#define DISKOP_PUBLISH_MS 20 /* how often the fill thread shows what it has read so far */
+#define DISKOP_LISTING_CACHE 4 /* number of recent directory listings kept besides the shown one */
+#define DISKOP_SEARCH_LEN 32 /* max length of the SHIFT+character search string */
+#define DISKOP_INDEX_MIN_ENTRIES 1024 /* smaller listings are searched without a trigram index */
+#define TRIGRAM_BUCKETS 65536
+
+// names are packed into blocks that are never moved, so nameU pointers stay valid
+#define NAME_POOL_BLOCK_LEN 32768 /* in UNICHARs, must be bigger than the longest name */
+
+typedef struct namePoolBlock_t
+{
+	struct namePoolBlock_t *next;
+	uint32_t used; // in UNICHARs, the names follow this header
+} namePoolBlock_t;
+
+// a complete directory listing, see cacheCurrentListing()
+typedef struct dirListing_t
+{
+	UNICHAR *pathU;
+	int8_t mode; // module mode only lists modules, so it's part of the key
+	bool stale;
+	int32_t numEntries, entriesSize;
+	int64_t dirMtime; // used when there is no inotify watch
+	int watch, dirFd;
+	fileEntry_t *entries;
+	uint32_t *order;
+	namePoolBlock_t *namePool;
+	char *searchKeys;
+	uint32_t *searchKeyOffsets, *trigramStart, *trigramPos;
+} dirListing_t;
+
 // "look for file" flags
 enum
 {
@@ -61,32 +100,345 @@ static HANDLE hFind;
 #else
 #define PARENT_DIR_STR ".."
 static DIR *hFind;
+static int listDirFd = -1; // the listed directory, for statEntry()
 #endif
 
 static char fileNameBuffer[PATH_MAX + 1];
+static bool oldPlayAll;
 static uint32_t oldFileEntryRow;
-static UNICHAR pathTmp[PATH_MAX + 2];
-static fileEntry_t *diskOpEntry;
+static UNICHAR pathTmp[PATH_MAX + 2], scanPathU[PATH_MAX + 2], scanFileU[PATH_MAX + 2];
+static int32_t diskOpEntrySize, numReadEntries; // editor.diskop.numEntries = entries shown (sorted)
+static fileEntry_t *diskOpEntry; // in reading order
+static uint32_t *diskOpOrder; // sorted index -> diskOpEntry[]
+static namePoolBlock_t *namePool; // newest block first
+static SDL_mutex *listMutex; // held while the list is drawn, and while the fill thread moves it
+
+// the shown listing's key, and what's needed to tell if the directory changed since it was read
+static UNICHAR *listPathU;
+static int8_t listMode;
+static int64_t listDirMtime;
+static int listWatch = -1;
+
+static int32_t numCachedListings;
+static dirListing_t listingCache[DISKOP_LISTING_CACHE]; // most recently used first
+#ifdef __linux__
+static int inotifyFd = -1;
+#endif
+
+// sort keys, only used by the fill thread
+static char *sortKeys;
+static uint32_t sortKeysLen, sortKeysSize, *sortKeyOffsets;
+
+/* Search keys of the shown listing, built after the fill (see buildSearchIndex()). They are
+** the lower-cased names in sorted order, so that searching reads them sequentially.
+** trigramPos[trigramStart[h] .. trigramStart[h+1]-1] are the sorted positions of the
+** names that contain a trigram with hash h, in ascending order (big listings only).
+*/
+static char *searchKeys;
+static uint32_t *searchKeyOffsets, *trigramStart, *trigramPos;
+
+// SHIFT+character search, only used by the UI thread (and the preview scan reads searchView with the list locked)
+static char searchStr[DISKOP_SEARCH_LEN + 1], matchStr[DISKOP_SEARCH_LEN + 1];
+static int32_t searchLen, numMatches;
+static uint32_t *searchView; // shown index -> sorted position, ranked. NULL if there is no search
+static uint32_t *matches; // the sorted positions that contain matchStr, in ascending order
+static uint32_t matchPreviews; // numPreviewsDone when matches was made
+static volatile uint32_t numPreviewsDone; // counts the titles found by the preview scan
+
+static void lockList(void)
+{
+	if (listMutex != NULL)
+		SDL_LockMutex(listMutex);
+}
+
+static void unlockList(void)
+{
+	if (listMutex != NULL)
+		SDL_UnlockMutex(listMutex);
+}
+
+static fileEntry_t *getEntry(int32_t i) // i = shown index
+{
+	if (searchView != NULL)
+		i = searchView[i];
+
+	return &diskOpEntry[diskOpOrder[i]];
+}
+
+static fileEntry_t *getListEntry(int32_t i) // i = reading index, ignores the search
+{
+	return &diskOpEntry[i];
+}
 
-static fileEntry_t *bufferCreateEmptyDir(void) // special case: creates a dir entry with a ".." directory
+static bool modTitlesShown(void)
 {
-	fileEntry_t *dirEntry;
+	return editor.diskop.mode == DISKOP_MODE_MOD && ptConfig.diskOpModTitles;
+}
 
-	dirEntry = (fileEntry_t *)malloc(sizeof (fileEntry_t));
-	if (dirEntry == NULL)
+// the module title that the list shows instead of the name, or NULL
+static const char *getShownTitle(const fileEntry_t *entry)
+{
+	if (modTitlesShown() && entry->previewDone && entry->preview.title[0] != '\0')
+		return entry->preview.title;
+
+	return NULL;
+}
+
+static UNICHAR *poolStrdup(const UNICHAR *name)
+{
+	UNICHAR *dst;
+	namePoolBlock_t *block;
+
+	const uint32_t len = (uint32_t)UNICHAR_STRLEN(name) + 1;
+	if (len > NAME_POOL_BLOCK_LEN)
 		return NULL;
 
-	dirEntry->nameU = UNICHAR_STRDUP(PARENT_DIR_STR);
-	if (dirEntry->nameU == NULL)
+	if (namePool == NULL || namePool->used+len > NAME_POOL_BLOCK_LEN)
 	{
-		free(dirEntry);
-		return NULL;
+		block = (namePoolBlock_t *)malloc(sizeof (namePoolBlock_t) + (NAME_POOL_BLOCK_LEN * sizeof (UNICHAR)));
+		if (block == NULL)
+			return NULL;
+
+		block->next = namePool;
+		block->used = 0;
+		namePool = block;
+	}
+
+	dst = (UNICHAR *)(namePool + 1) + namePool->used;
+	memcpy(dst, name, len * sizeof (UNICHAR));
+	namePool->used += len;
+
+	return dst;
+}
+
+/* A sort key is a priority byte for directories (".." first), then the lower-cased
+** ANSI name. Comparing keys with strcmp() gives the same order as _stricmp() on the
+** names. Keys are stored back-to-back in one buffer.
+*/
+static bool addSortKey(int32_t entryIndex)
+{
+	char *key, *newPtr;
+	uint32_t newSize;
+	fileEntry_t *entry = &diskOpEntry[entryIndex];
+
+	const uint32_t maxKeyLen = (uint32_t)UNICHAR_STRLEN(entry->nameU) + 2; // ANSI name is never longer
+	if (sortKeysLen+maxKeyLen > sortKeysSize)
+	{
+		newSize = (sortKeysSize == 0) ? 65536 : (sortKeysSize * 2);
+		while (sortKeysLen+maxKeyLen > newSize)
+			newSize *= 2;
+
+		newPtr = (char *)realloc(sortKeys, newSize);
+		if (newPtr == NULL)
+			return false;
+
+		sortKeys = newPtr;
+		sortKeysSize = newSize;
+	}
+
+	sortKeyOffsets[entryIndex] = sortKeysLen;
+
+	key = &sortKeys[sortKeysLen];
+	unicharToAnsi(key, entry->nameU, PATH_MAX);
+
+	if (entry->isDir)
+	{
+		memmove(&key[1], key, strlen(key) + 1);
+
+		if (key[1] == '.' && key[2] == '.' && key[3] == '\0')
+			key[0] = 0x01; // make ".." directory first priority
+		else
+			key[0] = 0x02; // make second priority
+
+		key++;
+	}
+
+	for (; *key != '\0'; key++)
+		*key = (char)tolower((uint8_t)*key);
+
+	sortKeysLen = (uint32_t)(key - sortKeys) + 1;
+	return true;
+}
+
+static void freeSortKeys(void)
+{
+	if (sortKeys != NULL) free(sortKeys);
+	if (sortKeyOffsets != NULL) free(sortKeyOffsets);
+
+	sortKeys = NULL;
+	sortKeyOffsets = NULL;
+	sortKeysLen = sortKeysSize = 0;
+}
+
+static const char *getSearchKey(uint32_t pos) // pos = sorted position
+{
+	return &searchKeys[searchKeyOffsets[pos]];
+}
+
+// the lower-cased text that the list shows for a sorted position, the module title or the name
+static const char *getShownKey(uint32_t pos, char *titleBuffer)
+{
+	int32_t i;
+	const char *title = getShownTitle(&diskOpEntry[diskOpOrder[pos]]);
+
+	if (title == NULL)
+		return getSearchKey(pos);
+
+	for (i = 0; title[i] != '\0'; i++)
+		titleBuffer[i] = (char)tolower((uint8_t)title[i]);
+	titleBuffer[i] = '\0';
+
+	return titleBuffer;
+}
+
+static uint32_t hashTrigram(const char *str)
+{
+	const uint32_t trigram = (uint8_t)str[0] | ((uint8_t)str[1] << 8) | ((uint8_t)str[2] << 16);
+	return (uint32_t)(trigram * 2654435761U) >> 16; // 0..TRIGRAM_BUCKETS-1
+}
+
+// copies the sort keys in sorted order (without the directory byte), and builds the trigram index for big listings
+static bool buildSearchIndex(void)
+{
+	char *dst;
+	uint32_t h, pos, *lastPos, *start, *posList;
+	const char *key;
+
+	const uint32_t numPos = (uint32_t)numReadEntries;
+
+	searchKeys = (char *)malloc(sortKeysLen + 1);
+	searchKeyOffsets = (uint32_t *)malloc((numPos + 1) * sizeof (uint32_t));
+	if (searchKeys == NULL || searchKeyOffsets == NULL)
+		return false;
+
+	dst = searchKeys;
+	for (pos = 0; pos < numPos; pos++)
+	{
+		key = &sortKeys[sortKeyOffsets[diskOpOrder[pos]]];
+		if (*key == 0x01 || *key == 0x02)
+			key++; // directory priority byte
+
+		searchKeyOffsets[pos] = (uint32_t)(dst - searchKeys);
+		while (*key != '\0')
+			*dst++ = *key++;
+		*dst++ = '\0';
+	}
+
+	if (numPos < DISKOP_INDEX_MIN_ENTRIES)
+		return true;
+
+	// the trigram index is optional, searching still works without it
+	start = (uint32_t *)calloc(TRIGRAM_BUCKETS + 1, sizeof (uint32_t));
+	lastPos = (uint32_t *)malloc(TRIGRAM_BUCKETS * sizeof (uint32_t));
+	if (start == NULL || lastPos == NULL)
+		goto noIndex;
+
+	// count, a name that has the same trigram more than once is only listed once
+	memset(lastPos, 0xFF, TRIGRAM_BUCKETS * sizeof (uint32_t));
+	for (pos = 0; pos < numPos; pos++)
+	{
+		for (key = getSearchKey(pos); key[0] != '\0' && key[1] != '\0' && key[2] != '\0'; key++)
+		{
+			h = hashTrigram(key);
+			if (lastPos[h] != pos)
+			{
+				lastPos[h] = pos;
+				start[h+1]++;
+			}
+		}
 	}
 
-	dirEntry->isDir = true;
-	dirEntry->filesize = 0;
+	for (h = 0; h < TRIGRAM_BUCKETS; h++)
+		start[h+1] += start[h];
 
-	return dirEntry;
+	posList = (uint32_t *)malloc((start[TRIGRAM_BUCKETS] + 1) * sizeof (uint32_t));
+	if (posList == NULL)
+		goto noIndex;
+
+	// fill, start[h] is used as the write position and moved back to the bucket start afterwards
+	memset(lastPos, 0xFF, TRIGRAM_BUCKETS * sizeof (uint32_t));
+	for (pos = 0; pos < numPos; pos++)
+	{
+		for (key = getSearchKey(pos); key[0] != '\0' && key[1] != '\0' && key[2] != '\0'; key++)
+		{
+			h = hashTrigram(key);
+			if (lastPos[h] != pos)
+			{
+				lastPos[h] = pos;
+				posList[start[h]++] = pos;
+			}
+		}
+	}
+
+	memmove(&start[1], &start[0], TRIGRAM_BUCKETS * sizeof (uint32_t));
+	start[0] = 0;
+
+	free(lastPos);
+
+	trigramStart = start;
+	trigramPos = posList;
+	return true;
+
+noIndex:
+	if (start != NULL) free(start);
+	if (lastPos != NULL) free(lastPos);
+	return true;
+}
+
+// copies the entry to the end of the list (not shown until publishEntries()), the list grows geometrically
+static bool addEntry(fileEntry_t *entry)
+{
+	int32_t newSize;
+	uint32_t *newOffsets;
+	fileEntry_t *newPtr;
+
+	if (numReadEntries >= diskOpEntrySize)
+	{
+		newSize = (diskOpEntrySize == 0) ? 256 : (diskOpEntrySize * 2);
+
+		newOffsets = (uint32_t *)realloc(sortKeyOffsets, sizeof (uint32_t) * newSize);
+		if (newOffsets == NULL)
+			return false;
+
+		sortKeyOffsets = newOffsets;
+
+		lockList(); // the UI may be drawing the shown entries
+		newPtr = (fileEntry_t *)realloc(diskOpEntry, sizeof (fileEntry_t) * newSize);
+		if (newPtr != NULL)
+		{
+			diskOpEntry = newPtr;
+			diskOpEntrySize = newSize;
+		}
+		unlockList();
+
+		if (newPtr == NULL)
+			return false;
+	}
+
+	diskOpEntry[numReadEntries] = *entry;
+	if (!addSortKey(numReadEntries))
+		return false;
+
+	numReadEntries++;
+	return true;
+}
+
+static bool bufferCreateEmptyDir(void) // special case: creates a dir entry with a ".." directory
+{
+	fileEntry_t dirEntry;
+
+	memset(&dirEntry, 0, sizeof (dirEntry));
+
+	dirEntry.nameU = poolStrdup(PARENT_DIR_STR);
+	if (dirEntry.nameU == NULL)
+		return false;
+
+	dirEntry.isDir = true;
+	dirEntry.statDone = true;
+	dirEntry.filesize = 0;
+	dirEntry.previewDone = false;
+
+	return addEntry(&dirEntry);
 }
 
 // deciding whether to load this entry into the buffer or not
@@ -122,9 +474,75 @@ static bool listEntry(fileEntry_t *f)
 		}
 	}
 
+	if (isPlaylistFile(f->nameU))
+		return true;
+
 	return false;
 }
 
+#ifndef _WIN32
+static void setEntryStat(fileEntry_t *entry, const struct stat *st)
+{
+	const int64_t fSize = (int64_t)st->st_size;
+	entry->filesize = (fSize > INT32_MAX) ? -1 : (fSize & 0xFFFFFFFF);
+
+	if ((st->st_mode & S_IFMT) == S_IFDIR)
+		entry->isDir = true;
+
+	strftime(entry->dateChanged, 7, "%d%m%y", localtime(&st->st_mtime));
+	entry->mtime = (int64_t)st->st_mtime;
+}
+#endif
+
+#ifndef _WIN32
+// st = NULL if fstatat() failed. Only call this with the list locked!
+static void storeEntryStat(fileEntry_t *entry, const struct stat *st)
+{
+	if (st != NULL)
+	{
+		const bool isDir = entry->isDir;
+
+		setEntryStat(entry, st);
+		entry->isDir = isDir; // don't change the sort order
+	}
+
+	entry->statDone = true;
+}
+#endif
+
+// reads the size/date of an entry if that wasn't done while listing. Only call this with the list locked!
+static void statEntry(fileEntry_t *entry)
+{
+#ifndef _WIN32
+	struct stat st;
+
+	if (!entry->statDone)
+		storeEntryStat(entry, (listDirFd >= 0 && fstatat(listDirFd, entry->nameU, &st, 0) == 0) ? &st : NULL);
+#else
+	(void)entry;
+#endif
+}
+
+// same as statEntry(), for the preview scan. The UI isn't blocked while a slow (network) drive is read
+static void statEntryUnlocked(fileEntry_t *entry)
+{
+#ifndef _WIN32
+	struct stat st;
+	bool statOK;
+
+	if (entry->statDone)
+		return;
+
+	statOK = listDirFd >= 0 && fstatat(listDirFd, entry->nameU, &st, 0) == 0;
+
+	lockList(); // the UI may have stat'ed it meanwhile, that's fine
+	storeEntryStat(entry, statOK ? &st : NULL);
+	unlockList();
+#else
+	(void)entry;
+#endif
+}
+
 static int8_t findFirst(fileEntry_t *searchRec)
 {
 #ifdef _WIN32
@@ -133,73 +551,67 @@ static int8_t findFirst(fileEntry_t *searchRec)
 #else
 	struct dirent *fData;
 	struct stat st;
-	int64_t fSize;
 #endif
 
 	searchRec->nameU = NULL; // this one must be initialized
+	searchRec->previewDone = false;
 
 #ifdef _WIN32
 	hFind = FindFirstFileW(L"*", &fData);
 	if (hFind == NULL || hFind == INVALID_HANDLE_VALUE)
 		return LFF_DONE;
 
-	searchRec->nameU = UNICHAR_STRDUP(fData.cFileName);
-	if (searchRec->nameU == NULL)
-		return LFF_SKIP;
+	searchRec->nameU = fData.cFileName; // copied to the name pool if the entry is listed
 
 	searchRec->filesize = (fData.nFileSizeHigh > 0) ? -1 : fData.nFileSizeLow;
 	searchRec->isDir = (fData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? true : false;
+	searchRec->statDone = true; // size/date come with the directory listing
 #else
 	hFind = opendir(".");
 	if (hFind == NULL)
 		return LFF_DONE;
 
+	listDirFd = dup(dirfd(hFind)); // stays open after findClose()
+
 	fData = readdir(hFind);
 	if (fData == NULL)
 		return LFF_DONE;
 
-	searchRec->nameU = UNICHAR_STRDUP(fData->d_name);
-	if (searchRec->nameU == NULL)
-		return LFF_SKIP;
+	searchRec->nameU = fData->d_name; // copied to the name pool if the entry is listed
 
 	searchRec->filesize = 0;
+	searchRec->mtime = 0;
+	searchRec->dateChanged[0] = '\0';
 	searchRec->isDir = (fData->d_type == DT_DIR) ? true : false;
+	searchRec->statDone = searchRec->isDir; // directories don't show a size/date
 
+	// these have to be stat'ed now to know if they are directories, other files are stat'ed when shown
 	if (fData->d_type == DT_UNKNOWN || fData->d_type == DT_LNK)
 	{
-		if (stat(fData->d_name, &st) == 0)
-		{
-			fSize = (int64_t)st.st_size;
-			searchRec->filesize = (fSize > INT32_MAX) ? -1 : (fSize & 0xFFFFFFFF);
+		if (fstatat(dirfd(hFind), fData->d_name, &st, 0) == 0)
+			setEntryStat(searchRec, &st);
 
-			if ((st.st_mode & S_IFMT) == S_IFDIR)
-				searchRec->isDir = true;
-		}
-	}
-	else if (!searchRec->isDir)
-	{
-		if (stat(fData->d_name, &st) == 0)
-		{
-			fSize = (int64_t)st.st_size;
-			searchRec->filesize = (fSize > INT32_MAX) ? -1 : (fSize & 0xFFFFFFFF);
-		}
+		searchRec->statDone = true;
 	}
 #endif
 
 	if (!listEntry(searchRec))
 	{
 		// skip entry
-		free(searchRec->nameU);
 		searchRec->nameU = NULL;
 		return LFF_SKIP;
 	}
 
+	searchRec->nameU = poolStrdup(searchRec->nameU);
+	if (searchRec->nameU == NULL)
+		return LFF_SKIP;
+
 #ifdef _WIN32
 	FileTimeToSystemTime(&fData.ftLastWriteTime, &sysTime);
 	snprintf(searchRec->dateChanged, 7, "%02d%02d%02d", sysTime.wDay, sysTime.wMonth, sysTime.wYear % 100);
+	searchRec->mtime = ((int64_t)fData.ftLastWriteTime.dwHighDateTime << 32) | fData.ftLastWriteTime.dwLowDateTime;
 	unicharToAnsi(&searchRec->firstAnsiChar, searchRec->nameU, 1);
 #else
-	strftime(searchRec->dateChanged, 7, "%d%m%y", localtime(&st.st_mtime));
 	searchRec->firstAnsiChar = (char)searchRec->nameU[0];
 #endif
 
@@ -214,69 +626,61 @@ static int8_t findNext(fileEntry_t *searchRec)
 #else
 	struct dirent *fData;
 	struct stat st;
-	int64_t fSize;
 #endif
 
 	searchRec->nameU = NULL; // important
+	searchRec->previewDone = false;
 
 #ifdef _WIN32
 	if (hFind == NULL || FindNextFileW(hFind, &fData) == 0)
 		return LFF_DONE;
 
-	searchRec->nameU = UNICHAR_STRDUP(fData.cFileName);
-	if (searchRec->nameU == NULL)
-		return LFF_SKIP;
+	searchRec->nameU = fData.cFileName; // copied to the name pool if the entry is listed
 
 	searchRec->filesize = (fData.nFileSizeHigh > 0) ? -1 : fData.nFileSizeLow;
 	searchRec->isDir = (fData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? true : false;
+	searchRec->statDone = true; // size/date come with the directory listing
 
 	FileTimeToSystemTime(&fData.ftLastWriteTime, &sysTime);
 #else
 	if (hFind == NULL || (fData = readdir(hFind)) == NULL)
 		return LFF_DONE;
 
-	searchRec->nameU = UNICHAR_STRDUP(fData->d_name);
-	if (searchRec->nameU == NULL)
-		return LFF_SKIP;
+	searchRec->nameU = fData->d_name; // copied to the name pool if the entry is listed
 
 	searchRec->filesize = 0;
+	searchRec->mtime = 0;
+	searchRec->dateChanged[0] = '\0';
 	searchRec->isDir = (fData->d_type == DT_DIR) ? true : false;
+	searchRec->statDone = searchRec->isDir; // directories don't show a size/date
 
+	// these have to be stat'ed now to know if they are directories, other files are stat'ed when shown
 	if (fData->d_type == DT_UNKNOWN || fData->d_type == DT_LNK)
 	{
-		if (stat(fData->d_name, &st) == 0)
-		{
-			fSize = (int64_t)st.st_size;
-			searchRec->filesize = (fSize > INT32_MAX) ? -1 : (fSize & 0xFFFFFFFF);
+		if (fstatat(dirfd(hFind), fData->d_name, &st, 0) == 0)
+			setEntryStat(searchRec, &st);
 
-			if ((st.st_mode & S_IFMT) == S_IFDIR)
-				searchRec->isDir = true;
-		}
-	}
-	else if (!searchRec->isDir)
-	{
-		if (stat(fData->d_name, &st) == 0)
-		{
-			fSize = (int64_t)st.st_size;
-			searchRec->filesize = (fSize > INT32_MAX) ? -1 : (fSize & 0xFFFFFFFF);
-		}
+		searchRec->statDone = true;
 	}
 #endif
 
 	if (!listEntry(searchRec))
 	{
 		// skip entry
-		free(searchRec->nameU);
 		searchRec->nameU = NULL;
 		return LFF_SKIP;
 	}
 
+	searchRec->nameU = poolStrdup(searchRec->nameU);
+	if (searchRec->nameU == NULL)
+		return LFF_SKIP;
+
 #ifdef _WIN32
 	FileTimeToSystemTime(&fData.ftLastWriteTime, &sysTime);
 	snprintf(searchRec->dateChanged, 7, "%02d%02d%02d", sysTime.wDay, sysTime.wMonth, sysTime.wYear % 100);
+	searchRec->mtime = ((int64_t)fData.ftLastWriteTime.dwHighDateTime << 32) | fData.ftLastWriteTime.dwLowDateTime;
 	unicharToAnsi(&searchRec->firstAnsiChar, searchRec->nameU, 1);
 #else
-	strftime(searchRec->dateChanged, 7, "%d%m%y", localtime(&st.st_mtime));
 	searchRec->firstAnsiChar = (char)searchRec->nameU[0];
 #endif
 
@@ -298,42 +702,300 @@ static void findClose(void)
 
 void diskOpShowSelectText(void)
 {
+	char findText[sizeof (editor.ui.statusMessage)];
+	int32_t shownLen;
+
 	if (!editor.ui.diskOpScreenShown || editor.ui.pointerMode == POINTER_MODE_MSG1 || editor.errorMsgActive)
 		return;
 
-	if (editor.diskop.mode == DISKOP_MODE_MOD)
+	if (searchLen > 0)
+	{
+		// show the end of the search string if it doesn't fit
+		shownLen = (int32_t)sizeof (findText) - (1 + 5);
+		sprintf(findText, "FIND:%s", &searchStr[(searchLen > shownLen) ? (searchLen - shownLen) : 0]);
+
+		for (char *ptr = findText; *ptr != '\0'; ptr++)
+			*ptr = (char)toupper((uint8_t)*ptr);
+
+		setStatusMessage(findText, NO_CARRY);
+	}
+	else if (editor.diskop.mode == DISKOP_MODE_MOD)
+	{
 		setStatusMessage("SELECT MODULE", NO_CARRY);
+	}
 	else
+	{
 		setStatusMessage("SELECT SAMPLE", NO_CARRY);
+	}
 }
 
-void handleEntryJumping(char jumpToChar) // SHIFT+character
+static void showNotFound(void)
+{
+	// character not found in file list, show red mouse pointer (error)!
+	editor.errorMsgActive = true;
+	editor.errorMsgBlock = true;
+	editor.errorMsgCounter = 0;
+
+	setErrPointer();
+}
+
+// called while the list is still filling, the search needs the complete listing
+static void jumpToEntry(char jumpToChar)
 {
+	char firstChar;
 	int32_t i;
+	const char *title;
+
+	lockList(); // the fill thread replaces diskOpOrder/diskOpEntry while we look
 
-	if (diskOpEntry != NULL)
+	if (diskOpOrder != NULL)
 	{
 		for (i = 0; i < editor.diskop.numEntries; i++)
 		{
-			if (jumpToChar == diskOpEntry[i].firstAnsiChar)
+			title = getShownTitle(getEntry(i));
+			firstChar = (title != NULL) ? title[0] : getEntry(i)->firstAnsiChar;
+
+			if (tolower((uint8_t)jumpToChar) == tolower((uint8_t)firstChar))
 			{
 				// fix visual overrun
 				if (editor.diskop.numEntries > DISKOP_LINES && i > editor.diskop.numEntries-DISKOP_LINES)
 					i = editor.diskop.numEntries - DISKOP_LINES;
 
 				editor.diskop.scrollOffset = i;
+				unlockList();
+
 				editor.ui.updateDiskOpFileList = true;
 				return;
 			}
 		}
 	}
 
-	// character not found in file list, show red mouse pointer (error)!
-	editor.errorMsgActive = true;
-	editor.errorMsgBlock = true;
-	editor.errorMsgCounter = 0;
+	unlockList();
+	showNotFound();
+}
 
-	setErrPointer();
+static void clearSearch(void) // only call this with the list locked!
+{
+	if (searchView != NULL) free(searchView);
+	if (matches != NULL) free(matches);
+
+	searchView = NULL;
+	matches = NULL;
+	numMatches = 0;
+	searchLen = 0;
+	searchStr[0] = matchStr[0] = '\0';
+}
+
+static bool isWordStart(const char *key, const char *ptr)
+{
+	return ptr == key || ptr[-1] == ' ' || ptr[-1] == '_' || ptr[-1] == '-' || ptr[-1] == '.';
+}
+
+// 0 = name starts with str, 1 = a word in it does, 2 = it's somewhere else, -1 = no match
+static int8_t rankMatch(const char *key, const char *str)
+{
+	const char *ptr = strstr(key, str);
+
+	if (ptr == NULL)
+		return -1;
+
+	if (ptr == key)
+		return 0;
+
+	for (; ptr != NULL; ptr = strstr(ptr + 1, str))
+	{
+		if (isWordStart(key, ptr))
+			return 1;
+	}
+
+	return 2;
+}
+
+/* Finds the sorted positions whose shown text (module title or name) contains str, and
+** their rank. If the last result was for a substring of str, only those have to be checked,
+** unless titles have been found since. Otherwise the candidates are the names that contain
+** the rarest trigram of str (if there's an index and no titles are shown), or all entries.
+*/
+static int32_t findMatches(const char *str, uint32_t *newMatches, int8_t *ranks)
+{
+	char titleBuffer[sizeof (((fileEntry_t *)NULL)->preview.title)];
+	int8_t rank;
+	int32_t i, numCandidates, numNewMatches;
+	uint32_t h, bestStart, bestEnd;
+	const uint32_t *candidates;
+
+	const bool titles = modTitlesShown();
+
+	if (matches != NULL && matchStr[0] != '\0' && strstr(str, matchStr) != NULL && (!titles || matchPreviews == numPreviewsDone))
+	{
+		candidates = matches;
+		numCandidates = numMatches;
+	}
+	else if (trigramStart != NULL && !titles && strlen(str) >= 3)
+	{
+		bestStart = 0;
+		bestEnd = UINT32_MAX;
+
+		for (const char *ptr = str; ptr[2] != '\0'; ptr++)
+		{
+			h = hashTrigram(ptr);
+			if (trigramStart[h+1]-trigramStart[h] < bestEnd-bestStart)
+			{
+				bestStart = trigramStart[h];
+				bestEnd = trigramStart[h+1];
+			}
+		}
+
+		candidates = &trigramPos[bestStart];
+		numCandidates = (int32_t)(bestEnd - bestStart);
+	}
+	else
+	{
+		candidates = NULL; // all
+		numCandidates = numReadEntries;
+	}
+
+	numNewMatches = 0;
+	for (i = 0; i < numCandidates; i++)
+	{
+		const uint32_t pos = (candidates != NULL) ? candidates[i] : (uint32_t)i;
+
+		rank = rankMatch(getShownKey(pos, titleBuffer), str);
+		if (rank >= 0)
+		{
+			ranks[numNewMatches] = rank;
+			newMatches[numNewMatches++] = pos;
+		}
+	}
+
+	return numNewMatches;
+}
+
+// shows the entries that contain str, names that start with it first. Returns false if there are none
+static bool applySearch(const char *str)
+{
+	int8_t *ranks;
+	int32_t i, numRanked[3], numNewMatches;
+	uint32_t *newMatches, *newView;
+
+	newMatches = (uint32_t *)malloc((numReadEntries + 1) * sizeof (uint32_t));
+	ranks = (int8_t *)malloc(numReadEntries + 1);
+	if (newMatches == NULL || ranks == NULL)
+	{
+		if (newMatches != NULL) free(newMatches);
+		if (ranks != NULL) free(ranks);
+		statusOutOfMemory();
+		return false;
+	}
+
+	const uint32_t previews = numPreviewsDone;
+	numNewMatches = findMatches(str, newMatches, ranks);
+	if (numNewMatches == 0)
+	{
+		free(newMatches);
+		free(ranks);
+		return false;
+	}
+
+	newView = (uint32_t *)malloc(numNewMatches * sizeof (uint32_t));
+	if (newView == NULL)
+	{
+		free(newMatches);
+		free(ranks);
+		statusOutOfMemory();
+		return false;
+	}
+
+	// stable partition by rank, so every group stays sorted
+	numRanked[0] = numRanked[1] = numRanked[2] = 0;
+	for (i = 0; i < numNewMatches; i++)
+		numRanked[ranks[i]]++;
+
+	numRanked[2] = numRanked[0] + numRanked[1]; // now write positions
+	numRanked[1] = numRanked[0];
+	numRanked[0] = 0;
+
+	for (i = 0; i < numNewMatches; i++)
+		newView[numRanked[ranks[i]]++] = newMatches[i];
+
+	free(ranks);
+
+	lockList();
+	if (searchView != NULL) free(searchView);
+	if (matches != NULL) free(matches);
+
+	searchView = newView;
+	matches = newMatches;
+	numMatches = numNewMatches;
+	matchPreviews = previews;
+	strcpy(matchStr, str);
+
+	editor.diskop.numEntries = numNewMatches;
+	editor.diskop.scrollOffset = 0;
+	unlockList();
+
+	editor.ui.updateDiskOpFileList = true;
+	return true;
+}
+
+void handleEntryJumping(char jumpToChar) // SHIFT+character
+{
+	if (editor.diskop.isFilling)
+	{
+		jumpToEntry(jumpToChar);
+		return;
+	}
+
+	if (diskOpOrder == NULL || searchKeys == NULL || searchLen >= DISKOP_SEARCH_LEN)
+	{
+		showNotFound();
+		return;
+	}
+
+	searchStr[searchLen] = (char)tolower((uint8_t)jumpToChar);
+	searchStr[searchLen+1] = '\0';
+
+	if (!applySearch(searchStr))
+	{
+		searchStr[searchLen] = '\0';
+		showNotFound();
+		return;
+	}
+
+	searchLen++;
+	diskOpShowSelectText();
+}
+
+bool diskOpSearchBackspace(void) // SHIFT+backspace, returns false if there is no search
+{
+	if (searchLen == 0 || editor.diskop.isFilling)
+		return false;
+
+	searchStr[--searchLen] = '\0';
+
+	if (searchLen == 0)
+	{
+		lockList();
+		clearSearch();
+		editor.diskop.numEntries = numReadEntries;
+		editor.diskop.scrollOffset = 0;
+		unlockList();
+
+		editor.ui.updateDiskOpFileList = true;
+	}
+	else if (!applySearch(searchStr))
+	{
+		// can't happen unless we're out of memory, the shorter string matched before
+		lockList();
+		clearSearch();
+		editor.diskop.numEntries = numReadEntries;
+		unlockList();
+
+		editor.ui.updateDiskOpFileList = true;
+	}
+
+	diskOpShowSelectText();
+	return true;
 }
 
 bool diskOpEntryIsEmpty(int32_t fileIndex)
@@ -346,10 +1008,10 @@ bool diskOpEntryIsEmpty(int32_t fileIndex)
 
 bool diskOpEntryIsDir(int32_t fileIndex)
 {
-	if (diskOpEntry != NULL)
+	if (diskOpOrder != NULL)
 	{
 		if (!diskOpEntryIsEmpty(fileIndex))
-			return diskOpEntry[editor.diskop.scrollOffset+fileIndex].isDir;
+			return getEntry(editor.diskop.scrollOffset+fileIndex)->isDir;
 	}
 
 	return false; // couldn't look up entry
@@ -359,9 +1021,9 @@ char *diskOpGetAnsiEntry(int32_t fileIndex)
 {
 	UNICHAR *filenameU;
 
-	if (diskOpEntry != NULL && !diskOpEntryIsEmpty(fileIndex))
+	if (diskOpOrder != NULL && !diskOpEntryIsEmpty(fileIndex))
 	{
-		filenameU = diskOpEntry[editor.diskop.scrollOffset+fileIndex].nameU;
+		filenameU = getEntry(editor.diskop.scrollOffset+fileIndex)->nameU;
 		if (filenameU != NULL)
 		{
 			unicharToAnsi(fileNameBuffer, filenameU, PATH_MAX);
@@ -374,8 +1036,8 @@ char *diskOpGetAnsiEntry(int32_t fileIndex)
 
 UNICHAR *diskOpGetUnicodeEntry(int32_t fileIndex)
 {
-	if (diskOpEntry != NULL && !diskOpEntryIsEmpty(fileIndex))
-		return diskOpEntry[editor.diskop.scrollOffset+fileIndex].nameU;
+	if (diskOpOrder != NULL && !diskOpEntryIsEmpty(fileIndex))
+		return getEntry(editor.diskop.scrollOffset+fileIndex)->nameU;
 
 	return NULL;
 }
@@ -426,62 +1088,336 @@ void setPathFromDiskOpMode(void)
 
 bool diskOpSetPath(UNICHAR *path, bool cache)
 {
-	if (path != NULL && UNICHAR_CHDIR(path) == 0)
+	if (path != NULL && UNICHAR_CHDIR(path) == 0)
+	{
+		setVisualPathToCwd();
+
+		if (cache)
+			editor.diskop.cached = false;
+
+		if (editor.ui.diskOpScreenShown)
+			editor.ui.updateDiskOpFileList = true;
+
+		editor.diskop.scrollOffset = 0;
+		return true;
+	}
+	else
+	{
+		setVisualPathToCwd();
+		displayErrorMsg("CAN'T OPEN DIR !");
+		return false;
+	}
+}
+
+void diskOpSetInitPath(void)
+{
+	// default module path
+	if (ptConfig.defModulesDir[0] != '\0')
+	{
+#ifdef _WIN32
+		MultiByteToWideChar(CP_ACP, MB_PRECOMPOSED, ptConfig.defModulesDir, -1, pathTmp, PATH_MAX);
+#else
+		strcpy(pathTmp, ptConfig.defModulesDir);
+#endif
+		UNICHAR_STRCPY(editor.modulesPathU, pathTmp);
+	}
+	else
+	{
+		// no path set in config, set to current working directory
+		UNICHAR_GETCWD(editor.modulesPathU, PATH_MAX);
+	}
+
+	// default sample path
+	if (ptConfig.defSamplesDir[0] != '\0')
+	{
+#ifdef _WIN32
+		MultiByteToWideChar(CP_ACP, MB_PRECOMPOSED, ptConfig.defSamplesDir, -1, pathTmp, PATH_MAX);
+#else
+		strcpy(pathTmp, ptConfig.defSamplesDir);
+#endif
+		UNICHAR_STRCPY(editor.samplesPathU, pathTmp);
+	}
+	else
+	{
+		// no path set in config, set to current working directory
+		UNICHAR_GETCWD(editor.samplesPathU, PATH_MAX);
+	}
+
+	setPathFromDiskOpMode();
+}
+
+static bool getDirMtime(const UNICHAR *pathU, int64_t *mtime)
+{
+#ifdef _WIN32
+	struct _stat64 st;
+
+	if (_wstat64(pathU, &st) != 0)
+		return false;
+#else
+	struct stat st;
+
+	if (stat(pathU, &st) != 0)
+		return false;
+#endif
+
+	*mtime = (int64_t)st.st_mtime;
+	return true;
+}
+
+// remembers the state of the directory that is about to be read
+static void watchListedDir(void)
+{
+	listMode = editor.diskop.mode;
+	listPathU = UNICHAR_STRDUP(editor.currPathU);
+
+	if (!getDirMtime(editor.currPathU, &listDirMtime))
+		listDirMtime = -1;
+
+#ifdef __linux__
+	if (inotifyFd < 0)
+		inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (inotifyFd >= 0 && listPathU != NULL)
+	{
+		listWatch = inotify_add_watch(inotifyFd, listPathU, IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+			IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF);
+	}
+#endif
+}
+
+static void unwatchDir(int watch) // watches are per directory, so other listings may use the same one
+{
+#ifdef __linux__
+	if (watch < 0 || inotifyFd < 0 || watch == listWatch)
+		return;
+
+	for (int32_t i = 0; i < numCachedListings; i++)
+	{
+		if (listingCache[i].watch == watch)
+			return;
+	}
+
+	inotify_rm_watch(inotifyFd, watch);
+#else
+	(void)watch;
+#endif
+}
+
+// marks cached listings as stale if their directory has changed
+static void pollDirChanges(void)
+{
+#ifdef __linux__
+	char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	ssize_t len;
+	const struct inotify_event *event;
+
+	if (inotifyFd < 0)
+		return;
+
+	while ((len = read(inotifyFd, buf, sizeof (buf))) > 0)
+	{
+		for (char *ptr = buf; ptr < buf+len; ptr += sizeof (struct inotify_event) + event->len)
+		{
+			event = (const struct inotify_event *)ptr;
+
+			for (int32_t i = 0; i < numCachedListings; i++)
+			{
+				if (listingCache[i].watch == event->wd || (event->mask & IN_Q_OVERFLOW))
+					listingCache[i].stale = true;
+			}
+		}
+	}
+#endif
+}
+
+static bool listingChanged(dirListing_t *l)
+{
+	int64_t mtime;
+
+	if (l->stale)
+		return true;
+
+	if (l->watch >= 0)
+		return false; // inotify would have told us
+
+	return l->dirMtime == -1 || !getDirMtime(l->pathU, &mtime) || mtime != l->dirMtime;
+}
+
+// moves the shown listing to "l", and leaves an empty one. Only call this with the list locked!
+static void takeListing(dirListing_t *l)
+{
+	l->pathU = listPathU;
+	l->mode = listMode;
+	l->stale = false;
+	l->numEntries = numReadEntries;
+	l->entriesSize = diskOpEntrySize;
+	l->dirMtime = listDirMtime;
+	l->watch = listWatch;
+	l->entries = diskOpEntry;
+	l->order = diskOpOrder;
+	l->namePool = namePool;
+	l->searchKeys = searchKeys;
+	l->searchKeyOffsets = searchKeyOffsets;
+	l->trigramStart = trigramStart;
+	l->trigramPos = trigramPos;
+#ifndef _WIN32
+	l->dirFd = listDirFd;
+	listDirFd = -1;
+#else
+	l->dirFd = -1;
+#endif
+
+	listPathU = NULL;
+	listWatch = -1;
+	diskOpEntry = NULL;
+	diskOpOrder = NULL;
+	namePool = NULL;
+	searchKeys = NULL;
+	searchKeyOffsets = trigramStart = trigramPos = NULL;
+	diskOpEntrySize = numReadEntries = 0;
+	editor.diskop.numEntries = 0;
+
+	clearSearch(); // the search is for the shown listing only
+}
+
+// makes "l" the shown listing. Only call this with the list locked, and with no listing shown!
+static void showListing(dirListing_t *l)
+{
+	listPathU = l->pathU;
+	listMode = l->mode;
+	listDirMtime = l->dirMtime;
+	listWatch = l->watch;
+	diskOpEntry = l->entries;
+	diskOpOrder = l->order;
+	namePool = l->namePool;
+	searchKeys = l->searchKeys;
+	searchKeyOffsets = l->searchKeyOffsets;
+	trigramStart = l->trigramStart;
+	trigramPos = l->trigramPos;
+	diskOpEntrySize = l->entriesSize;
+	numReadEntries = l->numEntries;
+	editor.diskop.numEntries = l->numEntries;
+#ifndef _WIN32
+	listDirFd = l->dirFd;
+#endif
+}
+
+static void freeListing(dirListing_t *l)
+{
+	namePoolBlock_t *block;
+
+	if (l->pathU != NULL) free(l->pathU);
+	if (l->entries != NULL) free(l->entries);
+	if (l->order != NULL) free(l->order);
+	if (l->searchKeys != NULL) free(l->searchKeys);
+	if (l->searchKeyOffsets != NULL) free(l->searchKeyOffsets);
+	if (l->trigramStart != NULL) free(l->trigramStart);
+	if (l->trigramPos != NULL) free(l->trigramPos);
+
+	while (l->namePool != NULL)
+	{
+		block = l->namePool->next;
+		free(l->namePool);
+		l->namePool = block;
+	}
+
+#ifndef _WIN32
+	if (l->dirFd >= 0)
+		close(l->dirFd);
+#endif
+
+	unwatchDir(l->watch);
+	memset(l, 0, sizeof (dirListing_t));
+}
+
+// moves the shown listing to the front of the listing cache (or frees it, if it can't be cached)
+static void cacheCurrentListing(void)
+{
+	dirListing_t l;
+
+	lockList();
+	takeListing(&l);
+	unlockList();
+
+	if (l.pathU == NULL || l.order == NULL || editor.diskop.forceStopReading)
+	{
+		freeListing(&l);
+		return;
+	}
+
+	for (int32_t i = 0; i < numCachedListings; i++)
+	{
+		if (listingCache[i].mode == l.mode && !UNICHAR_STRCMP(listingCache[i].pathU, l.pathU))
+		{
+			// replaced by the newer one
+			dirListing_t old = listingCache[i];
+
+			numCachedListings--;
+			memmove(&listingCache[i], &listingCache[i+1], (numCachedListings - i) * sizeof (dirListing_t));
+			freeListing(&old);
+			break;
+		}
+	}
+
+	if (numCachedListings == DISKOP_LISTING_CACHE)
+	{
+		dirListing_t oldest = listingCache[--numCachedListings];
+		freeListing(&oldest);
+	}
+
+	memmove(&listingCache[1], &listingCache[0], numCachedListings * sizeof (dirListing_t));
+	listingCache[0] = l;
+	numCachedListings++;
+}
+
+// shows the cached listing of the current path, if there is one and the directory didn't change
+static bool showCachedListing(bool rescan)
+{
+	dirListing_t l;
+
+	pollDirChanges();
+
+	for (int32_t i = 0; i < numCachedListings; i++)
 	{
-		setVisualPathToCwd();
+		if (listingCache[i].mode != editor.diskop.mode || UNICHAR_STRCMP(listingCache[i].pathU, editor.currPathU) != 0)
+			continue;
 
-		if (cache)
-			editor.diskop.cached = false;
+		l = listingCache[i];
+		numCachedListings--;
+		memmove(&listingCache[i], &listingCache[i+1], (numCachedListings - i) * sizeof (dirListing_t));
 
-		if (editor.ui.diskOpScreenShown)
-			editor.ui.updateDiskOpFileList = true;
+		if (rescan || listingChanged(&l))
+		{
+			freeListing(&l);
+			return false;
+		}
 
-		editor.diskop.scrollOffset = 0;
+		lockList();
+		showListing(&l);
+		unlockList();
+
+		editor.ui.updateDiskOpFileList = true;
 		return true;
 	}
-	else
-	{
-		setVisualPathToCwd();
-		displayErrorMsg("CAN'T OPEN DIR !");
-		return false;
-	}
+
+	return false;
 }
 
-void diskOpSetInitPath(void)
+static void freeListingCache(void)
 {
-	// default module path
-	if (ptConfig.defModulesDir[0] != '\0')
-	{
-#ifdef _WIN32
-		MultiByteToWideChar(CP_ACP, MB_PRECOMPOSED, ptConfig.defModulesDir, -1, pathTmp, PATH_MAX);
-#else
-		strcpy(pathTmp, ptConfig.defModulesDir);
-#endif
-		UNICHAR_STRCPY(editor.modulesPathU, pathTmp);
-	}
-	else
+	while (numCachedListings > 0)
 	{
-		// no path set in config, set to current working directory
-		UNICHAR_GETCWD(editor.modulesPathU, PATH_MAX);
+		dirListing_t l = listingCache[--numCachedListings];
+		freeListing(&l);
 	}
 
-	// default sample path
-	if (ptConfig.defSamplesDir[0] != '\0')
-	{
-#ifdef _WIN32
-		MultiByteToWideChar(CP_ACP, MB_PRECOMPOSED, ptConfig.defSamplesDir, -1, pathTmp, PATH_MAX);
-#else
-		strcpy(pathTmp, ptConfig.defSamplesDir);
-#endif
-		UNICHAR_STRCPY(editor.samplesPathU, pathTmp);
-	}
-	else
+#ifdef __linux__
+	if (inotifyFd >= 0)
 	{
-		// no path set in config, set to current working directory
-		UNICHAR_GETCWD(editor.samplesPathU, PATH_MAX);
+		close(inotifyFd);
+		inotifyFd = -1;
 	}
-
-	setPathFromDiskOpMode();
+#endif
 }
 
 bool allocDiskOpVars(void)
@@ -492,10 +1428,12 @@ bool allocDiskOpVars(void)
 	editor.currPathU = (UNICHAR *)calloc(PATH_MAX + 2, sizeof (UNICHAR));
 	editor.modulesPathU = (UNICHAR *)calloc(PATH_MAX + 2, sizeof (UNICHAR));
 	editor.samplesPathU = (UNICHAR *)calloc(PATH_MAX + 2, sizeof (UNICHAR));
+	listMutex = SDL_CreateMutex();
 
 	if (editor.fileNameTmpU == NULL || editor.entryNameTmp == NULL ||
 		editor.currPath     == NULL || editor.currPathU    == NULL ||
-		editor.modulesPathU == NULL || editor.samplesPathU == NULL)
+		editor.modulesPathU == NULL || editor.samplesPathU == NULL ||
+		listMutex == NULL)
 	{
 		// allocated leftovers are free'd lateron
 		return false;
@@ -506,135 +1444,110 @@ bool allocDiskOpVars(void)
 
 void freeDiskOpMem(void)
 {
+	// the last fill thread may still be reading module headers
+	diskOpStopPreviewScan();
+	if (editor.diskop.fillThread != NULL)
+	{
+		SDL_WaitThread(editor.diskop.fillThread, NULL);
+		editor.diskop.fillThread = NULL;
+	}
+
+	freeModPreviewCache();
+	freeListingCache();
+
 	if (editor.fileNameTmpU != NULL) free(editor.fileNameTmpU);
 	if (editor.entryNameTmp != NULL) free(editor.entryNameTmp);
 	if (editor.currPath != NULL) free(editor.currPath);
 	if (editor.currPathU != NULL) free(editor.currPathU);
 	if (editor.modulesPathU != NULL) free(editor.modulesPathU);
 	if (editor.samplesPathU != NULL) free(editor.samplesPathU);
-}
 
-void freeDiskOpEntryMem(void)
-{
-	if (diskOpEntry != NULL)
+	if (listMutex != NULL)
 	{
-		for (int32_t i = 0; i < editor.diskop.numEntries; i++)
-		{
-			if (diskOpEntry[i].nameU != NULL)
-				free(diskOpEntry[i].nameU);
-		}
-
-		free(diskOpEntry);
-		diskOpEntry = NULL;
+		SDL_DestroyMutex(listMutex);
+		listMutex = NULL;
 	}
-
-	editor.diskop.numEntries = 0;
 }
 
-static bool swapEntries(int32_t a, int32_t b)
+void freeDiskOpEntryMem(void) // only call this on the fill thread, or after freeDiskOpMem()
 {
-	fileEntry_t tmpBuffer;
-
-	if (a >= editor.diskop.numEntries || b >= editor.diskop.numEntries)
-		return false;
+	dirListing_t l;
 
-	tmpBuffer = diskOpEntry[a];
-	diskOpEntry[a] = diskOpEntry[b];
-	diskOpEntry[b] = tmpBuffer;
+	lockList();
+	takeListing(&l);
+	unlockList();
 
-	return true;
+	freeListing(&l);
 }
 
-static char *getSortEntry(int32_t entry)
+static int32_t compareSortKeys(uint32_t entryA, uint32_t entryB)
 {
-	char *p;
-	int32_t nameLen;
-	fileEntry_t *dirEntry;
+	const int32_t result = strcmp(&sortKeys[sortKeyOffsets[entryA]], &sortKeys[sortKeyOffsets[entryB]]);
+	if (result != 0)
+		return result;
 
-	dirEntry = &diskOpEntry[entry];
-
-	unicharToAnsi(fileNameBuffer, dirEntry->nameU, PATH_MAX);
+	return (entryA > entryB) - (entryA < entryB); // same name in different case, keep the reading order
+}
 
-	nameLen = (int32_t)strlen(fileNameBuffer);
-	if (nameLen == 0)
-		return NULL;
+static int qsortCompareSortKeys(const void *a, const void *b)
+{
+	return compareSortKeys(*(const uint32_t *)a, *(const uint32_t *)b);
+}
 
-	p = (char *)malloc(nameLen + 2);
-	if (p == NULL)
-		return NULL;
+/* Makes the entries read since the last call visible. They are sorted on their own,
+** and then merged with the already shown (sorted) entries into a new index list.
+*/
+static bool publishEntries(void)
+{
+	uint32_t i, j, k, *newOrder, *batch;
 
-	if (dirEntry->isDir)
-	{
-		if (nameLen == 2 && fileNameBuffer[0] == '.' && fileNameBuffer[1] == '.')
-			p[0] = 0x01; // make ".." directory first priority
-		else
-			p[0] = 0x02; // make second priority
+	const uint32_t numShown = (uint32_t)editor.diskop.numEntries;
+	const uint32_t numRead = (uint32_t)numReadEntries;
 
-		strcpy(&p[1], fileNameBuffer);
-	}
-	else
-	{
-		strcpy(p, fileNameBuffer);
-	}
+	if (numRead == numShown)
+		return true;
 
-	return p;
-}
+	newOrder = (uint32_t *)malloc(numRead * sizeof (uint32_t));
+	if (newOrder == NULL)
+		return false;
 
-static void sortEntries(void)
-{
-	bool didSwap;
-	char *p1, *p2;
-	uint32_t offset, limit, i;
+	// the new batch goes at the end, the merge below never overwrites what it hasn't read yet
+	batch = &newOrder[numShown];
+	for (i = 0; i < numRead-numShown; i++)
+		batch[i] = numShown + i;
 
-	if (editor.diskop.numEntries < 2)
-		return; // no need to sort
+	qsort(batch, numRead-numShown, sizeof (uint32_t), qsortCompareSortKeys);
 
-	offset = editor.diskop.numEntries / 2;
-	while (offset > 0)
+	i = j = k = 0;
+	while (i < numShown && j < numRead-numShown)
 	{
-		limit = editor.diskop.numEntries - offset;
-		do
-		{
-			didSwap = false;
-			for (i = 0; i < limit; i++)
-			{
-				p1 = getSortEntry(i);
-				p2 = getSortEntry(offset + i);
+		if (compareSortKeys(diskOpOrder[i], batch[j]) <= 0)
+			newOrder[k++] = diskOpOrder[i++];
+		else
+			newOrder[k++] = batch[j++];
+	}
 
-				if (p1 == NULL || p2 == NULL)
-				{
-					if (p1 != NULL) free(p1);
-					if (p2 != NULL) free(p2);
-					statusOutOfMemory();
-					return;
-				}
+	while (i < numShown)
+		newOrder[k++] = diskOpOrder[i++];
+	// the rest of the batch is already in place
 
-				if (_stricmp(p1, p2) > 0)
-				{
-					if (!swapEntries(i , offset + i))
-					{
-						free(p1);
-						free(p2);
-						return;
-					}
-
-					didSwap = true;
-				}
+	lockList();
+	if (diskOpOrder != NULL)
+		free(diskOpOrder);
 
-				free(p1);
-				free(p2);
-			}
-		}
-		while (didSwap);
+	diskOpOrder = newOrder;
+	editor.diskop.numEntries = (int32_t)numRead;
+	unlockList();
 
-		offset /= 2;
-	}
+	editor.ui.updateDiskOpFileList = true;
+	return true;
 }
 
 static bool diskOpFillBuffer(void)
 {
 	uint8_t lastFindFileFlag;
-	fileEntry_t tmpBuffer, *newPtr;
+	uint32_t lastPublishTime;
+	fileEntry_t tmpBuffer;
 
 	editor.diskop.scrollOffset = 0;
 
@@ -642,76 +1555,225 @@ static bool diskOpFillBuffer(void)
 	if (editor.currPathU[0] == '\0')
 		setVisualPathToCwd();
 
-	freeDiskOpEntryMem();
+	// keep the old listing, and don't read the directory again if it's cached and unchanged
+	cacheCurrentListing();
+	if (showCachedListing(editor.diskop.rescan))
+		return true;
 
-	// fill disk op. buffer (type, size, path, file name, date changed)
+	editor.diskop.rescan = false;
+	watchListedDir();
 
-	// read first file
-	lastFindFileFlag = findFirst(&tmpBuffer);
-	if (lastFindFileFlag != LFF_DONE && lastFindFileFlag != LFF_SKIP)
-	{
-		diskOpEntry = (fileEntry_t *)malloc(sizeof (fileEntry_t) * (editor.diskop.numEntries + 1));
-		if (diskOpEntry == NULL)
-		{
-			findClose();
-			freeDiskOpEntryMem();
-			statusOutOfMemory();
-			return false;
-		}
+	// fill disk op. buffer (type, size, path, file name, date changed)
 
-		memcpy(&diskOpEntry[editor.diskop.numEntries], &tmpBuffer, sizeof (fileEntry_t));
-		editor.diskop.numEntries++;
-	}
+	lastPublishTime = SDL_GetTicks();
 
-	// read remaining files
-	while (lastFindFileFlag != LFF_DONE)
+	lastFindFileFlag = findFirst(&tmpBuffer);
+	while (lastFindFileFlag != LFF_DONE && !editor.diskop.forceStopReading)
 	{
-		lastFindFileFlag = findNext(&tmpBuffer);
-		if (lastFindFileFlag != LFF_DONE && lastFindFileFlag != LFF_SKIP)
+		if (lastFindFileFlag != LFF_SKIP)
 		{
-			newPtr = (fileEntry_t *)realloc(diskOpEntry, sizeof (fileEntry_t) * (editor.diskop.numEntries + 1));
-			if (newPtr == NULL)
+			if (!addEntry(&tmpBuffer))
 			{
 				findClose();
+				freeSortKeys();
 				freeDiskOpEntryMem();
 				statusOutOfMemory();
 				return false;
 			}
-			diskOpEntry = newPtr;
 
-			memcpy(&diskOpEntry[editor.diskop.numEntries], &tmpBuffer, sizeof (fileEntry_t));
-			editor.diskop.numEntries++;
+			// show the first screen as soon as possible, then the rest in batches
+			if (editor.diskop.numEntries < DISKOP_LINES || SDL_GetTicks()-lastPublishTime >= DISKOP_PUBLISH_MS)
+			{
+				publishEntries();
+				lastPublishTime = SDL_GetTicks();
+			}
 		}
+
+		lastFindFileFlag = findNext(&tmpBuffer);
 	}
 
 	findClose();
 
-	if (editor.diskop.numEntries > 0)
-	{
-		sortEntries();
-	}
-	else
+	if (numReadEntries == 0)
 	{
 		// access denied or out of memory - create parent directory link
-		diskOpEntry = bufferCreateEmptyDir();
-		if (diskOpEntry != NULL)
-			editor.diskop.numEntries = 1;
-		else
+		if (!bufferCreateEmptyDir())
 			statusOutOfMemory();
 	}
 
+	if (!publishEntries())
+	{
+		freeSortKeys();
+		freeDiskOpEntryMem();
+		statusOutOfMemory();
+		return false;
+	}
+
+	if (!buildSearchIndex())
+	{
+		freeSortKeys();
+		freeDiskOpEntryMem();
+		statusOutOfMemory();
+		return false;
+	}
+
+	freeSortKeys();
+	return true;
+}
+
+static bool getScanFilePath(fileEntry_t *entry)
+{
+	const int32_t pathLen = (int32_t)UNICHAR_STRLEN(scanPathU);
+
+	if (pathLen + (int32_t)UNICHAR_STRLEN(entry->nameU) + 1 >= PATH_MAX)
+		return false;
+
+	UNICHAR_STRCPY(scanFileU, scanPathU);
+#ifdef _WIN32
+	if (pathLen > 0 && scanPathU[pathLen-1] != L'\\')
+		UNICHAR_STRCAT(scanFileU, L"\\");
+#else
+	if (pathLen > 0 && scanPathU[pathLen-1] != '/')
+		UNICHAR_STRCAT(scanFileU, "/");
+#endif
+
+	UNICHAR_STRCAT(scanFileU, entry->nameU);
 	return true;
 }
 
+static void scanEntry(fileEntry_t *entry)
+{
+	entry->preview.format = -1;
+	entry->preview.title[0] = '\0';
+
+	if (getScanFilePath(entry) && readModPreview(scanFileU, &entry->preview))
+		storeModPreview(scanFileU, entry->filesize, entry->mtime, &entry->preview);
+
+	entry->previewDone = true;
+	numPreviewsDone++;
+}
+
+static fileEntry_t *getUnscannedVisibleEntry(void)
+{
+	fileEntry_t *entry = NULL;
+
+	lockList(); // the search filter may change what's visible
+	for (int32_t i = editor.diskop.scrollOffset; i < editor.diskop.numEntries && i < editor.diskop.scrollOffset+DISKOP_LINES; i++)
+	{
+		if (!getEntry(i)->previewDone && !getEntry(i)->isDir)
+		{
+			entry = getEntry(i);
+			break;
+		}
+	}
+	unlockList();
+
+	return entry;
+}
+
+// takes the preview from the cache if the file hasn't changed, this doesn't read the file
+static void lookupEntry(fileEntry_t *entry)
+{
+	if (entry->isDir || entry->previewDone)
+		return;
+
+	statEntryUnlocked(entry);
+
+	if (getScanFilePath(entry) && lookupModPreview(scanFileU, entry->filesize, entry->mtime, &entry->preview))
+	{
+		entry->previewDone = true;
+		numPreviewsDone++;
+	}
+}
+
+// reads the module headers for the file list, visible entries first
+static void scanModPreviews(void)
+{
+	int32_t i, nextEntry, numVisible;
+	fileEntry_t *entry, *visible[DISKOP_LINES];
+
+	// cached entries first, this doesn't read any files
+	numVisible = 0;
+
+	lockList(); // the search filter may change what's visible
+	for (i = editor.diskop.scrollOffset; i < editor.diskop.numEntries && i < editor.diskop.scrollOffset+DISKOP_LINES; i++)
+		visible[numVisible++] = getEntry(i);
+	unlockList();
+
+	for (i = 0; i < numVisible && !editor.diskop.stopScanning; i++)
+		lookupEntry(visible[i]);
+
+	if (numVisible > 0)
+		editor.ui.updateDiskOpFileList = true;
+
+	for (i = 0; i < numReadEntries && !editor.diskop.stopScanning; i++)
+		lookupEntry(getListEntry(i));
+
+	editor.ui.updateDiskOpFileList = true;
+
+	nextEntry = 0;
+	while (!editor.diskop.stopScanning)
+	{
+		// the list may have been scrolled
+		entry = getUnscannedVisibleEntry();
+		if (entry != NULL)
+		{
+			scanEntry(entry);
+			editor.ui.updateDiskOpFileList = true;
+			continue;
+		}
+
+		while (nextEntry < numReadEntries && (getListEntry(nextEntry)->previewDone || getListEntry(nextEntry)->isDir))
+			nextEntry++;
+
+		if (nextEntry >= numReadEntries)
+			break;
+
+		scanEntry(getListEntry(nextEntry));
+	}
+
+	// when stopped, the new entries are saved by the next scan that finishes
+	if (!editor.diskop.stopScanning)
+		saveModPreviewCache();
+}
+
+// doesn't wait, the next fill thread waits for the scan to stop before it touches the list
+void diskOpStopPreviewScan(void)
+{
+	if (editor.diskop.isScanning)
+		editor.diskop.stopScanning = true;
+}
+
 static int32_t SDLCALL diskOpFillThreadFunc(void *ptr)
 {
-	(void)ptr;
+	bool scan;
+	SDL_Thread *lastFillThread = (SDL_Thread *)ptr;
+
+	// the last fill thread may still be reading module headers of the entries we replace
+	if (lastFillThread != NULL)
+		SDL_WaitThread(lastFillThread, NULL);
 
 	editor.diskop.isFilling = true;
+	UNICHAR_STRCPY(scanPathU, editor.currPathU);
 	diskOpFillBuffer();
-	editor.diskop.isFilling = false;
 
+	// module headers are read after the list is shown, the UI isn't blocked by this
+	scan = (editor.diskop.mode == DISKOP_MODE_MOD) && ptConfig.diskOpModTitles && diskOpOrder != NULL;
+	if (scan)
+	{
+		editor.diskop.stopScanning = false;
+		editor.diskop.isScanning = true;
+	}
+
+	editor.diskop.isFilling = false;
 	editor.ui.updateDiskOpFileList = true;
+
+	if (scan)
+	{
+		scanModPreviews();
+		editor.diskop.isScanning = false;
+	}
+
 	return true;
 }
 
@@ -757,7 +1819,7 @@ static void printFileSize(uint32_t *frameBuffer, fileEntry_t *entry, uint16_t x,
 	textOut(frameBuffer, x, y, tmpStr, palette[PAL_QADSCP]);
 }
 
-static void printEntryName(uint32_t *frameBuffer, char *entryName, int32_t entryLength, int32_t maxLength, uint16_t x, uint16_t y)
+static void printEntryName(uint32_t *frameBuffer, const char *entryName, int32_t entryLength, int32_t maxLength, uint16_t x, uint16_t y)
 {
 	if (entryLength > maxLength)
 	{
@@ -777,11 +1839,13 @@ static void printEntryName(uint32_t *frameBuffer, char *entryName, int32_t entry
 void diskOpRenderFileList(uint32_t *frameBuffer)
 {
 	char *entryName;
+	const char *entryTitle;
 	uint8_t maxFilenameChars, maxDirNameChars;
 	uint16_t textXStart, x, y;
 	int32_t i, entryLength;
 	uint32_t *dstPtr;
 	fileEntry_t *entry;
+	SDL_Thread *lastFillThread;
 
 	if (ptConfig.hideDiskOpDates)
 	{
@@ -804,9 +1868,18 @@ void diskOpRenderFileList(uint32_t *frameBuffer)
 	// if needed, update the file list and add entries
 	if (!editor.diskop.cached)
 	{
-		editor.diskop.fillThread = SDL_CreateThread(diskOpFillThreadFunc, NULL, NULL);
-		if (editor.diskop.fillThread != NULL)
-			SDL_DetachThread(editor.diskop.fillThread);
+		diskOpStopPreviewScan();
+
+		editor.diskop.isFilling = true; // set here already, so that a key press can't search the old listing
+
+		// the new thread waits for the last one, so that the UI doesn't have to
+		lastFillThread = editor.diskop.fillThread;
+		editor.diskop.fillThread = SDL_CreateThread(diskOpFillThreadFunc, NULL, lastFillThread);
+		if (editor.diskop.fillThread == NULL)
+		{
+			editor.diskop.fillThread = lastFillThread; // still has to be waited for
+			editor.diskop.isFilling = false;
+		}
 
 		editor.diskop.cached = true;
 		return;
@@ -822,8 +1895,14 @@ void diskOpRenderFileList(uint32_t *frameBuffer)
 		dstPtr += SCREEN_W;
 	}
 
-	if (editor.diskop.isFilling || diskOpEntry == NULL)
+	// the list may still be filling, in that case only the entries read so far are shown
+	lockList();
+
+	if (diskOpOrder == NULL)
+	{
+		unlockList();
 		return;
+	}
 
 	// list entries
 	for (i = 0; i < DISKOP_LINES; i++)
@@ -831,7 +1910,7 @@ void diskOpRenderFileList(uint32_t *frameBuffer)
 		if (editor.diskop.scrollOffset+i >= editor.diskop.numEntries)
 			break;
 
-		entry = &diskOpEntry[editor.diskop.scrollOffset+i];
+		entry = getEntry(editor.diskop.scrollOffset+i);
 		entryName = diskOpGetAnsiEntry(i);
 		entryLength = (int32_t)strlen(entryName);
 
@@ -840,7 +1919,13 @@ void diskOpRenderFileList(uint32_t *frameBuffer)
 
 		if (!entry->isDir)
 		{
-			printEntryName(frameBuffer, entryName, entryLength, maxFilenameChars, x, y);
+			statEntry(entry);
+
+			entryTitle = getShownTitle(entry);
+			if (entryTitle != NULL)
+				printEntryName(frameBuffer, entryTitle, (int32_t)strlen(entryTitle), maxFilenameChars, x, y);
+			else
+				printEntryName(frameBuffer, entryName, entryLength, maxFilenameChars, x, y);
 
 			// print modification date
 			if (!ptConfig.hideDiskOpDates)
@@ -855,13 +1940,94 @@ void diskOpRenderFileList(uint32_t *frameBuffer)
 			textOut(frameBuffer, 264, y, "(DIR)", palette[PAL_QADSCP]);
 		}
 	}
+
+	unlockList();
 }
 
-void diskOpLoadFile(uint32_t fileEntryRow, bool songModifiedCheck)
+static void diskOpModLoaded(module_t *newMod)
 {
 	uint8_t oldMode, oldPlayMode;
+
+	oldMode = editor.currMode;
+	oldPlayMode = editor.playMode;
+
+	modStop();
+	modFree();
+
+	modEntry = newMod;
+	setupNewMod();
+	modEntry->moduleLoaded = true;
+
+	statusAllRight();
+
+	if (ptConfig.autoCloseDiskOp)
+		editor.ui.diskOpScreenShown = false;
+
+	if (ptConfig.rememberPlayMode)
+	{
+		if (oldMode == MODE_PLAY || oldMode == MODE_RECORD)
+		{
+			editor.playMode = oldPlayMode;
+
+			if (oldPlayMode == PLAY_MODE_PATTERN || oldMode == MODE_RECORD)
+				modPlay(0, 0, 0);
+			else
+				modPlay(DONT_SET_PATTERN, 0, 0);
+
+			if (oldMode == MODE_RECORD)
+				pointerSetMode(POINTER_MODE_RECORD, DO_CARRY);
+			else
+				pointerSetMode(POINTER_MODE_PLAY, DO_CARRY);
+
+			editor.currMode = oldMode;
+		}
+	}
+	else
+	{
+		editor.currMode = MODE_IDLE;
+		editor.playMode = PLAY_MODE_NORMAL;
+		editor.songPlaying = false;
+
+		pointerSetMode(POINTER_MODE_IDLE, DO_CARRY);
+	}
+
+	displayMainScreen();
+}
+
+// shift+click: play the listed modules as a playlist, starting with this one
+static void diskOpPlayAll(uint32_t fileEntryRow)
+{
+	int32_t start, numFiles;
+	fileEntry_t *entry;
+
+	playlistClear();
+
+	start = numFiles = 0;
+	for (int32_t i = 0; i < editor.diskop.numEntries; i++)
+	{
+		entry = getEntry(i);
+		if (entry->isDir || isPlaylistFile(entry->nameU))
+			continue;
+
+		if (i == editor.diskop.scrollOffset+(int32_t)fileEntryRow)
+			start = numFiles;
+
+		if (!playlistAdd(editor.currPathU, entry->nameU))
+		{
+			playlistClear();
+			statusOutOfMemory();
+			return;
+		}
+
+		numFiles++;
+	}
+
+	playlistStart(start);
+}
+
+void diskOpLoadFile(uint32_t fileEntryRow, bool songModifiedCheck)
+{
 	UNICHAR *filePath;
-	module_t *tempMod;
 
 	// if we clicked on an empty space, return...
 	if (diskOpEntryIsEmpty(fileEntryRow))
@@ -878,6 +2044,9 @@ void diskOpLoadFile(uint32_t fileEntryRow, bool songModifiedCheck)
 		{
 			if (editor.diskop.mode == DISKOP_MODE_MOD)
 			{
+				if (songModifiedCheck)
+					oldPlayAll = input.keyb.shiftPressed;
+
 				if (songModifiedCheck && modEntry->modified)
 				{
 					oldFileEntryRow = fileEntryRow;
@@ -885,62 +2054,22 @@ void diskOpLoadFile(uint32_t fileEntryRow, bool songModifiedCheck)
 					return;
 				}
 
-				tempMod = modLoad(filePath);
-				if (tempMod != NULL)
+				if (isPlaylistFile(filePath))
 				{
-					oldMode = editor.currMode;
-					oldPlayMode = editor.playMode;
-
-					modStop();
-					modFree();
-
-					modEntry = tempMod;
-					setupNewMod();
-					modEntry->moduleLoaded = true;
-
-					statusAllRight();
-
-					if (ptConfig.autoCloseDiskOp)
-						editor.ui.diskOpScreenShown = false;
-
-					if (ptConfig.rememberPlayMode)
-					{
-						if (oldMode == MODE_PLAY || oldMode == MODE_RECORD)
-						{
-							editor.playMode = oldPlayMode;
-
-							if (oldPlayMode == PLAY_MODE_PATTERN || oldMode == MODE_RECORD)
-								modPlay(0, 0, 0);
-							else
-								modPlay(DONT_SET_PATTERN, 0, 0);
-
-							if (oldMode == MODE_RECORD)
-								pointerSetMode(POINTER_MODE_RECORD, DO_CARRY);
-							else
-								pointerSetMode(POINTER_MODE_PLAY, DO_CARRY);
-
-							editor.currMode = oldMode;
-						}
-					}
+					playlistClear();
+					if (playlistAddM3U(filePath))
+						playlistStart(0);
 					else
-					{
-						editor.currMode = MODE_IDLE;
-						editor.playMode = PLAY_MODE_NORMAL;
-						editor.songPlaying = false;
-
-						pointerSetMode(POINTER_MODE_IDLE, DO_CARRY);
-					}
-
-					displayMainScreen();
+						displayErrorMsg("FILE I/O ERROR !");
+				}
+				else if (oldPlayAll)
+				{
+					diskOpPlayAll(fileEntryRow);
 				}
 				else
 				{
-					editor.errorMsgActive  = true;
-					editor.errorMsgBlock = true;
-					editor.errorMsgCounter = 0;
-
-					// status/error message is set in the mod loader
-					setErrPointer();
+					playlistStop(); // loading a module by hand ends the playlist
+					modLoadThreaded(filePath, diskOpModLoaded, true);
 				}
 			}
 			else if (editor.diskop.mode == DISKOP_MODE_SMP)
@@ -16,6 +16,7 @@ void diskOpShowSelectText(void);
 void diskOpLoadFile(uint32_t fileEntryRow, bool songModifiedCheck);
 void diskOpLoadFile2(void);
 void handleEntryJumping(char jumpToChar);
+bool diskOpSearchBackspace(void);
 bool diskOpEntryIsEmpty(int32_t fileIndex);
 bool diskOpEntryIsDir(int32_t fileIndex);
 char *diskOpGetAnsiEntry(int32_t fileIndex);
@@ -26,5 +27,6 @@ void diskOpRenderFileList(uint32_t *frameBuffer);
 bool allocDiskOpVars(void);
 void freeDiskOpMem(void);
 void freeDiskOpEntryMem(void);
+void diskOpStopPreviewScan(void);
 void setPathFromDiskOpMode(void);
 bool changePathToHome(void);
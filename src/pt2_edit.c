@@ -748,6 +748,7 @@ void handleEditKeys(SDL_Scancode scancode, bool normalMode)
 						if (editor.currMode != MODE_RECORD)
 							modSetPos(DONT_SET_ORDER, (modEntry->currRow + editor.editMoveAdd) & 0x3F);
 
+						modPatternChanged(modEntry->currPattern);
 						updateWindowTitle(MOD_IS_MODIFIED);
 					}
 				}
@@ -762,6 +763,7 @@ void handleEditKeys(SDL_Scancode scancode, bool normalMode)
 						if (editor.currMode != MODE_RECORD)
 							modSetPos(DONT_SET_ORDER, (modEntry->currRow + editor.editMoveAdd) & 0x3F);
 
+						modPatternChanged(modEntry->currPattern);
 						updateWindowTitle(MOD_IS_MODIFIED);
 					}
 				}
@@ -776,6 +778,7 @@ void handleEditKeys(SDL_Scancode scancode, bool normalMode)
 						if (editor.currMode != MODE_RECORD)
 							modSetPos(DONT_SET_ORDER, (modEntry->currRow + editor.editMoveAdd) & 0x3F);
 
+						modPatternChanged(modEntry->currPattern);
 						updateWindowTitle(MOD_IS_MODIFIED);
 					}
 				}
@@ -790,6 +793,7 @@ void handleEditKeys(SDL_Scancode scancode, bool normalMode)
 						if (editor.currMode != MODE_RECORD)
 							modSetPos(DONT_SET_ORDER, (modEntry->currRow + editor.editMoveAdd) & 0x3F);
 
+						modPatternChanged(modEntry->currPattern);
 						updateWindowTitle(MOD_IS_MODIFIED);
 					}
 				}
@@ -804,6 +808,7 @@ void handleEditKeys(SDL_Scancode scancode, bool normalMode)
 						if (editor.currMode != MODE_RECORD)
 							modSetPos(DONT_SET_ORDER, (modEntry->currRow + editor.editMoveAdd) & 0x3F);
 
+						modPatternChanged(modEntry->currPattern);
 						updateWindowTitle(MOD_IS_MODIFIED);
 					}
 				}
@@ -836,6 +841,7 @@ void handleEditKeys(SDL_Scancode scancode, bool normalMode)
 				if (editor.currMode != MODE_RECORD)
 					modSetPos(DONT_SET_ORDER, (modEntry->currRow + editor.editMoveAdd) & 63);
 
+				modPatternChanged(modEntry->currPattern);
 				updateWindowTitle(MOD_IS_MODIFIED);
 			}
 		}
@@ -866,6 +872,7 @@ bool handleSpecialKeys(SDL_Scancode scancode)
 			note->command = editor.effectMacros[scancode - SDL_SCANCODE_1] >> 8;
 			note->param = editor.effectMacros[scancode - SDL_SCANCODE_1] & 0xFF;
 
+			modPatternChanged(modEntry->currPattern);
 			updateWindowTitle(MOD_IS_MODIFIED);
 			return true;
 		}
@@ -876,6 +883,7 @@ bool handleSpecialKeys(SDL_Scancode scancode)
 			note->command = prevNote->command;
 			note->param   = prevNote->param;
 
+			modPatternChanged(modEntry->currPattern);
 			updateWindowTitle(MOD_IS_MODIFIED);
 			return true;
 		}
@@ -886,6 +894,7 @@ bool handleSpecialKeys(SDL_Scancode scancode)
 			note->command = prevNote->command;
 			note->param = prevNote->param + 1; // wraps 0x00..0xFF
 
+			modPatternChanged(modEntry->currPattern);
 			updateWindowTitle(MOD_IS_MODIFIED);
 			return true;
 		}
@@ -896,6 +905,7 @@ bool handleSpecialKeys(SDL_Scancode scancode)
 			note->command = prevNote->command;
 			note->param = prevNote->param - 1; // wraps 0x00..0xFF
 
+			modPatternChanged(modEntry->currPattern);
 			updateWindowTitle(MOD_IS_MODIFIED);
 			return true;
 		}
@@ -981,6 +991,7 @@ void jamAndPlaceSample(SDL_Scancode scancode, bool normalMode)
 					if (editor.currMode != MODE_RECORD)
 						modSetPos(DONT_SET_ORDER, (modEntry->currRow + editor.editMoveAdd) & 0x3F);
 
+					modPatternChanged(modEntry->currPattern);
 					updateWindowTitle(MOD_IS_MODIFIED);
 				}
 			}
@@ -988,8 +999,6 @@ void jamAndPlaceSample(SDL_Scancode scancode, bool normalMode)
 			if (editor.multiFlag)
 				gotoNextMulti();
 		}
-
-		updateSpectrumAnalyzer(s->volume, tempPeriod);
 	}
 	else if (noteVal == -2)
 	{
@@ -1005,6 +1014,7 @@ void jamAndPlaceSample(SDL_Scancode scancode, bool normalMode)
 				if (editor.currMode != MODE_RECORD)
 					modSetPos(DONT_SET_ORDER, (modEntry->currRow + editor.editMoveAdd) & 0x3F);
 
+				modPatternChanged(modEntry->currPattern);
 				updateWindowTitle(MOD_IS_MODIFIED);
 			}
 		}
@@ -1047,6 +1057,7 @@ uint8_t quantizeCheck(uint8_t row)
 
 void saveUndo(void)
 {
+	modPatternChanged(modEntry->currPattern); // every caller is about to write to the pattern
 	memcpy(editor.undoBuffer, modEntry->patterns[modEntry->currPattern], sizeof (note_t) * (AMIGA_VOICES * MOD_ROWS));
 }
 
@@ -1061,6 +1072,8 @@ void undoLastChange(void)
 		modEntry->patterns[modEntry->currPattern][i] = data;
 	}
 
+	modPatternChanged(modEntry->currPattern);
+
 	updateWindowTitle(MOD_IS_MODIFIED);
 	editor.ui.updatePatternData = true;
 }
@@ -1102,6 +1115,7 @@ void copySampleTrack(void)
 		// copy sample data
 		memcpy(&modEntry->sampleData[smpTo->offset], &modEntry->sampleData[smpFrom->offset], MAX_SAMPLE_LEN);
 
+		invalidateSamplePeaks();
 		updateCurrSample();
 		editor.ui.updateSongSize = true;
 	}
@@ -1130,6 +1144,7 @@ void copySampleTrack(void)
 			}
 		}
 
+		modPatternChanged(modEntry->currPattern);
 		editor.ui.updatePatternData = true;
 	}
 
@@ -1192,6 +1207,7 @@ void exchSampleTrack(void)
 
 		editor.sampleZero = false;
 
+		invalidateSamplePeaks();
 		updateCurrSample();
 	}
 	else
@@ -1221,6 +1237,7 @@ void exchSampleTrack(void)
 			}
 		}
 
+		modPatternChanged(modEntry->currPattern);
 		editor.ui.updatePatternData = true;
 	}
 
@@ -46,11 +46,6 @@
 ** no vsync we will get stuttering because the rate is not perfect... */
 #define VBLANK_HZ 60
 
-/* Scopes are clocked at 64Hz instead of 60Hz to prevent +/- interference
-** from monitors not being exactly 60Hz (and unstable non-vsync mode).
-** Sadly the scopes might midly flicker from this. */
-#define SCOPE_HZ 64
-
 #define AMIGA_PAL_VBLANK_HZ 50
 
 #define FONT_CHAR_W 8 // actual data length is 7, includes right spacing (1px column)
@@ -208,6 +203,7 @@ enum
 	ASK_RESTORE_SAMPLE = 18,
 	ASK_DISCARD_SONG = 19,
 	ASK_DISCARD_SONG_DRAGNDROP = 20,
+	ASK_DISCARD_LOADED_SONG = 21,
 
 	TEMPO_MODE_CIA = 0,
 	TEMPO_MODE_VBLANK = 1,
@@ -246,6 +242,12 @@ typedef struct note_t
 	uint16_t period;
 } note_t;
 
+typedef struct cellEvent_t // a pattern cell as the replayer reads it (compiled from a note_t)
+{
+	uint16_t note, cmd;
+	uint8_t sample, effect, noteIndex, flags;
+} cellEvent_t;
+
 typedef struct moduleHeader_t
 {
 	char moduleTitle[20 + 1];
@@ -273,6 +275,7 @@ typedef struct moduleChannel_t
 	uint8_t n_vibratocmd, n_tremolocmd, n_finetune, n_funkoffset, n_samplenum;
 	int16_t n_period, n_note, n_wantedperiod;
 	uint16_t n_cmd;
+	uint8_t n_effect, n_noteindex, n_flags;
 	uint32_t n_scopedelta, n_length, n_replen;
 } moduleChannel_t;
 
@@ -286,6 +289,8 @@ typedef struct module_t
 	moduleSample_t samples[MOD_SAMPLES];
 	moduleChannel_t channels[AMIGA_VOICES];
 	note_t *patterns[MAX_PATTERNS];
+	cellEvent_t *events[MAX_PATTERNS]; // the patterns compiled for the replayer
+	bool patternDirty[MAX_PATTERNS]; // events[] has to be recompiled, see modPatternChanged()
 } module_t;
 
 struct cpu_t
@@ -327,7 +332,7 @@ struct editor_t
 {
 	volatile int8_t vuMeterVolumes[AMIGA_VOICES], spectrumVolumes[SPECTRUM_BAR_NUM];
 	volatile int8_t *sampleFromDisp, *sampleToDisp, *currSampleDisp, realVuMeterVolumes[AMIGA_VOICES];
-	volatile bool songPlaying, programRunning, isWAVRendering, isSMPRendering, smpRenderingDone;
+	volatile bool songPlaying, programRunning, isWAVRendering, isSMPRendering, smpRenderingDone, isModLoading, playlistActive;
 	volatile uint8_t modTick, modSpeed;
 	volatile uint16_t *quantizeValueDisp, *metroSpeedDisp, *metroChannelDisp, *sampleVolDisp;
 	volatile uint16_t *vol1Disp, *vol2Disp, *currEditPatternDisp, *currPosDisp, *currPatternDisp;
@@ -365,8 +370,8 @@ struct editor_t
 
 	struct diskop_t
 	{
-		volatile bool cached, isFilling, forceStopReading;
-		bool modPackFlg;
+		volatile bool cached, isFilling, forceStopReading, isScanning, stopScanning;
+		bool modPackFlg, rescan; // rescan = don't use a cached listing of this directory
 		int8_t mode, smpSaveType;
 		int32_t numEntries, scrollOffset;
 		SDL_Thread *fillThread;
@@ -467,14 +472,20 @@ void modStop(void);
 void doStopIt(void);
 void playPattern(int8_t startRow);
 void modPlay(int16_t patt, int16_t order, int8_t row);
+module_t *modSwapSong(module_t *newMod);
 void modSetSpeed(uint8_t speed);
 void modSetTempo(uint16_t bpm);
 void modFree(void);
 bool setupAudio(void);
+bool setupAudioHeadless(int32_t freq);
 void audioClose(void);
 void clearSong(void);
 void clearSamples(void);
 void clearAll(void);
 void modSetPattern(uint8_t pattern);
+void initPeriodToNoteTable(void);
+void compilePatterns(module_t *m);
+void modPatternChanged(int32_t pattern);
+void updateCompiledPatterns(void);
 
 extern module_t *modEntry; // pt_main.c
@@ -6,14 +6,23 @@
 #include <SDL2/SDL.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <ctype.h> // toupper()
 #ifndef _WIN32
+#include <errno.h>
+#include <signal.h>
+#include <setjmp.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #else
 #define WIN32_MEAN_AND_LEAN
 #include <windows.h>
+#include <shlobj.h> // SHGetFolderPathW()
 #endif
 #include "pt2_helpers.h"
 #include "pt2_header.h"
@@ -22,6 +31,14 @@
 
 extern SDL_Window *window; // pt_main.c
 
+#ifndef _WIN32
+// the mapped file this thread is reading, see mapFileGuard()
+static __thread sigjmp_buf *faultJump;
+static __thread const uint8_t *faultData;
+static __thread uint32_t faultLength;
+static struct sigaction oldBusAction;
+#endif
+
 // used for Windows usleep() implementation
 #ifdef _WIN32
 static NTSTATUS (__stdcall *NtDelayExecution)(BOOL Alertable, PLARGE_INTEGER DelayInterval);
@@ -203,3 +220,334 @@ void recalcChordLength(void)
 	if (editor.ui.editOpScreenShown && editor.ui.editOpScreen == 3)
 		editor.ui.updateLengthText = true;
 }
+
+// reads the file into memory, for when it can't be mapped (pipes, some network shares etc.)
+static bool readWholeFile(UNICHAR *fileName, mappedFile_t *f)
+{
+	uint8_t *buffer;
+	long fileSize;
+	FILE *file;
+
+	file = UNICHAR_FOPEN(fileName, "rb");
+	if (file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (fileSize < 0)
+	{
+		fclose(file);
+		return false;
+	}
+
+	buffer = (uint8_t *)malloc(fileSize + 1);
+	if (buffer == NULL)
+	{
+		fclose(file);
+		return false;
+	}
+
+	f->length = (uint32_t)fread(buffer, 1, fileSize, file);
+	fclose(file);
+
+	f->data = buffer;
+	f->mapped = false;
+	return true;
+}
+
+#ifdef _WIN32
+static bool isOnFixedDrive(UNICHAR *fileName)
+{
+	WCHAR volumePath[MAX_PATH + 1];
+
+	if (!GetVolumePathNameW(fileName, volumePath, MAX_PATH + 1))
+		return false;
+
+	return GetDriveTypeW(volumePath) == DRIVE_FIXED;
+}
+#endif
+
+/* Maps the whole file read-only into memory, so that it can be parsed without copying
+** it to a buffer first. The pages are read from disk when they're first accessed.
+** Small files are read instead (mapping them costs more than the copy), and so are files
+** that can't be mapped. Files over 4GB are not supported.
+**
+** Reading a mapped file can fail after it has been opened (the file was truncated, or
+** a network share or USB drive returned an I/O error while paging it in). On Windows
+** only files on local disks are mapped, elsewhere the reader has to use mapFileGuard().
+*/
+bool mapFile(UNICHAR *fileName, mappedFile_t *f)
+{
+	memset(f, 0, sizeof (mappedFile_t));
+
+#ifdef _WIN32
+	HANDLE hFile, hMapping;
+	LARGE_INTEGER fileSize;
+	void *view;
+
+	hFile = CreateFileW(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart > UINT32_MAX)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	hMapping = NULL;
+	view = NULL;
+
+	// a read error in a mapped view can't be handled, so only map files on local disks
+	if (fileSize.QuadPart >= MAP_FILE_MIN_SIZE && isOnFixedDrive(fileName))
+	{
+		hMapping = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (hMapping != NULL)
+		{
+			view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+			if (view == NULL)
+				CloseHandle(hMapping);
+		}
+	}
+
+	CloseHandle(hFile); // the mapping keeps the file open
+
+	if (view == NULL)
+		return readWholeFile(fileName, f);
+
+	f->data = (const uint8_t *)view;
+	f->length = (uint32_t)fileSize.QuadPart;
+	f->mapped = true;
+	f->hMapping = hMapping;
+	return true;
+#else
+	int fd;
+	struct stat st;
+	void *view;
+
+	fd = open(fileName, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	if (fstat(fd, &st) != 0 || (uint64_t)st.st_size > UINT32_MAX)
+	{
+		close(fd);
+		return false;
+	}
+
+	view = MAP_FAILED;
+	if (S_ISREG(st.st_mode) && st.st_size >= MAP_FILE_MIN_SIZE)
+		view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	close(fd); // the mapping keeps the file open
+
+	if (view == MAP_FAILED)
+		return readWholeFile(fileName, f);
+
+	f->data = (const uint8_t *)view;
+	f->length = (uint32_t)st.st_size;
+	f->mapped = true;
+	return true;
+#endif
+}
+
+void unmapFile(mappedFile_t *f)
+{
+	if (f->data == NULL)
+		return;
+
+	if (f->mapped)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(f->data);
+		CloseHandle((HANDLE)f->hMapping);
+#else
+		if (faultData == f->data)
+			faultJump = NULL; // unguard
+
+		munmap((void *)f->data, f->length);
+#endif
+	}
+	else
+	{
+		free((void *)f->data);
+	}
+
+	f->data = NULL;
+	f->length = 0;
+}
+
+#ifndef _WIN32
+static void busErrorHandler(int32_t sig, siginfo_t *info, void *context)
+{
+	const uint8_t *addr = (const uint8_t *)info->si_addr;
+
+	if (faultJump != NULL && addr >= faultData && addr < faultData+faultLength)
+		siglongjmp(*faultJump, 1);
+
+	// not a guarded file read, pass it on to the crash handler (if any)
+	if (oldBusAction.sa_flags & SA_SIGINFO)
+		oldBusAction.sa_sigaction(sig, info, context);
+	else if (oldBusAction.sa_handler != SIG_DFL && oldBusAction.sa_handler != SIG_IGN)
+		oldBusAction.sa_handler(sig);
+
+	// terminate when we return (the signal is blocked until then)
+	signal(SIGBUS, SIG_DFL);
+	raise(SIGBUS);
+}
+
+// call after the crash handler has been set up, it gets the SIGBUS signals that are not from mapped files
+void setupMapFileFaultHandler(void)
+{
+	struct sigaction act;
+
+	memset(&act, 0, sizeof (act));
+	act.sa_sigaction = busErrorHandler;
+	act.sa_flags = SA_SIGINFO;
+	sigemptyset(&act.sa_mask);
+
+	sigaction(SIGBUS, &act, &oldBusAction);
+}
+
+/* A SIGBUS while this thread reads the mapped file makes sigsetjmp(*jump) return 1,
+** instead of crashing. Lasts until the file is unmapped. Does nothing for files that
+** were read into memory.
+*/
+void mapFileGuard(const mappedFile_t *f, sigjmp_buf *jump)
+{
+	if (!f->mapped)
+		return;
+
+	faultData = f->data;
+	faultLength = f->length;
+	faultJump = jump;
+}
+#endif
+
+/* Writes the data to "<fileName>.tmp" with one write, flushes it to the disk and then renames
+** it over fileName. If anything fails (disk full, crash during the write etc.), the old file
+** is left untouched.
+*/
+bool writeFileAtomic(const char *fileName, const void *data, uint32_t length)
+{
+	char tmpName[PATH_MAX + 8];
+
+	if (strlen(fileName) > PATH_MAX)
+		return false;
+
+	sprintf(tmpName, "%s.tmp", fileName); // same directory, or the rename wouldn't be atomic
+
+#ifdef _WIN32
+	HANDLE hFile;
+	DWORD bytesWritten;
+
+	hFile = CreateFileA(tmpName, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	if (!WriteFile(hFile, data, length, &bytesWritten, NULL) || bytesWritten != length || !FlushFileBuffers(hFile))
+	{
+		CloseHandle(hFile);
+		DeleteFileA(tmpName);
+		return false;
+	}
+
+	CloseHandle(hFile);
+
+	if (!MoveFileExA(tmpName, fileName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		DeleteFileA(tmpName);
+		return false;
+	}
+
+	return true;
+#else
+	const uint8_t *ptr = (const uint8_t *)data;
+	int fd;
+	mode_t mode;
+	ssize_t bytesWritten;
+	struct stat st;
+
+	// keep the permissions of the file we replace
+	mode = 0666;
+	if (stat(fileName, &st) == 0)
+		mode = st.st_mode & 0777;
+
+	fd = open(tmpName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+	if (fd < 0)
+		return false;
+
+	while (length > 0) // one write, unless it gets interrupted
+	{
+		bytesWritten = write(fd, ptr, length);
+		if (bytesWritten < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			goto error;
+		}
+
+		ptr += bytesWritten;
+		length -= (uint32_t)bytesWritten;
+	}
+
+	if (fsync(fd) != 0)
+		goto error;
+
+	if (close(fd) != 0)
+	{
+		fd = -1;
+		goto error;
+	}
+
+	if (rename(tmpName, fileName) != 0)
+	{
+		unlink(tmpName);
+		return false;
+	}
+
+	return true;
+
+error:
+	if (fd >= 0)
+		close(fd);
+
+	unlink(tmpName);
+	return false;
+#endif
+}
+
+// pathU = the config directory (%APPDATA% or ~/.protracker/, made if needed) + fileName (ASCII)
+bool getConfigFilePath(UNICHAR *pathU, const char *fileName) // pathU must hold PATH_MAX+32 chars
+{
+	UNICHAR *dstPtr;
+
+#ifdef _WIN32
+	if (SHGetFolderPathW(NULL, CSIDL_APPDATA, NULL, 0, pathU) < 0)
+		return false;
+
+	wcscat(pathU, L"\\");
+#else
+	char *homePath = getenv("HOME");
+	if (homePath == NULL || strlen(homePath) > PATH_MAX)
+		return false;
+
+	sprintf(pathU, "%s/.protracker", homePath);
+	mkdir(pathU, 0755); // may already exist
+
+	strcat(pathU, "/");
+#endif
+
+	if (strlen(fileName) >= 32-1)
+		return false;
+
+	dstPtr = pathU + UNICHAR_STRLEN(pathU);
+	while (*fileName != '\0')
+		*dstPtr++ = (UNICHAR)*fileName++;
+	*dstPtr = '\0';
+
+	return true;
+}
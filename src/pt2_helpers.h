@@ -3,7 +3,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <math.h>
+#ifndef _WIN32
+#include <setjmp.h>
+#endif
 #include "pt2_header.h"
+#include "pt2_unicode.h"
 
 // fast 32-bit -> 16-bit clamp
 #define CLAMP16(i) if ((int16_t)(i) != i) i = 0x7FFF ^ (i >> 31)
@@ -49,6 +53,19 @@
 
 #define RGB24(r, g, b) (((r) << 16) | ((g) << 8) | (b))
 
+#define MAP_FILE_MIN_SIZE 65536 /* smaller files are read by mapFile(), that's faster */
+
+// a read-only view of a whole file, see mapFile()
+typedef struct mappedFile_t
+{
+	const uint8_t *data;
+	uint32_t length;
+	bool mapped; // false if the file had to be read into memory instead
+#ifdef _WIN32
+	void *hMapping;
+#endif
+} mappedFile_t;
+
 void showErrorMsgBox(const char *fmt, ...);
 
 #ifdef _WIN32
@@ -63,3 +80,11 @@ bool sampleNameIsEmpty(char *name);
 bool moduleNameIsEmpty(char *name);
 void updateWindowTitle(bool modified);
 void recalcChordLength(void);
+bool mapFile(UNICHAR *fileName, mappedFile_t *f);
+void unmapFile(mappedFile_t *f);
+#ifndef _WIN32
+void setupMapFileFaultHandler(void);
+void mapFileGuard(const mappedFile_t *f, sigjmp_buf *jump);
+#endif
+bool writeFileAtomic(const char *fileName, const void *data, uint32_t length);
+bool getConfigFilePath(UNICHAR *pathU, const char *fileName);
@@ -26,6 +26,8 @@
 #include "pt2_modloader.h"
 #include "pt2_mouse.h"
 #include "pt2_unicode.h"
+#include "pt2_profiler.h"
+#include "pt2_trace.h"
 
 #ifdef _WIN32
 extern bool windowsKeyIsDown;
@@ -443,7 +445,7 @@ void keyDownHandler(SDL_Scancode scancode, SDL_Keycode keycode)
 		input.keyb.lastRepKey = scancode;
 	}
 
-	// ENTRY JUMPING IN DISK OP. FILELIST
+	// ENTRY SEARCHING IN DISK OP. FILELIST
 	if (editor.ui.diskOpScreenShown && input.keyb.shiftPressed && !editor.ui.editTextFlag)
 	{
 		if (keycode >= 32 && keycode <= 126)
@@ -451,6 +453,9 @@ void keyDownHandler(SDL_Scancode scancode, SDL_Keycode keycode)
 			handleEntryJumping(keycode);
 			return;
 		}
+
+		if (keycode == SDLK_BACKSPACE && diskOpSearchBackspace())
+			return;
 	}
 
 	if (!handleGeneralModes(keycode, scancode)) return;
@@ -745,7 +750,21 @@ void keyDownHandler(SDL_Scancode scancode, SDL_Keycode keycode)
 
 		case SDL_SCANCODE_F12:
 		{
-			if (input.keyb.leftCtrlPressed)
+			if (input.keyb.leftAltPressed && input.keyb.leftCtrlPressed)
+			{
+				if (input.keyb.shiftPressed)
+					dumpReplayerTrace();
+				else
+					toggleReplayerTrace();
+			}
+			else if (input.keyb.leftAltPressed)
+			{
+				if (input.keyb.shiftPressed)
+					dumpProfilerStats();
+				else
+					toggleProfiler();
+			}
+			else if (input.keyb.leftCtrlPressed)
 			{
 				editor.timingMode ^= 1;
 				if (editor.timingMode == TEMPO_MODE_VBLANK)
@@ -2505,6 +2524,7 @@ void keyDownHandler(SDL_Scancode scancode, SDL_Keycode keycode)
 					}
 				}
 
+				modPatternChanged(modEntry->currPattern);
 				updateWindowTitle(MOD_IS_MODIFIED);
 				editor.ui.updatePatternData = true;
 			}
@@ -3622,6 +3642,14 @@ bool handleGeneralModes(SDL_Keycode keycode, SDL_Scancode scancode)
 		return false;
 	}
 
+	// cancel module loading (the loader thread keeps going, but the module is thrown away)
+	if (editor.isModLoading && !editor.ui.askScreenShown && scancode == SDL_SCANCODE_ESCAPE)
+	{
+		abortModLoadThread();
+		statusAllRight();
+		return false;
+	}
+
 	// DISK OP. SCREEN
 	if (editor.diskop.isFilling)
 	{
@@ -3706,6 +3734,7 @@ bool handleGeneralModes(SDL_Keycode keycode, SDL_Scancode scancode)
 					*noteSrc = noteTmp;
 				}
 
+				modPatternChanged(modEntry->currPattern);
 				editor.swapChannelFlag = false;
 
 				pointerSetPreviousMode();
@@ -3724,6 +3753,7 @@ bool handleGeneralModes(SDL_Keycode keycode, SDL_Scancode scancode)
 					*noteSrc = noteTmp;
 				}
 
+				modPatternChanged(modEntry->currPattern);
 				editor.swapChannelFlag = false;
 
 				pointerSetPreviousMode();
@@ -3742,6 +3772,7 @@ bool handleGeneralModes(SDL_Keycode keycode, SDL_Scancode scancode)
 					*noteSrc = noteTmp;
 				}
 
+				modPatternChanged(modEntry->currPattern);
 				editor.swapChannelFlag = false;
 
 				pointerSetPreviousMode();
@@ -3760,6 +3791,7 @@ bool handleGeneralModes(SDL_Keycode keycode, SDL_Scancode scancode)
 					*noteSrc = noteTmp;
 				}
 
+				modPatternChanged(modEntry->currPattern);
 				editor.swapChannelFlag = false;
 
 				pointerSetPreviousMode();
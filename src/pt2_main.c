@@ -33,6 +33,10 @@
 #include "pt2_unicode.h"
 #include "pt2_scopes.h"
 #include "pt2_audio.h"
+#include "pt2_profiler.h"
+#include "pt2_spectrum.h"
+#include "pt2_cli.h"
+#include "pt2_playlist.h"
 
 #define CRASH_TEXT "Oh no!\nThe ProTracker 2 clone has crashed...\n\nA backup .mod was hopefully " \
                    "saved to the current module directory.\n\nPlease report this to 8bitbubsy " \
@@ -93,6 +97,7 @@ static void cleanUp(void);
 
 int main(int argc, char *argv[])
 {
+	uint64_t startTime64;
 #ifndef _WIN32
 	struct sigaction act, oldAct;
 #endif
@@ -101,6 +106,8 @@ int main(int argc, char *argv[])
 	SDL_version sdlVer;
 #endif
 
+	startTime64 = SDL_GetPerformanceCounter();
+
 	// for finding memory leaks in debug mode with Visual Studio
 #if defined _DEBUG && defined _MSC_VER
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
@@ -131,7 +138,12 @@ int main(int argc, char *argv[])
 	sigaction(SIGABRT, &act, &oldAct);
 	sigaction(SIGFPE, &act, &oldAct);
 	sigaction(SIGSEGV, &act, &oldAct);
+	sigaction(SIGBUS, &act, &oldAct);
+#endif
 #endif
+
+#ifndef _WIN32
+	setupMapFileFaultHandler(); // read errors of mapped module files become load errors, the rest goes to the crash handler
 #endif
 
 	// on Windows and macOS, test what version SDL2.DLL is (against library version used in compilation)
@@ -157,6 +169,18 @@ int main(int argc, char *argv[])
 	}
 #endif
 
+	// command line modes (no window or audio device, see pt2_cli.c)
+	if (argc >= 2 && isCliCommand(argv[1]))
+	{
+		int32_t result = 1;
+		if (initializeVars())
+			result = runCliCommand(argc, argv);
+
+		cleanUp();
+		SDL_Quit();
+		return result;
+	}
+
 #ifdef _WIN32
 	disableWasapi(); // disable problematic WASAPI SDL2 audio driver on Windows (causes clicks/pops sometimes...)
 #endif
@@ -237,18 +261,19 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 
-	setupSprites();
-	setupPerfFreq();
-
-	modEntry = createNewMod();
-	if (modEntry == NULL)
+	if (!setupSprites())
 	{
 		cleanUp();
 		SDL_Quit();
 		return 1;
 	}
 
-	if (!initScopes())
+	setupPerfFreq();
+	initSpectrumAnalyzer();
+	initPeriodToNoteTable();
+
+	modEntry = createNewMod();
+	if (modEntry == NULL)
 	{
 		cleanUp();
 		SDL_Quit();
@@ -290,6 +315,10 @@ int main(int argc, char *argv[])
 
 	SDL_ShowWindow(window);
 
+	// startup time report (from entering main() to showing the window)
+	printf("pt2-clone: started in %.2fms\n", (SDL_GetPerformanceCounter() - startTime64) * editor.dPerfFreqMulMicro / 1000.0);
+	fflush(stdout);
+
 	changePathToHome(); // set path to home/user-dir now
 	diskOpSetInitPath(); // set path to custom path in config (if present)
 
@@ -298,11 +327,19 @@ int main(int argc, char *argv[])
 	setupWaitVBL();
 	while (editor.programRunning)
 	{
+		profilerBegin(PROF_WHOLE_FRAME);
+
 		readMouseXY();
 		readKeyModifiers(); // set/clear CTRL/ALT/SHIFT/AMIGA key states
+
+		profilerBegin(PROF_HANDLE_INPUT);
 		handleInput();
+		profilerEnd(PROF_HANDLE_INPUT);
+
 		updateMouseCounters();
 		handleKeyRepeat(input.keyb.lastRepKey);
+		updateModLoadThread(); // swap in a module that has been loaded in the background
+		updatePlaylist();
 
 		if (!input.mouse.buttonWaiting && editor.ui.sampleMarkingPos == -1 &&
 			!editor.ui.forceSampleDrag && !editor.ui.forceVolDrag && !editor.ui.forceSampleEdit)
@@ -310,9 +347,18 @@ int main(int argc, char *argv[])
 			handleGUIButtonRepeat();
 		}
 
+		updateCompiledPatterns(); // the replayer reads the edited patterns from here on
+
 		renderFrame();
+
+		profilerBegin(PROF_FLIP_FRAME);
 		flipFrame();
+		profilerEnd(PROF_FLIP_FRAME);
+
 		sinkVisualizerBars();
+
+		profilerEnd(PROF_WHOLE_FRAME);
+		profilerEndFrame();
 	}
 
 	cleanUp();
@@ -409,6 +455,7 @@ static void handleInput(void)
 
 				editor.diskop.forceStopReading = true;
 				SDL_WaitThread(editor.diskop.fillThread, NULL);
+				editor.diskop.fillThread = NULL;
 			}
 
 			if (editor.isWAVRendering)
@@ -417,6 +464,8 @@ static void handleInput(void)
 				editor.abortMod2Wav = true;
 				SDL_WaitThread(editor.mod2WavThread, NULL);
 			}
+
+			abortModLoadThread(); // no need to wait for it
 		}
 	}
 }
@@ -844,14 +893,16 @@ static void exceptionHandler(int32_t signal)
 
 static void cleanUp(void) // never call this inside the main loop!
 {
+	playlistClear();
 	audioClose();
 	modFree();
 	deAllocSamplerVars();
 	freeDiskOpMem();
 	freeDiskOpEntryMem();
 	freeBMPs();
+	freeSprites(); // sprite textures must be destroyed before the renderer
+	freeProfiler();
 	videoClose();
-	freeSprites();
 
 	if (ptConfig.defModulesDir != NULL) free(ptConfig.defModulesDir);
 	if (ptConfig.defSamplesDir != NULL) free(ptConfig.defSamplesDir);
@@ -26,6 +26,7 @@
 #include "pt2_unicode.h"
 #include "pt2_modloader.h"
 #include "pt2_sampleloader.h"
+#include "pt2_playlist.h"
 #
 typedef struct mem_t
 {
@@ -34,19 +35,36 @@ typedef struct mem_t
 	uint32_t _cnt, _bufsiz;
 } mem_t;
 
-static bool oldAutoPlay;
+modLoadTime_t modLoadTime; // global
+
+static bool oldAutoPlay, droppedAutoPlay;
 static char oldFullPath[(PATH_MAX * 2) + 2];
 static uint32_t oldFullPathLen;
 static module_t *tempMod;
 
+// a module load. A threaded load belongs to the main thread, or to the loader thread once it's cancelled
+typedef struct modLoadJob_t
+{
+	UNICHAR *fileName;
+	void (*loadedFunc)(module_t *newMod);
+	bool showProgress, songWasModified; // songWasModified = the user already agreed to discard the song
+	volatile uint8_t stage;
+	bool done, cancelled; // protected by loadJobMutex
+	const char *errorMsg;
+	module_t *module;
+	modLoadTime_t time;
+} modLoadJob_t;
+
+static uint8_t shownLoadStage;
+static modLoadJob_t *loadJob; // the threaded load we're waiting for
+static SDL_mutex *loadJobMutex;
+
 extern SDL_Window *window;
 
-static mem_t *mopen(const uint8_t *src, uint32_t length);
-static void mclose(mem_t **buf);
+static bool mopen(mem_t *buf, const uint8_t *src, uint32_t length);
 static int32_t mgetc(mem_t *buf);
 static size_t mread(void *buffer, size_t size, size_t count, mem_t *buf);
 static void mseek(mem_t *buf, int32_t offset, int32_t whence);
-static uint8_t ppdecrunch(uint8_t *src, uint8_t *dst, uint8_t *offsetLens, uint32_t srcLen, uint32_t dstLen, uint8_t skipBits);
 
 void showSongUnsavedAskBox(int8_t askScreenType)
 {
@@ -58,108 +76,148 @@ void showSongUnsavedAskBox(int8_t askScreenType)
 	renderAskDialog();
 }
 
-bool modSave(char *fileName)
+// highest pattern number in the order list + 1
+static int32_t getModPatternCount(void)
+{
+	int32_t numPatterns = 0;
+	for (int32_t i = 0; i < MOD_ORDERS; i++)
+	{
+		if (numPatterns < modEntry->head.order[i])
+			numPatterns = modEntry->head.order[i];
+	}
+
+	if (++numPatterns > MAX_PATTERNS)
+		  numPatterns = MAX_PATTERNS;
+
+	return numPatterns;
+}
+
+static uint32_t getModSaveSize(int32_t numPatterns)
+{
+	uint32_t size = 1084 + (numPatterns * MOD_ROWS * AMIGA_VOICES * 4);
+	for (int32_t i = 0; i < MOD_SAMPLES; i++)
+		size += modEntry->samples[i].length;
+
+	return size;
+}
+
+// writes the current module as a .MOD file image to dst (see getModSaveSize())
+static void serializeMod(uint8_t *dst, int32_t numPatterns)
 {
-	int16_t tempPatternCount;
 	int32_t i;
 	uint32_t tempLoopLength, tempLoopStart, j, k;
 	note_t tmp;
-	FILE *fmodule;
-
-	tempPatternCount = 0;
-
-	fmodule = fopen(fileName, "wb");
-	if (fmodule == NULL)
-	{
-		displayErrorMsg("FILE I/O ERROR !");
-		return false;
-	}
+	moduleSample_t *s;
 
 	for (i = 0; i < 20; i++)
-		fputc(tolower(modEntry->head.moduleTitle[i]), fmodule);
+		*dst++ = (uint8_t)tolower(modEntry->head.moduleTitle[i]);
 
 	for (i = 0; i < MOD_SAMPLES; i++)
 	{
+		s = &modEntry->samples[i];
+
 		for (j = 0; j < 22; j++)
-			fputc(tolower(modEntry->samples[i].text[j]), fmodule);
+			*dst++ = (uint8_t)tolower(s->text[j]);
 
-		fputc(modEntry->samples[i].length >> 9, fmodule);
-		fputc(modEntry->samples[i].length >> 1, fmodule);
-		fputc(modEntry->samples[i].fineTune & 0x0F, fmodule);
-		fputc((modEntry->samples[i].volume > 64) ? 64 : modEntry->samples[i].volume, fmodule);
+		*dst++ = (uint8_t)(s->length >> 9);
+		*dst++ = (uint8_t)(s->length >> 1);
+		*dst++ = s->fineTune & 0x0F;
+		*dst++ = (s->volume > 64) ? 64 : s->volume;
 
-		tempLoopLength = modEntry->samples[i].loopLength;
+		tempLoopLength = s->loopLength;
 		if (tempLoopLength < 2)
 			tempLoopLength = 2;
 
-		tempLoopStart = modEntry->samples[i].loopStart;
+		tempLoopStart = s->loopStart;
 		if (tempLoopLength == 2)
 			tempLoopStart = 0;
 
-		fputc(tempLoopStart >> 9, fmodule);
-		fputc(tempLoopStart >> 1, fmodule);
-		fputc(tempLoopLength >> 9, fmodule);
-		fputc(tempLoopLength >> 1, fmodule);
+		*dst++ = (uint8_t)(tempLoopStart >> 9);
+		*dst++ = (uint8_t)(tempLoopStart >> 1);
+		*dst++ = (uint8_t)(tempLoopLength >> 9);
+		*dst++ = (uint8_t)(tempLoopLength >> 1);
 	}
 
-	fputc(modEntry->head.orderCount & 0x00FF, fmodule);
-	fputc(0x7F, fmodule); // ProTracker puts 0x7F at this place (restart pos/BPM in other trackers)
+	*dst++ = modEntry->head.orderCount & 0x00FF;
+	*dst++ = 0x7F; // ProTracker puts 0x7F at this place (restart pos/BPM in other trackers)
 
 	for (i = 0; i < MOD_ORDERS; i++)
-		fputc(modEntry->head.order[i] & 0xFF, fmodule);
-
-	tempPatternCount = 0;
-	for (i = 0; i < MOD_ORDERS; i++)
-	{
-		if (tempPatternCount < modEntry->head.order[i])
-			tempPatternCount = modEntry->head.order[i];
-	}
-
-	if (++tempPatternCount > MAX_PATTERNS)
-		  tempPatternCount = MAX_PATTERNS;
+		*dst++ = modEntry->head.order[i] & 0xFF;
 
-	fwrite((tempPatternCount <= 64) ? "M.K." : "M!K!", 1, 4, fmodule);
+	memcpy(dst, (numPatterns <= 64) ? "M.K." : "M!K!", 4);
+	dst += 4;
 
-	for (i = 0; i < tempPatternCount; i++)
+	for (i = 0; i < numPatterns; i++)
 	{
-		for (j = 0; j < MOD_ROWS; j++)
+		for (j = 0; j < MOD_ROWS * AMIGA_VOICES; j++)
 		{
-			for (k = 0; k < AMIGA_VOICES; k++)
-			{
-				tmp = modEntry->patterns[i][(j * AMIGA_VOICES) + k];
+			tmp = modEntry->patterns[i][j];
 
-				fputc((tmp.sample & 0xF0) | ((tmp.period >> 8) & 0x0F), fmodule);
-				fputc(tmp.period & 0xFF, fmodule);
-				fputc(((tmp.sample << 4) & 0xF0) | (tmp.command & 0x0F), fmodule);
-				fputc(tmp.param, fmodule);
-			}
+			*dst++ = (tmp.sample & 0xF0) | ((tmp.period >> 8) & 0x0F);
+			*dst++ = tmp.period & 0xFF;
+			*dst++ = ((tmp.sample << 4) & 0xF0) | (tmp.command & 0x0F);
+			*dst++ = tmp.param;
 		}
 	}
 
 	for (i = 0; i < MOD_SAMPLES; i++)
 	{
+		s = &modEntry->samples[i];
+
 		// Amiga ProTracker stuck "BEEP" sample fix
-		if (modEntry->samples[i].length >= 2 && modEntry->samples[i].loopStart+modEntry->samples[i].loopLength == 2)
+		if (s->length >= 2 && s->loopStart+s->loopLength == 2)
 		{
-			fputc(0, fmodule);
-			fputc(0, fmodule);
+			*dst++ = 0;
+			*dst++ = 0;
 
-			k = modEntry->samples[i].length;
+			k = s->length;
 			for (j = 2; j < k; j++)
-				fputc(modEntry->sampleData[modEntry->samples[i].offset+j], fmodule);
+				*dst++ = modEntry->sampleData[s->offset+j];
 		}
 		else
 		{
-			fwrite(&modEntry->sampleData[MAX_SAMPLE_LEN * i], 1, modEntry->samples[i].length, fmodule);
+			memcpy(dst, &modEntry->sampleData[MAX_SAMPLE_LEN * i], s->length);
+			dst += s->length;
 		}
 	}
+}
+
+/* The whole module is built in one buffer and written with writeFileAtomic(), so that
+** fileName is either the old or the new module if we crash or the disk runs full while
+** saving. This is also used for the backup module in the crash handler.
+*/
+bool modSave(char *fileName)
+{
+	int32_t numPatterns;
+	uint32_t fileSize;
+	uint8_t *fileData;
+
+	numPatterns = getModPatternCount();
+	fileSize = getModSaveSize(numPatterns);
+
+	fileData = (uint8_t *)malloc(fileSize);
+	if (fileData == NULL)
+	{
+		statusOutOfMemory();
+		return false;
+	}
+
+	serializeMod(fileData, numPatterns);
+
+	if (!writeFileAtomic(fileName, fileData, fileSize))
+	{
+		free(fileData);
+		displayErrorMsg("FILE I/O ERROR !");
+		return false;
+	}
 
-	fclose(fmodule);
+	free(fileData);
 
 	displayMsg("MODULE SAVED !");
 	setMsgPointer();
 
 	editor.diskop.cached = false;
+	editor.diskop.rescan = true;
 	if (editor.ui.diskOpScreenShown)
 		editor.ui.updateDiskOpFileList = true;
 
@@ -167,7 +225,7 @@ bool modSave(char *fileName)
 	return true;
 }
 
-static int8_t checkModType(const char *buf)
+int8_t checkModType(const char *buf)
 {
 	     if (!strncmp(buf, "M.K.", 4)) return FORMAT_MK;   // ProTracker v1.x, handled as ProTracker v2.x
 	else if (!strncmp(buf, "M!K!", 4)) return FORMAT_MK2;  // ProTracker v2.x (if >64 patterns)
@@ -208,103 +266,136 @@ static void fixZeroesInString(char *str, uint32_t maxLength)
 	}
 }
 
-module_t *modLoad(UNICHAR *fileName)
+void freeUnusedModule(module_t *m) // a module that isn't modEntry (not seen by the replayer)
+{
+	if (m == NULL)
+		return;
+
+	for (int32_t i = 0; i < MAX_PATTERNS; i++)
+	{
+		if (m->patterns[i] != NULL)
+			free(m->patterns[i]);
+
+		if (m->events[i] != NULL)
+			free(m->events[i]);
+	}
+
+	if (m->sampleData != NULL)
+		free(m->sampleData);
+
+	free(m);
+}
+
+// runs on the loader thread too, so errors are returned in the job instead of being shown here
+static module_t *loadModule(modLoadJob_t *job)
 {
 	bool mightBeSTK, lateSTKVerFlag, veryLateSTKVerFlag;
 	char modSig[4], tmpChar;
 	int8_t numSamples;
-	uint8_t ppCrunchData[4], bytes[4], *ppBuffer;
-	uint8_t *modBuffer, ch, row, pattern, channels;
+	uint8_t bytes[4], ch, row, pattern, channels;
+	uint8_t *volatile modBuffer; // volatile: it's freed after a read error (longjmp) of the mapped file
 	uint16_t ciaPeriod;
 	int32_t i, loopStart, loopLength, loopOverflowVal;
 	uint32_t j, PP20, ppPackLen, ppUnpackLen;
-	FILE *fmodule;
+	uint64_t time64, readTime64;
+	double dPerfFreqMulMs;
+	const uint8_t *modData, *ppCrunchData;
 	module_t *newModule;
 	moduleSample_t *s;
 	note_t *note;
-	mem_t *mod;
+	mappedFile_t file;
+	mem_t modMem, *mod;
+#ifndef _WIN32
+	sigjmp_buf faultJump;
+#endif
 
-	/* these flags are kinda dumb and inaccurate, but we
-	** don't aim for excellent STK import anyway. */
-	veryLateSTKVerFlag = false; // "DFJ SoundTracker III" nad later
-	lateSTKVerFlag = false; // "TJC SoundTracker II" and later
-	mightBeSTK = false;
+	time64 = SDL_GetPerformanceCounter();
 
 	mod = NULL;
-	ppBuffer = NULL;
 	modBuffer = NULL;
-	fmodule = NULL;
 	newModule = NULL;
+	file.data = NULL;
 
 	newModule = (module_t *)calloc(1, sizeof (module_t));
 	if (newModule == NULL)
 	{
-		statusOutOfMemory();
+		job->errorMsg = "OUT OF MEMORY !!!";
 		goto modLoadError;
 	}
 
-	fmodule = UNICHAR_FOPEN(fileName, "rb");
-	if (fmodule == NULL)
+	// the file is parsed where it's mapped, only PowerPacked files need a buffer (to decrunch to)
+	if (!mapFile(job->fileName, &file))
 	{
-		displayErrorMsg("FILE I/O ERROR !");
+		job->errorMsg = "FILE I/O ERROR !";
 		goto modLoadError;
 	}
 
-	fseek(fmodule, 0, SEEK_END);
-	newModule->head.moduleSize = ftell(fmodule);
-	fseek(fmodule, 0, SEEK_SET);
+#ifndef _WIN32
+	// the file was truncated or couldn't be read while it was parsed (SIGBUS, see mapFileGuard())
+	if (sigsetjmp(faultJump, 1) != 0)
+	{
+		job->errorMsg = "FILE I/O ERROR !";
+		goto modLoadError;
+	}
+
+	mapFileGuard(&file, &faultJump);
+#endif
+
+	/* these flags are kinda dumb and inaccurate, but we
+	** don't aim for excellent STK import anyway. */
+	veryLateSTKVerFlag = false; // "DFJ SoundTracker III" nad later
+	lateSTKVerFlag = false; // "TJC SoundTracker II" and later
+	mightBeSTK = false;
+
+	newModule->head.moduleSize = file.length;
+	modData = file.data;
 
 	// check if mod is a powerpacker mod
-	fread(&PP20, 4, 1, fmodule);
+	PP20 = 0;
+	if (file.length >= 4)
+		memcpy(&PP20, file.data, 4);
+
 	if (PP20 == 0x30325850) // "PX20"
 	{
-		displayErrorMsg("ENCRYPTED PPACK !");
+		job->errorMsg = "ENCRYPTED PPACK !";
 		goto modLoadError;
 	}
 	else if (PP20 == 0x30325050) // "PP20"
 	{
-		ppPackLen = newModule->head.moduleSize;
-		if (ppPackLen & 3)
+		ppPackLen = file.length;
+		if ((ppPackLen & 3) || ppPackLen < 12)
 		{
-			displayErrorMsg("POWERPACKER ERROR");
+			job->errorMsg = "POWERPACKER ERROR";
 			goto modLoadError;
 		}
 
-		fseek(fmodule, ppPackLen - 4, SEEK_SET);
-
-		ppCrunchData[0] = (uint8_t)fgetc(fmodule);
-		ppCrunchData[1] = (uint8_t)fgetc(fmodule);
-		ppCrunchData[2] = (uint8_t)fgetc(fmodule);
-		ppCrunchData[3] = (uint8_t)fgetc(fmodule);
-
+		ppCrunchData = &file.data[ppPackLen - 4];
 		ppUnpackLen = (ppCrunchData[0] << 16) | (ppCrunchData[1] << 8) | ppCrunchData[2];
 
 		// smallest and biggest possible .MOD
 		if (ppUnpackLen < 2108 || ppUnpackLen > 4195326)
 		{
-			displayErrorMsg("NOT A MOD FILE !");
+			job->errorMsg = "NOT A MOD FILE !";
 			goto modLoadError;
 		}
 
-		ppBuffer = (uint8_t *)malloc(ppPackLen);
-		if (ppBuffer == NULL)
+		modBuffer = (uint8_t *)malloc(ppUnpackLen);
+		if (modBuffer == NULL)
 		{
-			statusOutOfMemory();
+			job->errorMsg = "OUT OF MEMORY !!!";
 			goto modLoadError;
 		}
 
-		modBuffer = (uint8_t *)malloc(ppUnpackLen);
-		if (modBuffer == NULL)
+		job->stage = MOD_LOAD_STAGE_DECRUNCHING;
+		if (!ppdecrunch(file.data + 8, modBuffer, file.data + 4, ppPackLen - 12, ppUnpackLen, ppCrunchData[3]))
 		{
-			statusOutOfMemory();
+			job->errorMsg = "POWERPACKER ERROR";
 			goto modLoadError;
 		}
 
-		fseek(fmodule, 0, SEEK_SET);
-		fread(ppBuffer, 1, ppPackLen, fmodule);
-		fclose(fmodule);
-		ppdecrunch(ppBuffer + 8, modBuffer, ppBuffer + 4, ppPackLen - 12, ppUnpackLen, ppCrunchData[3]);
-		free(ppBuffer);
+		unmapFile(&file);
+
+		modData = modBuffer;
 		newModule->head.moduleSize = ppUnpackLen;
 	}
 	else
@@ -312,28 +403,20 @@ module_t *modLoad(UNICHAR *fileName)
 		// smallest and biggest possible PT .MOD
 		if (newModule->head.moduleSize < 2108 || newModule->head.moduleSize > 4195326)
 		{
-			displayErrorMsg("NOT A MOD FILE !");
+			job->errorMsg = "NOT A MOD FILE !";
 			goto modLoadError;
 		}
-
-		modBuffer = (uint8_t *)malloc(newModule->head.moduleSize);
-		if (modBuffer == NULL)
-		{
-			statusOutOfMemory();
-			goto modLoadError;
-		}
-
-		fseek(fmodule, 0, SEEK_SET);
-		fread(modBuffer, 1, newModule->head.moduleSize, fmodule);
-		fclose(fmodule);
 	}
 
-	mod = mopen(modBuffer, newModule->head.moduleSize);
-	if (mod == NULL)
+	readTime64 = SDL_GetPerformanceCounter();
+	job->stage = MOD_LOAD_STAGE_PARSING;
+
+	if (!mopen(&modMem, modData, newModule->head.moduleSize))
 	{
-		displayErrorMsg("FILE I/O ERROR !");
+		job->errorMsg = "FILE I/O ERROR !";
 		goto modLoadError;
 	}
+	mod = &modMem;
 
 	// check module tag
 	mseek(mod, 0x0438, SEEK_SET);
@@ -485,7 +568,7 @@ module_t *modLoad(UNICHAR *fileName)
 	{
 		if (newModule->head.orderCount > 129)
 		{
-			displayErrorMsg("NOT A MOD FILE !");
+			job->errorMsg = "NOT A MOD FILE !";
 			goto modLoadError;
 		}
 
@@ -494,14 +577,14 @@ module_t *modLoad(UNICHAR *fileName)
 
 	if (newModule->head.orderCount == 0)
 	{
-		displayErrorMsg("NOT A MOD FILE !");
+		job->errorMsg = "NOT A MOD FILE !";
 		goto modLoadError;
 	}
 
 	newModule->head.restartPos = (uint8_t)mgetc(mod);
 	if (mightBeSTK && (newModule->head.restartPos == 0 || newModule->head.restartPos > 220))
 	{
-		displayErrorMsg("NOT A MOD FILE !");
+		job->errorMsg = "NOT A MOD FILE !";
 		goto modLoadError;
 	}
 
@@ -535,7 +618,7 @@ module_t *modLoad(UNICHAR *fileName)
 
 	if (++newModule->head.patternCount > MAX_PATTERNS)
 	{
-		displayErrorMsg("UNSUPPORTED MOD !");
+		job->errorMsg = "UNSUPPORTED MOD !";
 		goto modLoadError;
 	}
 
@@ -546,9 +629,10 @@ module_t *modLoad(UNICHAR *fileName)
 	for (pattern = 0; pattern < MAX_PATTERNS; pattern++)
 	{
 		newModule->patterns[pattern] = (note_t *)calloc(MOD_ROWS * AMIGA_VOICES, sizeof (note_t));
-		if (newModule->patterns[pattern] == NULL)
+		newModule->events[pattern] = (cellEvent_t *)malloc(MOD_ROWS * AMIGA_VOICES * sizeof (cellEvent_t));
+		if (newModule->patterns[pattern] == NULL || newModule->events[pattern] == NULL)
 		{
-			statusOutOfMemory();
+			job->errorMsg = "OUT OF MEMORY !!!";
 			goto modLoadError;
 		}
 	}
@@ -690,7 +774,7 @@ module_t *modLoad(UNICHAR *fileName)
 	newModule->sampleData = (int8_t *)calloc(MOD_SAMPLES + 1, MAX_SAMPLE_LEN); // +1 sample slot for overflow safety (scopes etc)
 	if (newModule->sampleData == NULL)
 	{
-		statusOutOfMemory();
+		job->errorMsg = "OUT OF MEMORY !!!";
 		goto modLoadError;
 	}
 
@@ -714,31 +798,223 @@ module_t *modLoad(UNICHAR *fileName)
 		}
 	}
 
-	mclose(&mod);
-	free(modBuffer);
+	job->time.mapped = file.mapped;
+	job->time.packed = (modBuffer != NULL);
+
+	unmapFile(&file);
+	if (modBuffer != NULL)
+		free(modBuffer);
 
 	for (i = 0; i < AMIGA_VOICES; i++)
 		newModule->channels[i].n_chanindex = i;
 
+	compilePatterns(newModule);
+
+	dPerfFreqMulMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+	job->time.dReadMs = (readTime64 - time64) * dPerfFreqMulMs;
+	job->time.dParseMs = (SDL_GetPerformanceCounter() - readTime64) * dPerfFreqMulMs;
+
 	return newModule;
 
 modLoadError:
-	if (mod != NULL) mclose(&mod);
+	unmapFile(&file);
 	if (modBuffer != NULL) free(modBuffer);
-	if (ppBuffer != NULL) free(ppBuffer);
 
-	if (newModule != NULL)
+	freeUnusedModule(newModule);
+	return NULL;
+}
+
+module_t *modLoad(UNICHAR *fileName)
+{
+	modLoadJob_t job;
+
+	memset(&job, 0, sizeof (job));
+	job.fileName = fileName;
+
+	job.module = loadModule(&job);
+	if (job.module == NULL)
 	{
-		for (i = 0; i < MAX_PATTERNS; i++)
+		displayErrorMsg(job.errorMsg);
+		return NULL;
+	}
+
+	modLoadTime = job.time;
+	return job.module;
+}
+
+static void freeLoadJob(modLoadJob_t *job)
+{
+	freeUnusedModule(job->module);
+	free(job->fileName);
+	free(job);
+}
+
+static void finishLoadJob(modLoadJob_t *job)
+{
+	if (job->module == NULL)
+	{
+		if (job->showProgress)
+			displayErrorMsg(job->errorMsg);
+		else
+			job->loadedFunc(NULL);
+	}
+	else
+	{
+		modLoadTime = job->time;
+
+		job->loadedFunc(job->module); // takes over the module
+		job->module = NULL;
+	}
+
+	freeLoadJob(job);
+}
+
+static int32_t SDLCALL modLoadThreadFunc(void *ptr)
+{
+	bool cancelled;
+	modLoadJob_t *job = (modLoadJob_t *)ptr;
+
+	job->module = loadModule(job);
+
+	SDL_LockMutex(loadJobMutex);
+	job->done = true;
+	cancelled = job->cancelled;
+	SDL_UnlockMutex(loadJobMutex);
+
+	// if the load was cancelled, nobody is waiting for the module anymore
+	if (cancelled)
+		freeLoadJob(job);
+
+	return true;
+}
+
+void modLoadThreaded(UNICHAR *fileName, void (*loadedFunc)(module_t *newMod), bool showProgress)
+{
+	size_t nameSize;
+	modLoadJob_t *job;
+	SDL_Thread *thread;
+
+	abortModLoadThread(); // a new load replaces the one that is still going on
+
+	job = (modLoadJob_t *)calloc(1, sizeof (modLoadJob_t));
+	if (job == NULL)
+	{
+		statusOutOfMemory();
+		return;
+	}
+
+	nameSize = (UNICHAR_STRLEN(fileName) + 1) * sizeof (UNICHAR);
+	job->fileName = (UNICHAR *)malloc(nameSize);
+	if (job->fileName == NULL)
+	{
+		free(job);
+		statusOutOfMemory();
+		return;
+	}
+
+	memcpy(job->fileName, fileName, nameSize);
+	job->loadedFunc = loadedFunc;
+	job->showProgress = showProgress;
+	job->songWasModified = modEntry->modified;
+
+	if (loadJobMutex == NULL)
+		loadJobMutex = SDL_CreateMutex();
+
+	thread = NULL;
+	if (loadJobMutex != NULL)
+		thread = SDL_CreateThread(modLoadThreadFunc, NULL, job);
+
+	if (thread == NULL)
+	{
+		// couldn't start a thread, load it right away instead
+		job->module = loadModule(job);
+		finishLoadJob(job);
+		return;
+	}
+
+	SDL_DetachThread(thread);
+
+	loadJob = job;
+	shownLoadStage = MOD_LOAD_STAGE_READING;
+
+	if (showProgress)
+	{
+		editor.isModLoading = true;
+		setStatusMessage("LOADING MODULE", NO_CARRY);
+	}
+}
+
+// a loaded module isn't swapped in while one of these is going on
+static bool trackerIsBusy(void)
+{
+	return editor.ui.pointerMode == POINTER_MODE_MSG1 || editor.ui.askScreenShown || editor.isWAVRendering || editor.isSMPRendering ||
+		editor.ui.editTextFlag || editor.ui.samplerFiltersBoxShown || editor.ui.samplerVolBoxShown;
+}
+
+void updateModLoadThread(void)
+{
+	bool done;
+	modLoadJob_t *job = loadJob;
+
+	if (job == NULL)
+		return;
+
+	SDL_LockMutex(loadJobMutex);
+	done = job->done;
+	SDL_UnlockMutex(loadJobMutex);
+
+	if (!done)
+	{
+		if (job->showProgress && job->stage != shownLoadStage)
 		{
-			if (newModule->patterns[i] != NULL)
-				free(newModule->patterns[i]);
+			shownLoadStage = job->stage;
+			if (shownLoadStage == MOD_LOAD_STAGE_DECRUNCHING)
+				setStatusMessage("DECRUNCHING", NO_CARRY);
+			else if (shownLoadStage == MOD_LOAD_STAGE_PARSING)
+				setStatusMessage("PARSING MODULE", NO_CARRY);
 		}
 
-		free(newModule);
+		return;
 	}
 
-	return NULL;
+	if (job->showProgress && job->module != NULL)
+	{
+		if (trackerIsBusy())
+			return; // try again on the next frame
+
+		if (modEntry->modified && !job->songWasModified)
+		{
+			// the song was edited while the new one was loading
+			job->songWasModified = true;
+			showSongUnsavedAskBox(ASK_DISCARD_LOADED_SONG); // "no" calls abortModLoadThread()
+			return;
+		}
+	}
+
+	loadJob = NULL;
+	editor.isModLoading = false;
+
+	finishLoadJob(job);
+}
+
+void abortModLoadThread(void)
+{
+	bool done;
+
+	if (loadJob == NULL)
+		return;
+
+	SDL_LockMutex(loadJobMutex);
+	loadJob->cancelled = true;
+	done = loadJob->done;
+	SDL_UnlockMutex(loadJobMutex);
+
+	// if the thread isn't done yet, it frees the job itself
+	if (done)
+		freeLoadJob(loadJob);
+
+	loadJob = NULL;
+	editor.isModLoading = false;
 }
 
 bool saveModule(bool checkIfFileExist, bool giveNewFreeFilename)
@@ -856,33 +1132,18 @@ bool saveModule(bool checkIfFileExist, bool giveNewFreeFilename)
 	return modSave(fileName);
 }
 
-static mem_t *mopen(const uint8_t *src, uint32_t length)
+static bool mopen(mem_t *buf, const uint8_t *src, uint32_t length)
 {
-	mem_t *b;
-
 	if (src == NULL || length == 0)
-		return NULL;
-
-	b = (mem_t *)malloc(sizeof (mem_t));
-	if (b == NULL)
-		return NULL;
-
-	b->_base = (uint8_t *)src;
-	b->_ptr = (uint8_t *)src;
-	b->_cnt = length;
-	b->_bufsiz = length;
-	b->_eof = false;
+		return false;
 
-	return b;
-}
+	buf->_base = (uint8_t *)src;
+	buf->_ptr = (uint8_t *)src;
+	buf->_cnt = length;
+	buf->_bufsiz = length;
+	buf->_eof = false;
 
-static void mclose(mem_t **buf)
-{
-	if (*buf != NULL)
-	{
-		free(*buf);
-		*buf = NULL;
-	}
+	return true;
 }
 
 static int32_t mgetc(mem_t *buf)
@@ -961,70 +1222,157 @@ static void mseek(mem_t *buf, int32_t offset, int32_t whence)
 	}
 }
 
-/* Code taken from Heikki Orsila's amigadepack. Seems to have no license,
-** so I'll assume it fits into wtfpl (wtfpl.net). Heikki should contact me
-** if it shall not.
-** Modified by 8bitbubsy */
-
-#define PP_READ_BITS(nbits, var)            \
-  bitCnt = (nbits);                         \
-  while (bitsLeft < bitCnt) {               \
-	if (bufSrc < src) return false;         \
-	bitBuffer |= (*--bufSrc << bitsLeft);   \
-	bitsLeft += 8;                          \
-  }                                         \
-  (var) = 0;                                \
-  bitsLeft -= bitCnt;                       \
-  while (bitCnt--) {                        \
-	(var) = ((var) << 1) | (bitBuffer & 1); \
-	bitBuffer >>= 1;                        \
-  }                                         \
-
-static uint8_t ppdecrunch(uint8_t *src, uint8_t *dst, uint8_t *offsetLens, uint32_t srcLen, uint32_t dstLen, uint8_t skipBits)
+/* PowerPacker decruncher, based on the one in Heikki Orsila's amigadepack (no license,
+** so I'll assume it fits into wtfpl (wtfpl.net). Heikki should contact me if it shall not).
+**
+** The packed stream is read backwards, and the output is written backwards too. Bits are
+** taken from a 64-bit buffer that is refilled 32 bits at a time. PowerPacker values are
+** stored MSB first in the bit order we read them in, so they're bit-reversed with a table.
+** Literal run lengths and long match lengths are decoded a few fields at a time with
+** tables. Every read and write is bounds checked, a broken file only makes it fail.
+*/
+
+#define R2(n) n, n + 2*64, n + 1*64, n + 3*64
+#define R4(n) R2(n), R2(n + 2*16), R2(n + 1*16), R2(n + 3*16)
+#define R6(n) R4(n), R4(n + 2*4), R4(n + 1*4), R4(n + 3*4)
+static const uint8_t bitReverse[256] = { R6(0), R6(2), R6(1), R6(3) };
+#undef R2
+#undef R4
+#undef R6
+
+/* Literal run length: 2-bit fields that are added until one isn't 3. Indexed by the next
+** 8 bits of the buffer, gives (bits used << 4) | sum of the fields. All ones = keep going.
+*/
+static const uint8_t ppLiteralRunTable[256] =
 {
-	uint8_t *bufSrc, *dstEnd, *out, bitsLeft, bitCnt;
-	uint32_t x, todo, offBits, offset, written, bitBuffer;
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x66,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x68,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x67,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x89,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x66,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x68,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x67,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x8B,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x66,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x68,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x67,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x8A,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x66,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x68,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x67,
+	0x20, 0x22, 0x21, 0x43, 0x20, 0x22, 0x21, 0x45, 0x20, 0x22, 0x21, 0x44, 0x20, 0x22, 0x21, 0x8C
+};
+
+// long match length: the same with 3-bit fields (until one isn't 7), indexed by the next 6 bits
+static const uint8_t ppMatchLenTable[64] =
+{
+	0x30, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0x67, 0x30, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0x6B,
+	0x30, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0x69, 0x30, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0x6D,
+	0x30, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0x68, 0x30, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0x6C,
+	0x30, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0x6A, 0x30, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0x6E
+};
+
+#define PP_REFILL \
+	if (bitsLeft < 32) \
+	{ \
+		if (bufSrc-src >= 4) \
+		{ \
+			bufSrc -= 4; \
+			bitBuffer |= (uint64_t)(((uint32_t)bufSrc[0] << 24) | ((uint32_t)bufSrc[1] << 16) | ((uint32_t)bufSrc[2] << 8) | bufSrc[3]) << bitsLeft; \
+			bitsLeft += 32; \
+		} \
+		else \
+		{ \
+			while (bufSrc > src && bitsLeft <= 56) \
+			{ \
+				bitBuffer |= (uint64_t)*--bufSrc << bitsLeft; \
+				bitsLeft += 8; \
+			} \
+		} \
+	}
 
-	if (src == NULL || dst == NULL || offsetLens == NULL)
+// reads nbits (max 32) as they are in the buffer (not reversed), returns false if the stream ends
+#define PP_READ_RAW(nbits, var) \
+	if (bitsLeft < (nbits)) \
+	{ \
+		PP_REFILL \
+		if (bitsLeft < (nbits)) \
+			return false; \
+	} \
+	(var) = (uint32_t)bitBuffer & (uint32_t)((1ULL << (nbits)) - 1); \
+	bitBuffer >>= (nbits); \
+	bitsLeft -= (nbits);
+
+// reads a value of up to 16 bits
+#define PP_READ_BITS(nbits, var) \
+	PP_READ_RAW(nbits, var) \
+	(var) = (((uint32_t)bitReverse[(var) & 0xFF] << 8) | bitReverse[(var) >> 8]) >> (16 - (nbits));
+
+bool ppdecrunch(const uint8_t *src, uint8_t *dst, const uint8_t *offsetLens, uint32_t srcLen, uint32_t dstLen, uint8_t skipBits)
+{
+	uint8_t entry, offBits;
+	uint32_t x, i, todo, offset, bitsLeft;
+	uint64_t bitBuffer;
+	const uint8_t *bufSrc;
+	uint8_t *out, *dstEnd;
+
+	if (src == NULL || dst == NULL || offsetLens == NULL || skipBits > 32)
 		return false;
 
+	for (i = 0; i < 4; i++)
+	{
+		if (offsetLens[i] > 16)
+			return false;
+	}
+
 	bitsLeft = 0;
 	bitBuffer = 0;
-	written = 0;
 	bufSrc = src + srcLen;
 	out = dst + dstLen;
 	dstEnd = out;
 
-	PP_READ_BITS(skipBits, x);
-	while (written < dstLen)
+	PP_READ_RAW(skipBits, x);
+	while (out > dst)
 	{
-		PP_READ_BITS(1, x);
+		PP_READ_RAW(1, x);
 		if (x == 0)
 		{
+			// literal run
 			todo = 1;
-
 			do
 			{
-				PP_READ_BITS(2, x);
-				todo += x;
+				PP_REFILL
+				if (bitsLeft >= 8)
+				{
+					x = (uint32_t)bitBuffer & 0xFF;
+					entry = ppLiteralRunTable[x];
+					bitBuffer >>= entry >> 4;
+					bitsLeft -= entry >> 4;
+					todo += entry & 0x0F;
+					x = (x == 0xFF) ? 3 : 0; // all fields were 3, keep going
+				}
+				else
+				{
+					PP_READ_BITS(2, x);
+					todo += x;
+				}
 			}
 			while (x == 3);
 
+			if (todo > (uint32_t)(out - dst))
+				return false;
+
 			while (todo--)
 			{
-				PP_READ_BITS(8, x);
-
-				if (out <= dst)
-					return false;
-
-				*--out = (uint8_t)x;
-				written++;
+				PP_READ_RAW(8, x);
+				*--out = bitReverse[x];
 			}
 
-			if (written == dstLen)
+			if (out == dst)
 				break;
 		}
 
+		// match
 		PP_READ_BITS(2, x);
 
 		offBits = offsetLens[x];
@@ -1032,41 +1380,58 @@ static uint8_t ppdecrunch(uint8_t *src, uint8_t *dst, uint8_t *offsetLens, uint3
 
 		if (x == 3)
 		{
-			PP_READ_BITS(1, x);
-			if (x == 0) offBits = 7;
+			PP_READ_RAW(1, x);
+			if (x == 0)
+				offBits = 7;
 
-			PP_READ_BITS((uint8_t)offBits, offset);
+			PP_READ_BITS(offBits, offset);
 			do
 			{
-				PP_READ_BITS(3, x);
-				todo += x;
+				PP_REFILL
+				if (bitsLeft >= 6)
+				{
+					x = (uint32_t)bitBuffer & 0x3F;
+					entry = ppMatchLenTable[x];
+					bitBuffer >>= entry >> 4;
+					bitsLeft -= entry >> 4;
+					todo += entry & 0x0F;
+					x = (x == 0x3F) ? 7 : 0; // all fields were 7, keep going
+				}
+				else
+				{
+					PP_READ_BITS(3, x);
+					todo += x;
+				}
 			}
 			while (x == 7);
 		}
 		else
 		{
-			PP_READ_BITS((uint8_t)offBits, offset);
+			PP_READ_BITS(offBits, offset);
 		}
 
-		if (out+offset >= dstEnd)
+		// the source is offset+1 bytes ahead, in what's already been written
+		if (offset >= (uint32_t)(dstEnd - out) || todo > (uint32_t)(out - dst))
 			return false;
 
-		while (todo--)
+		out -= todo;
+		if (offset+1 >= todo)
 		{
-			x = out[offset];
-
-			if (out <= dst)
-				return false;
-
-			*--out = (uint8_t)x;
-			written++;
+			memcpy(out, out + offset + 1, todo);
+		}
+		else
+		{
+			// overlapping, this repeats the last offset+1 bytes
+			for (i = todo; i-- > 0;)
+				out[i] = out[i + offset + 1];
 		}
 	}
 
 	return true;
 }
 
-void setupNewMod(void)
+// editor and GUI state for a new modEntry. Doesn't touch the replayer, the playlist calls this while playing
+void setupNewModEditor(void)
 {
 	int8_t i;
 
@@ -1081,9 +1446,6 @@ void setupNewMod(void)
 		fillSampleRedoBuffer(i);
 	}
 
-	modSetPos(0, 0);
-	modSetPattern(0); // set pattern to 00 instead of first order's pattern
-
 	editor.currEditPatternDisp = &modEntry->currPattern;
 	editor.currPosDisp = &modEntry->currOrder;
 	editor.currPatternDisp = &modEntry->head.order[0];
@@ -1100,26 +1462,35 @@ void setupNewMod(void)
 
 	editor.editMoveAdd = 1;
 	editor.currSample = 0;
-	editor.musicTime = 0;
 	editor.modLoaded = true;
 	editor.blockMarkFlag = false;
 	editor.sampleZero = false;
 	editor.keypadSampleOffset = 0;
 
-	setLEDFilter(false); // real PT doesn't do this, but that's insane
-
 	updateWindowTitle(MOD_NOT_MODIFIED);
 
+	invalidateSamplePeaks(); // the new sample data may be at the same address as the old
+	updateCurrSample();
+	editor.samplePos = 0;
+	updateSamplePos();
+}
+
+void setupNewMod(void)
+{
+	setupNewModEditor();
+
+	modSetPos(0, 0);
+	modSetPattern(0); // set pattern to 00 instead of first order's pattern
+
+	editor.musicTime = 0;
+	setLEDFilter(false); // real PT doesn't do this, but that's insane
+
 	modSetSpeed(6);
 
 	if (modEntry->head.initBPM > 0)
 		modSetTempo(modEntry->head.initBPM);
 	else
 		modSetTempo(125);
-
-	updateCurrSample();
-	editor.samplePos = 0;
-	updateSamplePos();
 }
 
 void loadModFromArg(char *arg)
@@ -1145,6 +1516,19 @@ void loadModFromArg(char *arg)
 	strcpy(filenameU, arg);
 #endif
 
+	if (isPlaylistFile(filenameU))
+	{
+		// starts playing when the first module has been loaded
+		playlistClear();
+		if (playlistAddM3U(filenameU))
+			playlistStart(0);
+		else
+			displayErrorMsg("FILE I/O ERROR !");
+
+		free(filenameU);
+		return;
+	}
+
 	tempMod = modLoad(filenameU);
 	if (tempMod != NULL)
 	{
@@ -1196,11 +1580,61 @@ static bool testExtension(char *ext, uint8_t extLen, char *fullPath)
 	return false;
 }
 
+static void droppedModLoaded(module_t *newMod)
+{
+	uint8_t oldMode, oldPlayMode;
+
+	oldMode = editor.currMode;
+	oldPlayMode = editor.playMode;
+
+	modStop();
+	modFree();
+
+	modEntry = newMod;
+	setupNewMod();
+	modEntry->moduleLoaded = true;
+
+	statusAllRight();
+
+	if (droppedAutoPlay)
+	{
+		// start normal playback
+		editor.playMode = PLAY_MODE_NORMAL;
+		modPlay(DONT_SET_PATTERN, 0, 0);
+		editor.currMode = MODE_PLAY;
+		pointerSetMode(POINTER_MODE_PLAY, DO_CARRY);
+	}
+	else if ((oldMode == MODE_PLAY) || (oldMode == MODE_RECORD))
+	{
+		// use last mode
+		editor.playMode = oldPlayMode;
+		if ((oldPlayMode == PLAY_MODE_PATTERN) || (oldMode == MODE_RECORD))
+			modPlay(0, 0, 0);
+		else
+			modPlay(DONT_SET_PATTERN, 0, 0);
+		editor.currMode = oldMode;
+
+		if (oldMode == MODE_RECORD)
+			pointerSetMode(POINTER_MODE_RECORD, DO_CARRY);
+		else
+			pointerSetMode(POINTER_MODE_PLAY, DO_CARRY);
+	}
+	else
+	{
+		// stop playback
+		editor.playMode = PLAY_MODE_NORMAL;
+		editor.currMode = MODE_IDLE;
+		editor.songPlaying = false;
+		pointerSetMode(POINTER_MODE_IDLE, DO_CARRY);
+	}
+
+	displayMainScreen();
+}
+
 void loadDroppedFile(char *fullPath, uint32_t fullPathLen, bool autoPlay, bool songModifiedCheck)
 {
-	bool isMod;
+	bool isMod, isPlaylist;
 	char *fileName, *ansiName;
-	uint8_t oldMode, oldPlayMode;
 	UNICHAR *fullPathU;
 
 	// don't allow drag n' drop if the tracker is busy
@@ -1250,7 +1684,8 @@ void loadDroppedFile(char *fullPath, uint32_t fullPathLen, bool autoPlay, bool s
 	else if (testExtension("PP",  2, fileName)) isMod = true;
 	else if (testExtension("NT",  2, fileName)) isMod = true;
 
-	if (isMod)
+	isPlaylist = isPlaylistFile(fullPathU);
+	if (isMod || isPlaylist)
 	{
 		if (songModifiedCheck && modEntry->modified)
 		{
@@ -1272,61 +1707,19 @@ void loadDroppedFile(char *fullPath, uint32_t fullPathLen, bool autoPlay, bool s
 			return;
 		}
 
-		tempMod = modLoad(fullPathU);
-		if (tempMod != NULL)
+		if (isPlaylist)
 		{
-			oldMode = editor.currMode;
-			oldPlayMode = editor.playMode;
-
-			modStop();
-			modFree();
-
-			modEntry = tempMod;
-			setupNewMod();
-			modEntry->moduleLoaded = true;
-
-			statusAllRight();
-
-			if (autoPlay)
-			{
-				// start normal playback
-				editor.playMode = PLAY_MODE_NORMAL;
-				modPlay(DONT_SET_PATTERN, 0, 0);
-				editor.currMode = MODE_PLAY;
-				pointerSetMode(POINTER_MODE_PLAY, DO_CARRY);
-			}
-			else if ((oldMode == MODE_PLAY) || (oldMode == MODE_RECORD))
-			{
-				// use last mode
-				editor.playMode = oldPlayMode;
-				if ((oldPlayMode == PLAY_MODE_PATTERN) || (oldMode == MODE_RECORD))
-					modPlay(0, 0, 0);
-				else
-					modPlay(DONT_SET_PATTERN, 0, 0);
-				editor.currMode = oldMode;
-
-				if (oldMode == MODE_RECORD)
-					pointerSetMode(POINTER_MODE_RECORD, DO_CARRY);
-				else
-					pointerSetMode(POINTER_MODE_PLAY, DO_CARRY);
-			}
+			playlistClear();
+			if (playlistAddM3U(fullPathU))
+				playlistStart(0);
 			else
-			{
-				// stop playback
-				editor.playMode = PLAY_MODE_NORMAL;
-				editor.currMode = MODE_IDLE;
-				editor.songPlaying = false;
-				pointerSetMode(POINTER_MODE_IDLE, DO_CARRY);
-			}
-
-			displayMainScreen();
+				displayErrorMsg("FILE I/O ERROR !");
 		}
 		else
 		{
-			editor.errorMsgActive = true;
-			editor.errorMsgBlock = true;
-			editor.errorMsgCounter = 0;
-			setErrPointer(); // status/error message is set in the mod loader
+			playlistStop(); // loading a module by hand ends the playlist
+			droppedAutoPlay = autoPlay;
+			modLoadThreaded(fullPathU, droppedModLoaded, true);
 		}
 	}
 	else
@@ -1355,7 +1748,8 @@ module_t *createNewMod(void)
 	for (i = 0; i < MAX_PATTERNS; i++)
 	{
 		newMod->patterns[i] = (note_t *)calloc(1, MOD_ROWS * sizeof (note_t) * AMIGA_VOICES);
-		if (newMod->patterns[i] == NULL)
+		newMod->events[i] = (cellEvent_t *)malloc(MOD_ROWS * AMIGA_VOICES * sizeof (cellEvent_t));
+		if (newMod->patterns[i] == NULL || newMod->events[i] == NULL)
 			goto oom;
 	}
 
@@ -1381,6 +1775,8 @@ module_t *createNewMod(void)
 	for (i = 0; i < AMIGA_VOICES; i++)
 		newMod->channels[i].n_chanindex = i;
 
+	compilePatterns(newMod);
+
 	// setup GUI text pointers
 	editor.currEditPatternDisp = &newMod->currPattern;
 	editor.currPosDisp = &newMod->currOrder;
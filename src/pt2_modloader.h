@@ -5,6 +5,23 @@
 #include "pt2_header.h"
 #include "pt2_unicode.h"
 
+// how long the last successful modLoad() took
+typedef struct modLoadTime_t
+{
+	bool mapped, packed;
+	double dReadMs, dParseMs; // file access (and decrunching), then parsing and copying. Mapped files are read while parsing
+} modLoadTime_t;
+
+extern modLoadTime_t modLoadTime; // pt2_modloader.c
+
+// what a threaded module load is doing (shown in the status bar)
+enum
+{
+	MOD_LOAD_STAGE_READING = 0,
+	MOD_LOAD_STAGE_DECRUNCHING = 1,
+	MOD_LOAD_STAGE_PARSING = 2
+};
+
 void showSongUnsavedAskBox(int8_t askScreenType);
 void loadModFromArg(char *arg);
 void loadDroppedFile(char *fullPath, uint32_t fullPathLen, bool autoPlay, bool songModifiedCheck);
@@ -13,4 +30,11 @@ module_t *createNewMod(void);
 bool saveModule(bool checkIfFileExist, bool giveNewFreeFilename);
 bool modSave(char *fileName);
 module_t *modLoad(UNICHAR *fileName);
+void modLoadThreaded(UNICHAR *fileName, void (*loadedFunc)(module_t *newMod), bool showProgress); // loadedFunc() swaps it in (main thread)
+void updateModLoadThread(void); // called every frame
+void abortModLoadThread(void);
+int8_t checkModType(const char *buf); // signature at offset 1080 -> FORMAT_xxx
 void setupNewMod(void);
+void setupNewModEditor(void);
+void freeUnusedModule(module_t *m);
+bool ppdecrunch(const uint8_t *src, uint8_t *dst, const uint8_t *offsetLens, uint32_t srcLen, uint32_t dstLen, uint8_t skipBits); // PP20 stream, public for tests/test_pp_decrunch.c
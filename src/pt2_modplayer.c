@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <math.h>
@@ -23,14 +24,34 @@
 #include "pt2_visuals.h"
 #include "pt2_textout.h"
 #include "pt2_scopes.h"
+#include "pt2_trace.h"
+#include "pt2_analyzer.h"
 
 extern bool forceMixerOff; // pt_audio.c
+extern int32_t samplesPerTick; // pt_audio.c
 
 static bool posJumpAssert, pBreakFlag, updateUIPositions, modHasBeenPlayed;
 static int8_t pBreakPosition, oldRow, modPattern;
 static uint8_t pattDelTime, setBPMFlag, lowMask = 0xFF, pattDelTime2, oldSpeed;
 static int16_t modOrder, oldPattern, oldOrder;
 static uint16_t modBPM, oldBPM;
+static uint8_t periodToNoteTab[4096]; // period -> index into the finetune 0 period table
+
+/* Patterns are compiled to cellEvent_t (see compilePatterns()) when a module is
+** loaded, and again after they have been edited. The effect is a single ID for
+** the routine tables below, Exy commands have their own IDs.
+*/
+#define EFFECT_E(x) (0x10 + (x)) // Exy -> 0x10..0x1F
+#define NUM_EFFECTS 0x20
+
+#define EVENT_NOTE   1 // period > 0
+#define EVENT_SAMPLE 2 // sample 1..31
+#define EVENT_EFFECT 4 // effect or parameter > 0
+
+// MOD2WAV and the playlist need to know when the song ends (loops or stops)
+#define DETECT_SONG_END (editor.isWAVRendering || (editor.playlistActive && editor.playMode == PLAY_MODE_NORMAL))
+
+typedef void (*effectRoutine_t)(moduleChannel_t *ch);
 
 static const int8_t vuMeterHeights[65] =
 {
@@ -182,7 +203,7 @@ static void jumpLoop(moduleChannel_t *ch)
 		pBreakPosition = ch->n_pattpos;
 		pBreakFlag = 1;
 
-		if (editor.isWAVRendering)
+		if (DETECT_SONG_END)
 		{
 			for (tempParam = pBreakPosition; tempParam <= modEntry->row; tempParam++)
 				editor.rowVisitTable[(modOrder * MOD_ROWS) + tempParam] = false;
@@ -206,13 +227,11 @@ static void doRetrg(moduleChannel_t *ch)
 	paulaSetLength(ch->n_chanindex, ch->n_length);
 	paulaSetPeriod(ch->n_chanindex, ch->n_period);
 	paulaStartDMA(ch->n_chanindex);
+	setVUMeterHeight(ch);
 
 	// these take effect after the current DMA cycle is done
 	paulaSetData(ch->n_chanindex, ch->n_loopstart);
 	paulaSetLength(ch->n_chanindex, ch->n_replen);
-
-	updateSpectrumAnalyzer(ch->n_volume, ch->n_period);
-	setVUMeterHeight(ch);
 }
 
 static void retrigNote(moduleChannel_t *ch)
@@ -647,131 +666,230 @@ static void sampleOffset(moduleChannel_t *ch)
 	}
 }
 
-static void E_Commands(moduleChannel_t *ch)
+static void setChannelPeriod(moduleChannel_t *ch)
 {
-	uint8_t cmd;
+	paulaSetPeriod(ch->n_chanindex, ch->n_period);
+}
 
-	cmd = (ch->n_cmd & 0xF0) >> 4;
-	switch (cmd)
-	{
-		case 0x0: filterOnOff(ch);       break;
-		case 0x1: finePortaUp(ch);       break;
-		case 0x2: finePortaDown(ch);     break;
-		case 0x3: setGlissControl(ch);   break;
-		case 0x4: setVibratoControl(ch); break;
-		case 0x5: setFineTune(ch);       break;
-		case 0x6: jumpLoop(ch);          break;
-		case 0x7: setTremoloControl(ch); break;
-		case 0x8: karplusStrong(ch);     break;
-		default: break;
-	}
+static void setPeriodAndTremolo(moduleChannel_t *ch)
+{
+	paulaSetPeriod(ch->n_chanindex, ch->n_period);
+	tremolo(ch);
+}
 
-	if (editor.muted[ch->n_chanindex])
-		return;
+static void setPeriodAndVolumeSlide(moduleChannel_t *ch)
+{
+	paulaSetPeriod(ch->n_chanindex, ch->n_period);
+	volumeSlide(ch);
+}
 
-	switch (cmd)
-	{
-		case 0x9: retrigNote(ch);     break;
-		case 0xA: volumeFineUp(ch);   break;
-		case 0xB: volumeFineDown(ch); break;
-		case 0xC: noteCut(ch);        break;
-		case 0xD: noteDelay(ch);      break;
-		case 0xE: patternDelay(ch);   break;
-		case 0xF: funkIt(ch);         break;
-		default: break;
-	}
+static void setChannelPeriodIfUnmuted(moduleChannel_t *ch)
+{
+	if (!editor.muted[ch->n_chanindex])
+		paulaSetPeriod(ch->n_chanindex, ch->n_period);
 }
 
-static void checkMoreEffects(moduleChannel_t *ch)
+static void volumeChangeIfUnmuted(moduleChannel_t *ch)
 {
-	switch ((ch->n_cmd & 0xF00) >> 8)
-	{
-		case 0x9: sampleOffset(ch); break;
-		case 0xB: positionJump(ch); break;
+	if (!editor.muted[ch->n_chanindex])
+		volumeChange(ch);
+}
 
-		case 0xC:
-		{
-			if (!editor.muted[ch->n_chanindex])
-				volumeChange(ch);
-		}
-		break;
+// effects handled on tick 0, after a row has been read
+static const effectRoutine_t rowEffectRoutines[NUM_EFFECTS] =
+{
+	setChannelPeriodIfUnmuted, // 0xy
+	setChannelPeriodIfUnmuted, // 1xx
+	setChannelPeriodIfUnmuted, // 2xx
+	setChannelPeriodIfUnmuted, // 3xx
+	setChannelPeriodIfUnmuted, // 4xy
+	setChannelPeriodIfUnmuted, // 5xy
+	setChannelPeriodIfUnmuted, // 6xy
+	setChannelPeriodIfUnmuted, // 7xy
+	setChannelPeriodIfUnmuted, // 8xx
+	sampleOffset,              // 9xx
+	setChannelPeriodIfUnmuted, // Axy
+	positionJump,              // Bxx
+	volumeChangeIfUnmuted,     // Cxx
+	patternBreak,              // Dxx
+	NULL,                      // (Exy has the IDs below)
+	setSpeed,                  // Fxx
+	filterOnOff,               // E0x
+	finePortaUp,               // E1x
+	finePortaDown,             // E2x
+	setGlissControl,           // E3x
+	setVibratoControl,         // E4x
+	setFineTune,               // E5x
+	jumpLoop,                  // E6x
+	setTremoloControl,         // E7x
+	karplusStrong,             // E8x
+	retrigNote,                // E9x
+	volumeFineUp,              // EAx
+	volumeFineDown,            // EBx
+	noteCut,                   // ECx
+	noteDelay,                 // EDx
+	patternDelay,              // EEx
+	funkIt                     // EFx
+};
 
-		case 0xD: patternBreak(ch); break;
-		case 0xE: E_Commands(ch);   break;
-		case 0xF: setSpeed(ch);     break;
+// effects handled on ticks 1..speed-1 (only called if the parameter or effect is non-zero)
+static const effectRoutine_t tickEffectRoutines[NUM_EFFECTS] =
+{
+	arpeggio,                // 0xy
+	portaUp,                 // 1xx
+	portaDown,               // 2xx
+	tonePortamento,          // 3xx
+	vibrato,                 // 4xy
+	tonePlusVolSlide,        // 5xy
+	vibratoPlusVolSlide,     // 6xy
+	setPeriodAndTremolo,     // 7xy
+	setChannelPeriod,        // 8xx
+	setChannelPeriod,        // 9xx
+	setPeriodAndVolumeSlide, // Axy
+	setChannelPeriod,        // Bxx
+	setChannelPeriod,        // Cxx
+	setChannelPeriod,        // Dxx
+	NULL,                    // (Exy has the IDs below)
+	setChannelPeriod,        // Fxx
+	filterOnOff,             // E0x
+	finePortaUp,             // E1x
+	finePortaDown,           // E2x
+	setGlissControl,         // E3x
+	setVibratoControl,       // E4x
+	setFineTune,             // E5x
+	jumpLoop,                // E6x
+	setTremoloControl,       // E7x
+	karplusStrong,           // E8x
+	retrigNote,              // E9x
+	volumeFineUp,            // EAx
+	volumeFineDown,          // EBx
+	noteCut,                 // ECx
+	noteDelay,               // EDx
+	patternDelay,            // EEx
+	funkIt                   // EFx
+};
 
-		default:
-		{
-			if (!editor.muted[ch->n_chanindex])
-				paulaSetPeriod(ch->n_chanindex, ch->n_period);
-		}
-		break;
-	}
+static void checkMoreEffects(moduleChannel_t *ch)
+{
+	if (ch->n_effect >= EFFECT_E(0x9) && editor.muted[ch->n_chanindex])
+		return; // E9x..EFx are not handled on muted channels
+
+	rowEffectRoutines[ch->n_effect](ch);
 }
 
 static void checkEffects(moduleChannel_t *ch)
 {
-	uint8_t effect;
-
 	if (editor.muted[ch->n_chanindex])
 		return;
 
 	updateFunk(ch);
 
-	effect = (ch->n_cmd & 0xF00) >> 8;
+	if (ch->n_flags & EVENT_EFFECT)
+		tickEffectRoutines[ch->n_effect](ch);
+
+	if (ch->n_effect != 0x7)
+		paulaSetVolume(ch->n_chanindex, ch->n_volume);
+}
+
+void initPeriodToNoteTable(void)
+{
+	uint8_t i;
 
-	if ((ch->n_cmd & 0xFFF) > 0)
+	for (uint16_t note = 0; note < 4096; note++)
 	{
-		switch (effect)
+		for (i = 0; i < 37; i++)
 		{
-			case 0x0: arpeggio(ch);            break;
-			case 0x1: portaUp(ch);             break;
-			case 0x2: portaDown(ch);           break;
-			case 0x3: tonePortamento(ch);      break;
-			case 0x4: vibrato(ch);             break;
-			case 0x5: tonePlusVolSlide(ch);    break;
-			case 0x6: vibratoPlusVolSlide(ch); break;
-			case 0xE: E_Commands(ch);          break;
-
-			case 0x7:
-			{
-				paulaSetPeriod(ch->n_chanindex, ch->n_period);
-				tremolo(ch);
-			}
-			break;
+			// periodTable[36] = 0, so i=36 is safe
+			if (note >= periodTable[i])
+				break;
+		}
 
-			case 0xA:
-			{
-				paulaSetPeriod(ch->n_chanindex, ch->n_period);
-				volumeSlide(ch);
-			}
-			break;
+		periodToNoteTab[note] = i;
+	}
+}
 
-			default: paulaSetPeriod(ch->n_chanindex, ch->n_period); break;
-		}
+static void compileCell(cellEvent_t *event, const note_t *note)
+{
+	event->note = note->period;
+	event->cmd = (note->command << 8) | note->param;
+	event->sample = note->sample;
+	event->noteIndex = periodToNoteTab[note->period & 0xFFF];
+
+	if ((event->cmd & 0xF00) == 0xE00)
+		event->effect = EFFECT_E((note->param & 0xF0) >> 4);
+	else
+		event->effect = (event->cmd & 0xF00) >> 8;
+
+	event->flags = 0;
+	if ((note->period & 0xFFF) > 0)
+		event->flags |= EVENT_NOTE;
+
+	if (note->sample >= 1 && note->sample <= 31) // SAFETY BUG FIX: don't handle sample-numbers >31
+		event->flags |= EVENT_SAMPLE;
+
+	if ((event->cmd & 0xFFF) > 0)
+		event->flags |= EVENT_EFFECT;
+}
+
+static void compilePattern(module_t *m, int32_t pattern)
+{
+	const note_t *note = m->patterns[pattern];
+	cellEvent_t *event = m->events[pattern];
+
+	for (int32_t i = 0; i < MOD_ROWS * AMIGA_VOICES; i++)
+		compileCell(&event[i], &note[i]);
+}
+
+// call when a module has been loaded or made, before the replayer sees it (safe on the loader thread)
+void compilePatterns(module_t *m)
+{
+	for (int32_t i = 0; i < MAX_PATTERNS; i++)
+	{
+		if (m->patterns[i] != NULL)
+			compilePattern(m, i);
+
+		m->patternDirty[i] = false;
 	}
+}
 
-	if (effect != 0x7)
-		paulaSetVolume(ch->n_chanindex, ch->n_volume);
+// call when the editor writes to a pattern, the replayer sees the change after updateCompiledPatterns()
+void modPatternChanged(int32_t pattern)
+{
+	if (pattern >= 0 && pattern < MAX_PATTERNS)
+		modEntry->patternDirty[pattern] = true;
 }
 
-static void setPeriod(moduleChannel_t *ch)
+// called once per frame after the input has been handled
+void updateCompiledPatterns(void)
 {
-	uint8_t i;
-	uint16_t note;
+	module_t *m = modEntry;
+	bool audioLocked = false;
 
-	note = ch->n_note & 0xFFF;
-	for (i = 0; i < 37; i++)
+	for (int32_t i = 0; i < MAX_PATTERNS; i++)
 	{
-		// periodTable[36] = 0, so i=36 is safe
-		if (note >= periodTable[i])
-			break;
+		if (!m->patternDirty[i])
+			continue;
+
+		if (!audioLocked)
+		{
+			lockAudio();
+			audioLocked = true;
+		}
+
+		m->patternDirty[i] = false;
+		if (m->patterns[i] != NULL)
+			compilePattern(m, i);
 	}
 
-	// BUG: yes it's 'safe' if i=37 because of padding at the end of period table
-	ch->n_period = periodTable[(ch->n_finetune * 37) + i];
+	if (audioLocked)
+		unlockAudio();
+}
 
-	if ((ch->n_cmd & 0xFF0) != 0xED0) // no note delay
+static void setPeriod(moduleChannel_t *ch)
+{
+	ch->n_period = periodTable[(ch->n_finetune * 37) + ch->n_noteindex];
+
+	if (ch->n_effect != EFFECT_E(0xD)) // no note delay
 	{
 		if ((ch->n_wavecontrol & 0x04) == 0) ch->n_vibratopos = 0;
 		if ((ch->n_wavecontrol & 0x40) == 0) ch->n_tremolopos = 0;
@@ -791,7 +909,6 @@ static void setPeriod(moduleChannel_t *ch)
 		if (!editor.muted[ch->n_chanindex])
 		{
 			paulaStartDMA(ch->n_chanindex);
-			updateSpectrumAnalyzer(ch->n_volume, ch->n_period);
 			setVUMeterHeight(ch);
 		}
 		else
@@ -803,36 +920,47 @@ static void setPeriod(moduleChannel_t *ch)
 	checkMoreEffects(ch);
 }
 
-static void checkMetronome(moduleChannel_t *ch, note_t *note)
+static const cellEvent_t *checkMetronome(moduleChannel_t *ch, const cellEvent_t *event)
 {
+	static cellEvent_t metroEvent;
+
 	if (editor.metroFlag && editor.metroChannel > 0)
 	{
 		if (ch->n_chanindex == editor.metroChannel-1 && (modEntry->row % editor.metroSpeed) == 0)
 		{
-			note->sample = 0x1F;
-			note->period = (((modEntry->row / editor.metroSpeed) % editor.metroSpeed) == 0) ? 160 : 214;
+			metroEvent = *event;
+			metroEvent.sample = 0x1F;
+			metroEvent.note = (((modEntry->row / editor.metroSpeed) % editor.metroSpeed) == 0) ? 160 : 214;
+			metroEvent.noteIndex = periodToNoteTab[metroEvent.note];
+			metroEvent.flags |= EVENT_NOTE | EVENT_SAMPLE;
+
+			return &metroEvent;
 		}
 	}
+
+	return event;
 }
 
 static void playVoice(moduleChannel_t *ch)
 {
-	uint8_t cmd;
 	moduleSample_t *s;
-	note_t note;
+	const cellEvent_t *event;
 
 	if (ch->n_note == 0 && ch->n_cmd == 0)
 		paulaSetPeriod(ch->n_chanindex, ch->n_period);
 
-	note = modEntry->patterns[modPattern][(modEntry->row * AMIGA_VOICES) + ch->n_chanindex];
-	checkMetronome(ch, &note);
+	event = &modEntry->events[modPattern][(modEntry->row * AMIGA_VOICES) + ch->n_chanindex];
+	event = checkMetronome(ch, event);
 
-	ch->n_note = note.period;
-	ch->n_cmd = (note.command << 8) | note.param;
+	ch->n_note = event->note;
+	ch->n_cmd = event->cmd;
+	ch->n_effect = event->effect;
+	ch->n_noteindex = event->noteIndex;
+	ch->n_flags = event->flags;
 
-	if ((note.sample >= 1) && (note.sample <= 31)) // SAFETY BUG FIX: don't handle sample-numbers >31
+	if (event->flags & EVENT_SAMPLE)
 	{
-		ch->n_samplenum = note.sample - 1;
+		ch->n_samplenum = event->sample - 1;
 		s = &modEntry->samples[ch->n_samplenum];
 
 		ch->n_start = &modEntry->sampleData[s->offset];
@@ -858,31 +986,34 @@ static void playVoice(moduleChannel_t *ch)
 			ch->n_loopstart = ch->n_wavestart = &modEntry->sampleData[RESERVED_SAMPLE_OFFSET]; // dummy sample
 	}
 
-	if ((ch->n_note & 0xFFF) > 0)
+	if (event->flags & EVENT_NOTE)
 	{
-		if ((ch->n_cmd & 0xFF0) == 0xE50) // set finetune
+		switch (event->effect)
 		{
-			setFineTune(ch);
-			setPeriod(ch);
-		}
-		else
-		{
-			cmd = (ch->n_cmd & 0xF00) >> 8;
-			if (cmd == 3 || cmd == 5)
+			case EFFECT_E(0x5): // set finetune
+			{
+				setFineTune(ch);
+				setPeriod(ch);
+			}
+			break;
+
+			case 0x3:
+			case 0x5:
 			{
 				setVUMeterHeight(ch);
 				setTonePorta(ch);
 				checkMoreEffects(ch);
 			}
-			else if (cmd == 9)
+			break;
+
+			case 0x9:
 			{
 				checkMoreEffects(ch);
 				setPeriod(ch);
 			}
-			else
-			{
-				setPeriod(ch);
-			}
+			break;
+
+			default: setPeriod(ch); break;
 		}
 	}
 	else
@@ -993,7 +1124,7 @@ bool intMusic(void)
 		setBPMFlag = 0;
 	}
 
-	if (editor.isWAVRendering && editor.modTick == 0)
+	if (DETECT_SONG_END && editor.modTick == 0)
 		editor.rowVisitTable[(modOrder * MOD_ROWS) + modEntry->row] = true;
 
 	if (!editor.stepPlayEnabled)
@@ -1003,6 +1134,9 @@ bool intMusic(void)
 	{
 		editor.modTick = 0;
 
+		if (trace.enabled)
+			traceNewRow((uint8_t)modOrder, (uint8_t)modEntry->row);
+
 		if (pattDelTime2 == 0)
 		{
 			for (i = 0; i < AMIGA_VOICES; i++)
@@ -1068,6 +1202,9 @@ bool intMusic(void)
 			editor.stepPlayBackwards = false;
 			editor.ui.updatePatternData = true;
 
+			if (trace.enabled)
+				traceEndTick(editor.modTick, editor.modSpeed, modBPM);
+
 			return true;
 		}
 
@@ -1079,7 +1216,7 @@ bool intMusic(void)
 			nextPosition();
 		}
 
-		if (editor.isWAVRendering && !pattDelTime2 && editor.rowVisitTable[(modOrder * MOD_ROWS) + modEntry->row])
+		if (DETECT_SONG_END && !pattDelTime2 && editor.rowVisitTable[(modOrder * MOD_ROWS) + modEntry->row])
 			modHasBeenPlayed = true;
 	}
 	else
@@ -1091,7 +1228,10 @@ bool intMusic(void)
 			nextPosition();
 	}
 
-	if ((editor.isSMPRendering || editor.isWAVRendering) && modHasBeenPlayed && editor.modTick == editor.modSpeed-1)
+	if (trace.enabled)
+		traceEndTick(editor.modTick, editor.modSpeed, modBPM);
+
+	if ((editor.isSMPRendering || DETECT_SONG_END) && modHasBeenPlayed && editor.modTick == editor.modSpeed-1)
 	{
 		modHasBeenPlayed = false;
 		return false;
@@ -1156,6 +1296,9 @@ void modSetPos(int16_t order, int16_t row)
 
 	if (editor.blockMarkFlag)
 		editor.ui.updateStatusText = true;
+
+	if (editor.playlistActive) // the song end detection starts over after a jump
+		memset(editor.rowVisitTable, 0, MOD_ORDERS * MOD_ROWS);
 }
 
 void modSetTempo(uint16_t bpm)
@@ -1207,6 +1350,47 @@ void modStop(void)
 	modHasBeenPlayed = true;
 }
 
+/* Makes newMod the playing module without a gap (playlist). Called from the audio thread
+** between two ticks, so it only resets the replayer. The main thread does the rest (after
+** it has taken the old module, which this returns) with setupNewModEditor().
+*/
+module_t *modSwapSong(module_t *newMod)
+{
+	module_t *oldMod = modEntry;
+
+	turnOffVoices(); // the old module's samples will be freed
+	resetOldPeriods();
+
+	modEntry = newMod;
+
+	pBreakFlag = false;
+	pattDelTime = 0;
+	pattDelTime2 = 0;
+	pBreakPosition = 0;
+	posJumpAssert = false;
+	modHasBeenPlayed = false;
+	setBPMFlag = 0;
+
+	modOrder = 0;
+	modPattern = (int8_t)modEntry->head.order[0];
+	modEntry->row = 0;
+	modEntry->currRow = 0;
+	modEntry->currOrder = 0;
+	modEntry->currPattern = modPattern;
+
+	memset(editor.rowVisitTable, 0, MOD_ORDERS * MOD_ROWS);
+
+	setLEDFilter(false);
+	modSetSpeed(6);
+	modSetTempo((modEntry->head.initBPM > 0) ? modEntry->head.initBPM : 125);
+	editor.modTick = editor.modSpeed; // the next tick plays the first row
+
+	editor.musicTime = 0;
+	editor.songPlaying = true;
+
+	return oldMod;
+}
+
 void playPattern(int8_t startRow)
 {
 	modEntry->row = startRow & 0x3F;
@@ -1313,6 +1497,9 @@ void modPlay(int16_t patt, int16_t order, int8_t row)
 	editor.didQuantize = false;
 	editor.musicTime = 0;
 
+	if (editor.playlistActive)
+		memset(editor.rowVisitTable, 0, MOD_ORDERS * MOD_ROWS);
+
 	if (!editor.isSMPRendering && !editor.isWAVRendering)
 	{
 		editor.ui.updateSongPos = true;
@@ -1357,7 +1544,10 @@ void clearSong(void)
 		modEntry->head.patternCount = 1;
 
 		for (i = 0; i < MAX_PATTERNS; i++)
+		{
 			memset(modEntry->patterns[i], 0, (MOD_ROWS * AMIGA_VOICES) * sizeof (note_t));
+			modPatternChanged(i);
+		}
 
 		for (i = 0; i < AMIGA_VOICES; i++)
 		{
@@ -1418,6 +1608,7 @@ void clearSamples(void)
 	editor.blockMarkFlag = false;
 
 	editor.samplePos = 0;
+	invalidateSamplePeaks();
 	updateCurrSample();
 
 	updateWindowTitle(MOD_IS_MODIFIED);
@@ -1445,6 +1636,9 @@ void modFree(void)
 	{
 		if (modEntry->patterns[i] != NULL)
 			free(modEntry->patterns[i]);
+
+		if (modEntry->events[i] != NULL)
+			free(modEntry->events[i]);
 	}
 
 	if (modEntry->sampleData != NULL)
@@ -1489,6 +1683,70 @@ void restartSong(void) // for the beginning of MOD2WAV/PAT2SMP
 	}
 }
 
+/* Steps the replayer through the song without mixing (for the module analyzer), until it
+** stops or loops. Call this only when the song is not playing.
+*/
+void calcSongStats(songStats_t *stats)
+{
+	bool running;
+	uint8_t cmd, param;
+	int32_t voices;
+	moduleChannel_t *ch;
+
+	memset(stats, 0, sizeof (songStats_t));
+
+	storeTempVariables();
+	editor.isWAVRendering = true; // for the end detection in intMusic()
+	restartSong();
+	turnOffVoices();
+
+	while (stats->dDuration < ANALYZER_MAX_SECONDS)
+	{
+		running = intMusic();
+
+		// tick length as set by the CIA timer (PT truncates here, also see bpm2SmpsPerTick())
+		if (modBPM > 0)
+			stats->dDuration += (uint32_t)(1773447 / modBPM) * (1.0 / CIA_PAL_CLK);
+
+		if (editor.modTick == 0) // new row
+		{
+			for (uint8_t i = 0; i < AMIGA_VOICES; i++)
+			{
+				ch = &modEntry->channels[i];
+
+				cmd = (ch->n_cmd >> 8) & 0x0F;
+				param = ch->n_cmd & 0xFF;
+
+				if (cmd == 0x0E)
+					stats->effects |= 1UL << (16 + (param >> 4));
+				else if (cmd != 0 || param != 0)
+					stats->effects |= 1UL << cmd;
+			}
+		}
+
+		voices = paulaSkipSamples(samplesPerTick);
+		if (voices > stats->maxVoices)
+			stats->maxVoices = (uint8_t)voices;
+
+		if (!running)
+		{
+			stats->loops = true;
+			stats->loopOrder = modOrder;
+			stats->loopRow = modEntry->row;
+			break;
+		}
+
+		if (!editor.songPlaying) // F00
+		{
+			stats->stops = true;
+			break;
+		}
+	}
+
+	resetSong();
+	editor.isWAVRendering = false;
+}
+
 // this function is meant for the end of MOD2WAV/PAT2SMP
 void resetSong(void) // only call this after storeTempVariables() has been called!
 {
@@ -0,0 +1,303 @@
+/* Module header previews for Disk Op. (title, format, sample and order count).
+**
+** Only the first MOD_PREVIEW_HEADER_LEN bytes of a file are read. Results are
+** kept in a cache file (pt2-preview.cache in ~/.protracker/ or %APPDATA%), keyed
+** by a hash of the full path plus file size and modification time, so that a
+** directory only has to be read once. Non-modules are cached too (format = -1).
+**
+** The cache is only touched by the Disk Op. fill thread (and freed on exit).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h> // tolower()
+#include <limits.h>
+#include "pt2_header.h"
+#include "pt2_helpers.h"
+#include "pt2_modloader.h"
+#include "pt2_modpreview.h"
+
+#define CACHE_MAGIC "PT2PRV02"
+
+typedef struct cacheRec_t
+{
+	uint64_t pathHash;
+	int64_t mtime;
+	int32_t filesize;
+	int8_t format;
+	uint8_t numSamples, numOrders;
+	char title[20];
+} cacheRec_t;
+
+typedef struct cacheHeader_t
+{
+	char magic[8];
+	uint32_t recSize, numRecs;
+} cacheHeader_t;
+
+static bool cacheLoaded;
+static int32_t numCacheRecs, numNewRecs, newRecsSize;
+static UNICHAR cachePathU[PATH_MAX + 32];
+static cacheRec_t *cacheRecs, *newRecs;
+
+static uint64_t hashPath(const UNICHAR *path)
+{
+	const uint8_t *ptr = (const uint8_t *)path;
+	const uint32_t len = (uint32_t)(UNICHAR_STRLEN(path) * sizeof (UNICHAR));
+
+	uint64_t hash = 0xCBF29CE484222325ULL; // FNV-1a
+	for (uint32_t i = 0; i < len; i++)
+	{
+		hash ^= ptr[i];
+		hash *= 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+static int compareRecs(const void *a, const void *b)
+{
+	const uint64_t hashA = ((const cacheRec_t *)a)->pathHash;
+	const uint64_t hashB = ((const cacheRec_t *)b)->pathHash;
+
+	return (hashA > hashB) - (hashA < hashB);
+}
+
+static cacheRec_t *findRec(cacheRec_t *recs, int32_t numRecs, uint64_t pathHash)
+{
+	cacheRec_t key;
+
+	if (recs == NULL || numRecs == 0)
+		return NULL;
+
+	key.pathHash = pathHash;
+	return (cacheRec_t *)bsearch(&key, recs, numRecs, sizeof (cacheRec_t), compareRecs);
+}
+
+static void loadCache(void)
+{
+	cacheHeader_t h;
+	FILE *f;
+
+	cacheLoaded = true;
+
+	if (!getConfigFilePath(cachePathU, "pt2-preview.cache"))
+	{
+		cachePathU[0] = '\0';
+		return;
+	}
+
+	f = UNICHAR_FOPEN(cachePathU, "rb");
+	if (f == NULL)
+		return;
+
+	if (fread(&h, sizeof (h), 1, f) != 1 || memcmp(h.magic, CACHE_MAGIC, 8) != 0 ||
+		h.recSize != sizeof (cacheRec_t) || h.numRecs > MOD_PREVIEW_CACHE_MAX)
+	{
+		fclose(f);
+		return;
+	}
+
+	cacheRecs = (cacheRec_t *)malloc(h.numRecs * sizeof (cacheRec_t));
+	if (cacheRecs != NULL)
+		numCacheRecs = (int32_t)fread(cacheRecs, sizeof (cacheRec_t), h.numRecs, f); // saved sorted
+
+	fclose(f);
+}
+
+// samples with a length, the length word is at offset 22 of each 30-byte sample header
+static uint8_t countSamples(const char *buf, int32_t numSamples)
+{
+	uint8_t count = 0;
+
+	for (int32_t i = 0; i < numSamples; i++)
+	{
+		const uint8_t *lengthPtr = (const uint8_t *)&buf[20 + (i * 30) + 22];
+		if (lengthPtr[0] != 0 || lengthPtr[1] != 0)
+			count++;
+	}
+
+	return count;
+}
+
+bool readModPreview(const UNICHAR *path, modPreview_t *preview)
+{
+	char buf[MOD_PREVIEW_HEADER_LEN];
+	size_t bytesRead;
+	FILE *f;
+
+	preview->format = -1;
+	preview->numSamples = 0;
+	preview->numOrders = 0;
+	preview->title[0] = '\0';
+
+	f = UNICHAR_FOPEN(path, "rb");
+	if (f == NULL)
+		return false;
+
+	bytesRead = fread(buf, 1, MOD_PREVIEW_HEADER_LEN, f);
+	fclose(f);
+
+	if (bytesRead >= MOD_PREVIEW_HEADER_LEN)
+		preview->format = checkModType(&buf[1080]);
+
+	if (preview->format >= 0 && preview->format != FORMAT_UNKNOWN)
+	{
+		preview->numSamples = countSamples(buf, 31);
+		preview->numOrders = (uint8_t)buf[950];
+	}
+	else if (bytesRead >= 600 && (uint8_t)buf[470] >= 1 && (uint8_t)buf[470] <= 128)
+	{
+		// no signature, may be The Ultimate SoundTracker (15 samples)
+		preview->format = FORMAT_STK;
+		preview->numSamples = countSamples(buf, 15);
+		preview->numOrders = (uint8_t)buf[470];
+	}
+	else
+	{
+		preview->format = -1; // also PowerPacked modules, they have to be decrunched first
+		return true;
+	}
+
+	// same case as in the module loader, unprintable characters become spaces
+	for (int32_t i = 0; i < 20; i++)
+	{
+		const char ch = buf[i];
+		preview->title[i] = (ch < ' ' || ch > '~') ? ' ' : (char)tolower(ch);
+	}
+	preview->title[20] = '\0';
+
+	for (int32_t i = 19; i >= 0 && preview->title[i] == ' '; i--)
+		preview->title[i] = '\0';
+
+	return true;
+}
+
+bool lookupModPreview(const UNICHAR *path, int32_t filesize, int64_t mtime, modPreview_t *preview)
+{
+	cacheRec_t *rec;
+
+	if (!cacheLoaded)
+		loadCache();
+
+	rec = findRec(cacheRecs, numCacheRecs, hashPath(path));
+	if (rec == NULL || rec->filesize != filesize || rec->mtime != mtime)
+		return false;
+
+	preview->format = rec->format;
+	preview->numSamples = rec->numSamples;
+	preview->numOrders = rec->numOrders;
+	memcpy(preview->title, rec->title, 20);
+	preview->title[20] = '\0';
+
+	return true;
+}
+
+void storeModPreview(const UNICHAR *path, int32_t filesize, int64_t mtime, const modPreview_t *preview)
+{
+	cacheRec_t *rec, *newPtr;
+
+	if (numNewRecs >= newRecsSize)
+	{
+		newRecsSize = (newRecsSize == 0) ? 256 : (newRecsSize * 2);
+
+		newPtr = (cacheRec_t *)realloc(newRecs, newRecsSize * sizeof (cacheRec_t));
+		if (newPtr == NULL)
+		{
+			newRecsSize = numNewRecs;
+			return; // not important enough for an error message
+		}
+
+		newRecs = newPtr;
+	}
+
+	rec = &newRecs[numNewRecs++];
+	memset(rec, 0, sizeof (cacheRec_t));
+
+	rec->pathHash = hashPath(path);
+	rec->mtime = mtime;
+	rec->filesize = filesize;
+	rec->format = preview->format;
+	rec->numSamples = preview->numSamples;
+	rec->numOrders = preview->numOrders;
+	memcpy(rec->title, preview->title, 20);
+}
+
+// merges the new entries into the cache and writes it to disk (if anything changed)
+void saveModPreviewCache(void)
+{
+	int32_t numRecs;
+	cacheHeader_t h;
+	cacheRec_t *recs;
+	FILE *f;
+
+	if (numNewRecs == 0)
+		return;
+
+	qsort(newRecs, numNewRecs, sizeof (cacheRec_t), compareRecs);
+
+	recs = (cacheRec_t *)malloc((numNewRecs + numCacheRecs) * sizeof (cacheRec_t));
+	if (recs == NULL)
+		return;
+
+	// new entries first, then old entries that weren't replaced, until the cache is full
+	numRecs = (numNewRecs > MOD_PREVIEW_CACHE_MAX) ? MOD_PREVIEW_CACHE_MAX : numNewRecs;
+	memcpy(recs, newRecs, numRecs * sizeof (cacheRec_t));
+
+	for (int32_t i = 0; i < numCacheRecs && numRecs < MOD_PREVIEW_CACHE_MAX; i++)
+	{
+		if (findRec(newRecs, numNewRecs, cacheRecs[i].pathHash) == NULL)
+			recs[numRecs++] = cacheRecs[i];
+	}
+
+	qsort(recs, numRecs, sizeof (cacheRec_t), compareRecs);
+
+	if (cacheRecs != NULL)
+		free(cacheRecs);
+
+	cacheRecs = recs;
+	numCacheRecs = numRecs;
+	numNewRecs = 0;
+
+	if (cachePathU[0] == '\0')
+		return;
+
+	f = UNICHAR_FOPEN(cachePathU, "wb");
+	if (f == NULL)
+		return;
+
+	memcpy(h.magic, CACHE_MAGIC, 8);
+	h.recSize = sizeof (cacheRec_t);
+	h.numRecs = numCacheRecs;
+
+	if (fwrite(&h, sizeof (h), 1, f) != 1 || fwrite(cacheRecs, sizeof (cacheRec_t), numCacheRecs, f) != (size_t)numCacheRecs)
+	{
+		// don't leave a broken cache file behind
+		fclose(f);
+		UNICHAR_REMOVE(cachePathU);
+		return;
+	}
+
+	fclose(f);
+}
+
+void freeModPreviewCache(void)
+{
+	if (cacheRecs != NULL)
+	{
+		free(cacheRecs);
+		cacheRecs = NULL;
+	}
+
+	if (newRecs != NULL)
+	{
+		free(newRecs);
+		newRecs = NULL;
+	}
+
+	numCacheRecs = numNewRecs = newRecsSize = 0;
+	cacheLoaded = false;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pt2_unicode.h"
+
+#define MOD_PREVIEW_HEADER_LEN 1084 /* title, sample headers, orders and signature */
+#define MOD_PREVIEW_CACHE_MAX 100000 /* max number of cached entries (~5MB) */
+
+typedef struct modPreview_t
+{
+	int8_t format; // FORMAT_xxx, or -1 if the file isn't a module we know
+	uint8_t numSamples, numOrders;
+	char title[20 + 1];
+} modPreview_t;
+
+bool readModPreview(const UNICHAR *path, modPreview_t *preview);
+bool lookupModPreview(const UNICHAR *path, int32_t filesize, int64_t mtime, modPreview_t *preview);
+void storeModPreview(const UNICHAR *path, int32_t filesize, int64_t mtime, const modPreview_t *preview);
+void saveModPreviewCache(void);
+void freeModPreviewCache(void);
@@ -1461,6 +1461,7 @@ void handleSamplerVolumeBox(void)
 				}
 
 				fixSampleBeep(s);
+				invalidateSamplePeaks();
 
 				editor.ui.samplerVolBoxShown = false;
 				removeSamplerVolBox();
@@ -2630,6 +2631,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 				free(ptr8_4);
 
 				fixSampleBeep(s);
+				invalidateSamplePeaks();
 				if (editor.ui.samplerScreenShown)
 					displaySample();
 
@@ -2703,6 +2705,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 			}
 
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			if (editor.ui.samplerScreenShown)
 				displaySample();
 
@@ -2828,6 +2831,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 			free(ptr8_3);
 
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			if (editor.ui.samplerScreenShown)
 				displaySample();
 
@@ -2866,6 +2870,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 			while (ptr8_1 < ptr8_2);
 
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			if (editor.ui.samplerScreenShown)
 				displaySample();
 
@@ -2902,6 +2907,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 			while (ptr8_1 < ptr8_2);
 
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			if (editor.ui.samplerScreenShown)
 				displaySample();
 
@@ -2949,6 +2955,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 
 			editor.samplePos = 0;
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			updateCurrSample();
 
 			updateWindowTitle(MOD_IS_MODIFIED);
@@ -2988,6 +2995,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 			}
 
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			if (editor.ui.samplerScreenShown)
 				displaySample();
 
@@ -3026,6 +3034,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 			}
 
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			if (editor.ui.samplerScreenShown)
 				displaySample();
 
@@ -3106,6 +3115,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 				}
 
 				fixSampleBeep(s);
+				invalidateSamplePeaks();
 				if (editor.ui.samplerScreenShown)
 					displaySample();
 
@@ -3963,6 +3973,7 @@ static bool handleGUIButtons(int32_t button) // are you prepared to enter the ju
 		{
 			editor.diskop.scrollOffset = 0;
 			editor.diskop.cached = false;
+			editor.diskop.rescan = true;
 			editor.ui.updateDiskOpFileList = true;
 		}
 		break;
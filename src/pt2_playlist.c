@@ -0,0 +1,370 @@
+/* Playlist mode (jukebox), over the Disk Op. listing or an .m3u file.
+**
+** While a song plays, the next module is loaded on the module loader thread (only one
+** module is prefetched at a time). The replayer's song end detection (the one MOD2WAV
+** uses) tells the audio thread when the song has looped or stopped, and the prefetched
+** module takes over on the very next tick, so there's no gap between the songs. If it isn't
+** loaded by then, the song loops once more. The main thread then frees the old module and
+** sets up the screen for the new one.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#ifdef _WIN32
+#define WIN32_MEAN_AND_LEAN
+#include <windows.h>
+#else
+#include <unistd.h> // getcwd()
+#endif
+#include "pt2_header.h"
+#include "pt2_audio.h"
+#include "pt2_mouse.h"
+#include "pt2_scopes.h"
+#include "pt2_textout.h"
+#include "pt2_visuals.h"
+#include "pt2_modloader.h"
+#include "pt2_playlist.h"
+
+#define M3U_LINE_LEN (PATH_MAX * 2)
+
+static bool prefetching, songEnded, songStopped; // songEnded/songStopped are only used by the audio thread
+static volatile bool songSwapped;
+static int32_t numEntries, entriesSize, nextEntry, numFailed;
+static UNICHAR **entries;
+static module_t *nextMod, *oldMod; // handed over between the threads under the audio lock
+
+bool intMusic(void); // pt2_modplayer.c
+
+static bool isAbsolutePath(const UNICHAR *path)
+{
+#ifdef _WIN32
+	return (path[0] != '\0' && path[1] == ':') || path[0] == '\\' || path[0] == '/';
+#else
+	return path[0] == '/';
+#endif
+}
+
+bool isPlaylistFile(const UNICHAR *fileName)
+{
+	const int32_t len = (int32_t)UNICHAR_STRLEN(fileName);
+
+	if (len >= 4 && !UNICHAR_STRNICMP(&fileName[len-4], ".M3U", 4))
+		return true;
+
+	if (len >= 5 && !UNICHAR_STRNICMP(&fileName[len-5], ".M3U8", 5))
+		return true;
+
+	return false;
+}
+
+bool playlistAdd(const UNICHAR *dirU, const UNICHAR *nameU)
+{
+	size_t dirLen, nameLen;
+	UNICHAR *path, **newPtr;
+
+	if (numEntries >= entriesSize)
+	{
+		entriesSize = (entriesSize == 0) ? 64 : (entriesSize * 2);
+
+		newPtr = (UNICHAR **)realloc(entries, entriesSize * sizeof (UNICHAR *));
+		if (newPtr == NULL)
+		{
+			entriesSize = numEntries;
+			return false;
+		}
+
+		entries = newPtr;
+	}
+
+	dirLen = (dirU != NULL) ? UNICHAR_STRLEN(dirU) : 0;
+	nameLen = UNICHAR_STRLEN(nameU);
+
+	path = (UNICHAR *)malloc((dirLen + 1 + nameLen + 1) * sizeof (UNICHAR));
+	if (path == NULL)
+		return false;
+
+	if (dirLen > 0)
+	{
+		memcpy(path, dirU, dirLen * sizeof (UNICHAR));
+		if (path[dirLen-1] != DIR_DELIMITER)
+			path[dirLen++] = DIR_DELIMITER;
+	}
+
+	memcpy(&path[dirLen], nameU, (nameLen + 1) * sizeof (UNICHAR));
+
+	entries[numEntries++] = path;
+	return true;
+}
+
+bool playlistAddM3U(UNICHAR *fileName)
+{
+	char line[M3U_LINE_LEN], *p;
+	int32_t i, len, dirLen, numAdded;
+	UNICHAR *dirU, *entryU;
+	FILE *f;
+#ifdef _WIN32
+	UNICHAR entryW[M3U_LINE_LEN];
+#endif
+
+	// relative entries are relative to the .m3u file, find its (absolute) directory
+	dirU = (UNICHAR *)calloc(M3U_LINE_LEN + 2, sizeof (UNICHAR));
+	if (dirU == NULL)
+	{
+		statusOutOfMemory();
+		return false;
+	}
+
+	if (!isAbsolutePath(fileName) && UNICHAR_GETCWD(dirU, PATH_MAX) == NULL)
+		dirU[0] = '\0';
+
+	dirLen = (int32_t)UNICHAR_STRLEN(dirU);
+	for (i = (int32_t)UNICHAR_STRLEN(fileName) - 1; i >= 0; i--)
+	{
+		if (fileName[i] == DIR_DELIMITER || fileName[i] == '/')
+			break;
+	}
+
+	if (i > 0 && dirLen+1+i < M3U_LINE_LEN)
+	{
+		if (dirLen > 0 && dirU[dirLen-1] != DIR_DELIMITER)
+			dirU[dirLen++] = DIR_DELIMITER;
+
+		memcpy(&dirU[dirLen], fileName, i * sizeof (UNICHAR));
+		dirU[dirLen+i] = '\0';
+	}
+
+	f = UNICHAR_FOPEN(fileName, "rb");
+	if (f == NULL)
+	{
+		free(dirU);
+		return false;
+	}
+
+	numAdded = 0;
+	while (fgets(line, sizeof (line), f) != NULL)
+	{
+		p = line;
+		if ((uint8_t)p[0] == 0xEF && (uint8_t)p[1] == 0xBB && (uint8_t)p[2] == 0xBF)
+			p += 3; // UTF-8 BOM
+
+		len = (int32_t)strlen(p);
+		while (len > 0 && (p[len-1] == '\n' || p[len-1] == '\r' || p[len-1] == ' ' || p[len-1] == '\t'))
+			p[--len] = '\0';
+
+		while (*p == ' ' || *p == '\t')
+			p++;
+
+		if (*p == '\0' || *p == '#' || strstr(p, "://") != NULL)
+			continue; // empty lines, comments/#EXTINF and URLs
+
+#ifdef _WIN32
+		if (MultiByteToWideChar(CP_UTF8, 0, p, -1, entryW, M3U_LINE_LEN) == 0)
+			continue;
+
+		entryU = entryW;
+#else
+		entryU = p;
+#endif
+		if (playlistAdd(isAbsolutePath(entryU) ? NULL : dirU, entryU))
+			numAdded++;
+	}
+
+	fclose(f);
+	free(dirU);
+
+	return numAdded > 0;
+}
+
+void playlistClear(void)
+{
+	playlistStop();
+
+	if (entries != NULL)
+	{
+		for (int32_t i = 0; i < numEntries; i++)
+			free(entries[i]);
+
+		free(entries);
+		entries = NULL;
+	}
+
+	numEntries = entriesSize = 0;
+}
+
+static void firstSongLoaded(module_t *newMod)
+{
+	modStop();
+	modFree();
+
+	modEntry = newMod;
+	setupNewMod();
+	modEntry->moduleLoaded = true;
+
+	statusAllRight();
+
+	editor.playlistActive = true; // set before modPlay(), it starts the song end detection
+	editor.playMode = PLAY_MODE_NORMAL;
+	modPlay(DONT_SET_PATTERN, 0, 0);
+	editor.currMode = MODE_PLAY;
+	pointerSetMode(POINTER_MODE_PLAY, DO_CARRY);
+
+	displayMainScreen();
+}
+
+void playlistStart(int32_t entry)
+{
+	playlistStop();
+
+	if (entry < 0 || entry >= numEntries)
+		return;
+
+	nextEntry = (entry + 1) % numEntries;
+	numFailed = 0;
+
+	modLoadThreaded(entries[entry], firstSongLoaded, true);
+}
+
+// the audio thread has switched to the next song, take the old one and update the screen
+static void finishSongSwap(void)
+{
+	module_t *old;
+
+	lockAudio();
+	old = oldMod;
+	oldMod = NULL;
+	songSwapped = false;
+	unlockAudio();
+
+	nextEntry = (nextEntry + 1) % numEntries;
+
+	setupNewModEditor();
+
+	editor.playMode = PLAY_MODE_NORMAL;
+	editor.currMode = MODE_PLAY;
+	pointerSetMode(POINTER_MODE_PLAY, DO_CARRY);
+	statusAllRight();
+
+	clearScopes(); // they may still show the old samples
+	freeUnusedModule(old);
+
+	displayMainScreen();
+}
+
+void playlistStop(void)
+{
+	module_t *mod;
+
+	if (songSwapped)
+		finishSongSwap();
+
+	if (prefetching)
+	{
+		abortModLoadThread();
+		prefetching = false;
+	}
+
+	lockAudio();
+	editor.playlistActive = false;
+	mod = nextMod;
+	nextMod = NULL;
+	songEnded = songStopped = false;
+	unlockAudio();
+
+	freeUnusedModule(mod);
+}
+
+static void prefetchLoaded(module_t *newMod)
+{
+	prefetching = false;
+
+	if (newMod == NULL)
+	{
+		// skip files that can't be loaded
+		if (++numFailed >= numEntries)
+		{
+			playlistStop();
+			displayErrorMsg("PLAYLIST ERROR !");
+			return;
+		}
+
+		nextEntry = (nextEntry + 1) % numEntries;
+		return;
+	}
+
+	numFailed = 0;
+	newMod->moduleLoaded = true;
+
+	lockAudio();
+	nextMod = newMod;
+	unlockAudio();
+}
+
+void updatePlaylist(void)
+{
+	bool idle;
+
+	if (!editor.playlistActive)
+		return;
+
+	if (songSwapped)
+		finishSongSwap();
+
+	if (modEntry->modified)
+	{
+		playlistStop(); // don't throw away the user's changes at the end of the song
+		return;
+	}
+
+	if (!prefetching && !editor.isModLoading)
+	{
+		lockAudio();
+		idle = (nextMod == NULL && oldMod == NULL);
+		unlockAudio();
+
+		if (idle)
+		{
+			prefetching = true;
+			modLoadThreaded(entries[nextEntry], prefetchLoaded, false);
+		}
+	}
+}
+
+void playlistTick(void)
+{
+	bool normalPlay;
+
+	if (songStopped && editor.songPlaying)
+		songStopped = false; // played again by the user, wait for the end of the song
+
+	if ((songEnded && editor.songPlaying) || songStopped)
+	{
+		if (nextMod != NULL && oldMod == NULL)
+		{
+			// the last tick of the song has been mixed, the next song starts on this one
+			oldMod = modSwapSong(nextMod);
+			nextMod = NULL;
+			songStopped = false;
+			songSwapped = true;
+		}
+		else if (songEnded)
+		{
+			// the next song isn't loaded yet, let this one loop and swap at its next end (not in the middle of it)
+			memset(editor.rowVisitTable, 0, MOD_ORDERS * MOD_ROWS);
+		}
+	}
+
+	songEnded = false;
+
+	if (editor.songPlaying)
+	{
+		normalPlay = (editor.playMode == PLAY_MODE_NORMAL);
+
+		if (!intMusic())
+			songEnded = true; // the song loops from here
+		else if (!editor.songPlaying && normalPlay)
+			songStopped = true; // F00, the next song starts when it's loaded
+	}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pt2_unicode.h"
+
+void playlistClear(void);
+bool playlistAdd(const UNICHAR *dirU, const UNICHAR *nameU); // dirU can be NULL (nameU is a full path then)
+bool playlistAddM3U(UNICHAR *fileName); // adds all entries of an .m3u/.m3u8 file
+bool isPlaylistFile(const UNICHAR *fileName);
+void playlistStart(int32_t entry); // loads the entry and starts playing, the playlist keeps going from there
+void playlistStop(void); // the current song keeps playing
+void updatePlaylist(void); // main thread, every frame
+void playlistTick(void); // audio thread, replaces intMusic() while the playlist is active
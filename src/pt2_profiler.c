@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pt2_header.h"
+#include "pt2_helpers.h"
+#include "pt2_textout.h"
+#include "pt2_tables.h"
+#include "pt2_palette.h"
+#include "pt2_visuals.h"
+#include "pt2_profiler.h"
+
+#define OVERLAY_W ((26 * FONT_CHAR_W) + 3)
+#define OVERLAY_H (((PROF_STAGE_NUM + 1) * (FONT_CHAR_H + 1)) + 3)
+
+static const char *stageNames[PROF_STAGE_NUM] =
+{
+	"INPUT", "MOD2WAV", "SONGINFO1", "SONGINFO2", "EDITOP", "PATTERN", "DISKOP", "SAMPLER",
+	"POSED", "VISUALIZER", "DRAGBARS", "SMPLLINE", "RENDER", "FLIP", "PRESENT", "FRAME"
+};
+
+static bool skipFrame, statsDirty;
+static uint32_t statsCounter, overlayBuffer[SCREEN_W * OVERLAY_H], sortBuffer[PROFILER_FRAMES];
+static double dAvgMicro[PROF_STAGE_NUM], dP99Micro[PROF_STAGE_NUM];
+static SDL_Texture *overlayTexture;
+
+profiler_t profiler; // global
+
+extern SDL_Renderer *renderer; // pt2_main.c
+
+static int tickCmp(const void *a, const void *b)
+{
+	const uint32_t x = *(const uint32_t *)a;
+	const uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void calcStats(void)
+{
+	uint32_t n;
+	uint64_t sum;
+
+	n = profiler.framesRecorded;
+	if (n == 0)
+		return;
+
+	for (int32_t i = 0; i < PROF_STAGE_NUM; i++)
+	{
+		memcpy(sortBuffer, profiler.ticks[i], n * sizeof (uint32_t));
+		qsort(sortBuffer, n, sizeof (uint32_t), tickCmp);
+
+		sum = 0;
+		for (uint32_t j = 0; j < n; j++)
+			sum += sortBuffer[j];
+
+		dAvgMicro[i] = ((double)sum / n) * editor.dPerfFreqMulMicro;
+		dP99Micro[i] = sortBuffer[(n * 99) / 100] * editor.dPerfFreqMulMicro;
+	}
+}
+
+void toggleProfiler(void)
+{
+	profiler.enabled ^= 1;
+	if (profiler.enabled)
+	{
+		profiler.frame = 0;
+		profiler.framesRecorded = 0;
+		memset(dAvgMicro, 0, sizeof (dAvgMicro));
+		memset(dP99Micro, 0, sizeof (dP99Micro));
+
+		skipFrame = true; // the current frame is only partially timed
+		statsCounter = 0;
+		statsDirty = true;
+	}
+
+	displayMsg(profiler.enabled ? "PROFILER: ON" : "PROFILER: OFF");
+}
+
+void profilerEndFrame(void)
+{
+	if (!profiler.enabled)
+		return;
+
+	if (skipFrame)
+	{
+		skipFrame = false;
+		return;
+	}
+
+	if (++profiler.frame >= PROFILER_FRAMES)
+		profiler.frame = 0;
+
+	if (profiler.framesRecorded < PROFILER_FRAMES)
+		profiler.framesRecorded++;
+
+	if (++statsCounter >= PROFILER_STATS_INTERVAL)
+	{
+		statsCounter = 0;
+
+		calcStats();
+		statsDirty = true;
+	}
+}
+
+static void drawOverlay(void)
+{
+	char lineText[64];
+	uint32_t bgColor, y;
+
+	bgColor = palette[PAL_BACKGRD];
+	for (int32_t i = 0; i < SCREEN_W * OVERLAY_H; i++)
+		overlayBuffer[i] = bgColor;
+
+	textOutBg(overlayBuffer, 2, 2, "STAGE      AVG(US) P99(US)", palette[PAL_QADSCP], bgColor);
+
+	y = 2 + (FONT_CHAR_H + 1);
+	for (int32_t i = 0; i < PROF_STAGE_NUM; i++, y += FONT_CHAR_H + 1)
+	{
+		sprintf(lineText, "%-10s %7.1f %7.1f", stageNames[i], dAvgMicro[i], dP99Micro[i]);
+		textOutBg(overlayBuffer, 2, y, lineText, palette[PAL_GENTXT], bgColor);
+	}
+
+	SDL_UpdateTexture(overlayTexture, NULL, overlayBuffer, SCREEN_W * sizeof (int32_t));
+}
+
+void renderProfilerOverlay(void)
+{
+	int32_t logicalW, logicalH;
+	SDL_Rect dstRect;
+
+	if (!profiler.enabled)
+		return;
+
+	if (overlayTexture == NULL)
+	{
+		overlayTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, OVERLAY_W, OVERLAY_H);
+		if (overlayTexture == NULL)
+		{
+			profiler.enabled = false;
+			return;
+		}
+
+		SDL_SetTextureBlendMode(overlayTexture, SDL_BLENDMODE_NONE);
+		statsDirty = true;
+	}
+
+	if (statsDirty)
+	{
+		statsDirty = false;
+		drawOverlay();
+	}
+
+	SDL_RenderGetLogicalSize(renderer, &logicalW, &logicalH);
+	if (logicalW <= 0 || logicalH <= 0)
+	{
+		logicalW = SCREEN_W;
+		logicalH = SCREEN_H;
+	}
+
+	// top left corner, scaled like the sprites
+	dstRect.x = 0;
+	dstRect.y = 0;
+	dstRect.w = (OVERLAY_W * logicalW) / SCREEN_W;
+	dstRect.h = (OVERLAY_H * logicalH) / SCREEN_H;
+
+	SDL_RenderCopy(renderer, overlayTexture, NULL, &dstRect);
+}
+
+bool dumpProfilerStats(void)
+{
+	UNICHAR pathU[PATH_MAX + 32];
+	FILE *f;
+
+	if (!profiler.enabled || profiler.framesRecorded == 0)
+	{
+		displayMsg("NO PROFILE DATA !");
+		return false;
+	}
+
+	// in the config directory, Disk Op. changes the current directory
+	f = getConfigFilePath(pathU, "pt2-profile.txt") ? UNICHAR_FOPEN(pathU, "w") : NULL;
+	if (f == NULL)
+	{
+		displayErrorMsg("FILE I/O ERROR");
+		return false;
+	}
+
+	calcStats();
+
+	fprintf(f, "pt2-clone render stage profile (%u frames)\n\n", profiler.framesRecorded);
+	fprintf(f, "%-10s %10s %10s\n", "stage", "avg (us)", "p99 (us)");
+	for (int32_t i = 0; i < PROF_STAGE_NUM; i++)
+		fprintf(f, "%-10s %10.2f %10.2f\n", stageNames[i], dAvgMicro[i], dP99Micro[i]);
+
+	fclose(f);
+
+	displayMsg("PROFILE SAVED !");
+	return true;
+}
+
+void freeProfiler(void)
+{
+	if (overlayTexture != NULL)
+	{
+		SDL_DestroyTexture(overlayTexture);
+		overlayTexture = NULL;
+	}
+
+	profiler.enabled = false;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// per-frame render stage profiler (toggled with ALT+F12, ALT+SHIFT+F12 dumps to a file)
+
+#define PROFILER_FRAMES 256 /* ring buffer length, in frames */
+#define PROFILER_STATS_INTERVAL 30 /* recalculate overlay stats every n frames */
+
+enum
+{
+	PROF_HANDLE_INPUT = 0,
+	PROF_MOD2WAV = 1,
+	PROF_SONG_INFO1 = 2,
+	PROF_SONG_INFO2 = 3,
+	PROF_EDIT_OP = 4,
+	PROF_PATTERN = 5,
+	PROF_DISK_OP = 6,
+	PROF_SAMPLER = 7,
+	PROF_POS_ED = 8,
+	PROF_VISUALIZER = 9,
+	PROF_DRAG_BARS = 10,
+	PROF_SAMPLER_LINE = 11,
+	PROF_RENDER_FRAME = 12,
+	PROF_FLIP_FRAME = 13,
+	PROF_PRESENT = 14,
+	PROF_WHOLE_FRAME = 15,
+
+	PROF_STAGE_NUM
+};
+
+typedef struct profiler_t
+{
+	bool enabled;
+	uint32_t frame, framesRecorded;
+	uint64_t start64[PROF_STAGE_NUM];
+	uint32_t ticks[PROF_STAGE_NUM][PROFILER_FRAMES];
+} profiler_t;
+
+extern profiler_t profiler; // pt2_profiler.c
+
+// these cost one branch when the profiler is off
+static inline void profilerBegin(uint8_t stage)
+{
+	if (profiler.enabled)
+		profiler.start64[stage] = SDL_GetPerformanceCounter();
+}
+
+static inline void profilerEnd(uint8_t stage)
+{
+	if (profiler.enabled)
+		profiler.ticks[stage][profiler.frame] = (uint32_t)(SDL_GetPerformanceCounter() - profiler.start64[stage]);
+}
+
+void toggleProfiler(void);
+void profilerEndFrame(void);
+void renderProfilerOverlay(void); // call between SDL_RenderCopy() and SDL_RenderPresent()
+bool dumpProfilerStats(void);
+void freeProfiler(void);
@@ -730,6 +730,7 @@ bool loadWAVSample(UNICHAR *fileName, char *entryName, int8_t forceDownSampling)
 	editor.samplePos = 0;
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 	updateCurrSample();
 
 	updateWindowTitle(MOD_IS_MODIFIED);
@@ -1000,6 +1001,7 @@ bool loadIFFSample(UNICHAR *fileName, char *entryName)
 	editor.samplePos = 0;
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 	updateCurrSample();
 
 	updateWindowTitle(MOD_IS_MODIFIED);
@@ -1057,6 +1059,7 @@ bool loadRAWSample(UNICHAR *fileName, char *entryName)
 	editor.samplePos = 0;
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 	updateCurrSample();
 
 	updateWindowTitle(MOD_IS_MODIFIED);
@@ -1530,6 +1533,7 @@ bool loadAIFFSample(UNICHAR *fileName, char *entryName, int8_t forceDownSampling
 	editor.samplePos = 0;
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 	updateCurrSample();
 
 	updateWindowTitle(MOD_IS_MODIFIED);
@@ -1844,6 +1848,7 @@ bool saveSample(bool checkIfFileExist, bool giveNewFreeFilename)
 	fclose(f);
 
 	editor.diskop.cached = false;
+	editor.diskop.rescan = true;
 	if (editor.ui.diskOpScreenShown)
 		editor.ui.updateDiskOpFileList = true;
 
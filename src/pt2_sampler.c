@@ -22,13 +22,27 @@
 #define SAMPLE_AREA_Y_CENTER 169
 #define SAMPLE_AREA_HEIGHT 64
 
+/* Level n of the peak pyramid holds the min/max of aligned blocks of 2^n
+** sample points (n = 1..16, 2..64K). Only whole blocks are stored, so the
+** total size of all levels can never exceed the sample length itself. */
+#define PEAK_LEVELS 16
+
 typedef struct sampleMixer_t
 {
 	int32_t length, pos;
 	uint32_t posFrac, delta;
 } sampleMixer_t;
 
+typedef struct peakPyramid_t
+{
+	bool dirty;
+	const int8_t *smpPtr;
+	int32_t smpLen, levelOffset[PEAK_LEVELS+1], levelLength[PEAK_LEVELS+1];
+	int8_t min[MAX_SAMPLE_LEN], max[MAX_SAMPLE_LEN];
+} peakPyramid_t;
+
 static int32_t samOffsetScaled;
+static peakPyramid_t peaks = { .dirty = true };
 
 static const int8_t tuneToneData[32] = // Tuning Tone (Sine Wave)
 {
@@ -50,12 +64,156 @@ static void updateSamOffset(void)
 		samOffsetScaled = (editor.sampler.samOffset * SAMPLE_AREA_WIDTH) / editor.sampler.samDisplay;
 }
 
+static void buildPeakBlocks(int32_t level, int32_t from, int32_t to) // from/to = block index
+{
+	int8_t *minDst, *maxDst, smpMin, smpMax, a, b;
+	const int8_t *minSrc, *maxSrc;
+
+	if (to > peaks.levelLength[level])
+		to = peaks.levelLength[level];
+
+	minDst = &peaks.min[peaks.levelOffset[level]];
+	maxDst = &peaks.max[peaks.levelOffset[level]];
+
+	if (level == 1)
+	{
+		// first level is built from the raw sample data
+		for (int32_t i = from; i < to; i++)
+		{
+			a = peaks.smpPtr[(i << 1) + 0];
+			b = peaks.smpPtr[(i << 1) + 1];
+
+			minDst[i] = (a < b) ? a : b;
+			maxDst[i] = (a > b) ? a : b;
+		}
+	}
+	else
+	{
+		minSrc = &peaks.min[peaks.levelOffset[level-1]];
+		maxSrc = &peaks.max[peaks.levelOffset[level-1]];
+
+		for (int32_t i = from; i < to; i++)
+		{
+			smpMin = minSrc[(i << 1) + 0];
+			smpMax = maxSrc[(i << 1) + 0];
+
+			if (minSrc[(i << 1) + 1] < smpMin) smpMin = minSrc[(i << 1) + 1];
+			if (maxSrc[(i << 1) + 1] > smpMax) smpMax = maxSrc[(i << 1) + 1];
+
+			minDst[i] = smpMin;
+			maxDst[i] = smpMax;
+		}
+	}
+}
+
+static void updatePeakRange(int32_t from, int32_t to) // from/to = sample point (to is exclusive)
+{
+	if (from < 0)
+		from = 0;
+
+	if (to > peaks.smpLen)
+		to = peaks.smpLen;
+
+	if (from >= to)
+		return;
+
+	for (int32_t level = 1; level <= PEAK_LEVELS; level++)
+	{
+		if (peaks.levelLength[level] == 0)
+			break;
+
+		buildPeakBlocks(level, from >> level, ((to - 1) >> level) + 1);
+	}
+}
+
+static void buildPeaks(const int8_t *smpPtr, int32_t smpLen)
+{
+	int32_t offset;
+
+	peaks.smpPtr = smpPtr;
+	peaks.smpLen = smpLen;
+
+	offset = 0;
+	for (int32_t level = 1; level <= PEAK_LEVELS; level++)
+	{
+		peaks.levelOffset[level] = offset;
+		peaks.levelLength[level] = smpLen >> level;
+		offset += peaks.levelLength[level];
+	}
+	assert(offset <= MAX_SAMPLE_LEN);
+
+	updatePeakRange(0, smpLen);
+	peaks.dirty = false;
+}
+
+// sample data of the displayed sample has changed, rebuild peaks on next draw
+void invalidateSamplePeaks(void)
+{
+	peaks.dirty = true;
+}
+
+// patch the peak pyramid after a small edit, if it covers this sample data
+void updateSamplePeaks(const int8_t *smpPtr, int32_t from, int32_t to)
+{
+	if (peaks.dirty || smpPtr != peaks.smpPtr)
+		return;
+
+	updatePeakRange(from, to);
+}
+
+/* Gets the min/max of sample points from..to-1 by walking up the pyramid.
+** Unaligned blocks at the edges of each level are picked up on the way, so
+** this is at most two lookups per level, regardless of the range length. */
+static void getPeakRange(int32_t from, int32_t to, int8_t *outMin, int8_t *outMax)
+{
+	const int8_t *minPtr, *maxPtr;
+	int8_t smpMin, smpMax;
+	int32_t level;
+
+	smpMin =  127;
+	smpMax = -128;
+
+	minPtr = maxPtr = peaks.smpPtr; // level 0 is the sample data itself
+	for (level = 0; from < to; level++)
+	{
+		assert(level <= PEAK_LEVELS);
+
+		if (from & 1)
+		{
+			if (minPtr[from] < smpMin) smpMin = minPtr[from];
+			if (maxPtr[from] > smpMax) smpMax = maxPtr[from];
+			from++;
+		}
+
+		if (to & 1)
+		{
+			to--;
+			if (minPtr[to] < smpMin) smpMin = minPtr[to];
+			if (maxPtr[to] > smpMax) smpMax = maxPtr[to];
+		}
+
+		from >>= 1;
+		to >>= 1;
+
+		if (level < PEAK_LEVELS)
+		{
+			minPtr = &peaks.min[peaks.levelOffset[level+1]];
+			maxPtr = &peaks.max[peaks.levelOffset[level+1]];
+		}
+	}
+
+	*outMin = smpMin;
+	*outMax = smpMax;
+}
+
 void fixSampleBeep(moduleSample_t *s)
 {
 	if (s->length >= 2 && s->loopStart+s->loopLength <= 2)
 	{
 		modEntry->sampleData[s->offset+0] = 0;
 		modEntry->sampleData[s->offset+1] = 0;
+
+		updateSamplePeaks(&modEntry->sampleData[s->offset], 0, 2);
 	}
 }
 
@@ -249,19 +407,11 @@ int32_t scr2SmpPos(int32_t x) // screen x pos -> sample pos
 	return x;
 }
 
-static void getSampleDataPeak(int8_t *smpPtr, int32_t numBytes, int16_t *outMin, int16_t *outMax)
+static void getSampleDataPeak(int32_t smpIdx, int32_t numBytes, int16_t *outMin, int16_t *outMax)
 {
-	int8_t smp, smpMin, smpMax;
+	int8_t smpMin, smpMax;
 
-	smpMin =  127;
-	smpMax = -128;
-
-	for (int32_t i = 0; i < numBytes; i++)
-	{
-		smp = smpPtr[i];
-		if (smp < smpMin) smpMin = smp;
-		if (smp > smpMax) smpMax = smp;
-	}
+	getPeakRange(smpIdx, smpIdx + numBytes, &smpMin, &smpMax);
 
 	*outMin = SAMPLE_AREA_Y_CENTER - (smpMin >> 2);
 	*outMax = SAMPLE_AREA_Y_CENTER - (smpMax >> 2);
@@ -317,6 +467,9 @@ static void renderSampleData(void)
 			oldMax = y1;
 
 			smpPtr = &modEntry->sampleData[s->offset];
+			if (peaks.dirty || peaks.smpPtr != smpPtr || peaks.smpLen != editor.sampler.samLength)
+				buildPeaks(smpPtr, editor.sampler.samLength);
+
 			for (x = 0; x < SAMPLE_AREA_WIDTH; x++)
 			{
 				smpIdx = scr2SmpPos(x);
@@ -324,12 +477,12 @@ static void renderSampleData(void)
 
 				// prevent look-up overflow (yes, this can happen near the end of the sample)
 				if (smpIdx+smpNum > editor.sampler.samLength)
-					smpNum = editor.sampler.samLength - smpNum;
+					smpNum = editor.sampler.samLength - smpIdx;
 
 				if (smpNum < 1)
 					smpNum = 1;
 
-				getSampleDataPeak(&smpPtr[smpIdx], smpNum, &min, &max);
+				getSampleDataPeak(smpIdx, smpNum, &min, &max);
 
 				if (x > 0)
 				{
@@ -420,6 +573,7 @@ void redrawSample(void)
 		if (editor.currSample >= 0 && editor.currSample <= 30)
 		{
 			editor.markStartOfs = -1;
+			invalidateSamplePeaks();
 
 			editor.sampler.samOffset = 0;
 			updateSamOffset();
@@ -555,6 +709,7 @@ void highPassSample(int32_t cutOff)
 	free(dSampleData);
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 	displaySample();
 	updateWindowTitle(MOD_IS_MODIFIED);
 }
@@ -662,6 +817,7 @@ void lowPassSample(int32_t cutOff)
 	free(dSampleData);
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 	displaySample();
 	updateWindowTitle(MOD_IS_MODIFIED);
 }
@@ -697,6 +853,7 @@ void redoSampleData(int8_t sample)
 	displayMsg("SAMPLE RESTORED !");
 
 	editor.samplePos = 0;
+	invalidateSamplePeaks();
 	updateCurrSample();
 
 	// this routine can be called while the sampler toolboxes are open, so redraw them
@@ -823,6 +980,7 @@ void samplerRemoveDcOffset(void)
 	}
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 	displaySample();
 	updateWindowTitle(MOD_IS_MODIFIED);
 }
@@ -1071,6 +1229,7 @@ void mixChordSample(void)
 
 	editor.samplePos = 0;
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 	updateCurrSample();
 
 	updateWindowTitle(MOD_IS_MODIFIED);
@@ -1184,6 +1343,7 @@ void samplerResample(void)
 	}
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 	updateCurrSample();
 	updateWindowTitle(MOD_IS_MODIFIED);
 }
@@ -1298,6 +1458,7 @@ void doMix(void)
 	editor.samplePos = 0;
 
 	fixSampleBeep(s3);
+	invalidateSamplePeaks();
 	updateCurrSample();
 	updateWindowTitle(MOD_IS_MODIFIED);
 }
@@ -1354,6 +1515,7 @@ void boostSample(int8_t sample, bool ignoreMark)
 	}
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
 
 	// don't redraw sample here, it is done elsewhere
 }
@@ -1407,6 +1569,8 @@ void filterSample(int8_t sample, bool ignoreMark)
 	}
 
 	fixSampleBeep(s);
+	invalidateSamplePeaks();
+
 	// don't redraw sample here, it is done elsewhere
 }
 
@@ -1430,9 +1594,6 @@ void toggleTuningTone(void)
 		paulaSetData(editor.tuningChan, tuneToneData);
 		paulaSetLength(editor.tuningChan, sizeof (tuneToneData));
 		paulaStartDMA(editor.tuningChan);
-
-		// force loop flag on for scopes
-		scopeExt[editor.tuningChan].newLoopFlag = scope[editor.tuningChan].loopFlag = true;
 	}
 	else
 	{
@@ -1754,6 +1915,7 @@ void samplerSamDelete(uint8_t cut)
 	fixSampleBeep(s);
 	updateSamplePos();
 	recalcChordLength();
+	invalidateSamplePeaks();
 	displaySample();
 
 	editor.ui.updateCurrSampleLength = true;
@@ -1875,6 +2037,7 @@ void samplerSamPaste(void)
 	fixSampleBeep(s);
 	updateSamplePos();
 	recalcChordLength();
+	invalidateSamplePeaks();
 
 	if (wasZooming)
 		displaySample();
@@ -1928,8 +2091,6 @@ void samplerPlayWaveform(void)
 	// these take effect after the current DMA cycle is done
 	paulaSetData(chn, ch->n_loopstart);
 	paulaSetLength(chn, ch->n_replen);
-
-	updateSpectrumAnalyzer(ch->n_volume, ch->n_period);
 }
 
 void samplerPlayDisplay(void)
@@ -1973,8 +2134,6 @@ void samplerPlayDisplay(void)
 	// these take effect after the current DMA cycle is done
 	paulaSetData(chn, NULL);
 	paulaSetLength(chn, 1);
-
-	updateSpectrumAnalyzer(ch->n_volume, ch->n_period);
 }
 
 void samplerPlayRange(void)
@@ -2030,8 +2189,6 @@ void samplerPlayRange(void)
 	// these take effect after the current DMA cycle is done
 	paulaSetData(chn, NULL);
 	paulaSetLength(chn, 1);
-
-	updateSpectrumAnalyzer(ch->n_volume, ch->n_period);
 }
 
 void setLoopSprites(void)
@@ -2391,7 +2548,7 @@ static int8_t yToSmpY(int32_t mouseY)
 void samplerEditSample(bool mouseButtonHeld)
 {
 	int8_t y;
-	int32_t mouseY, x, smp_x0, smp_x1, xDistance, smp_y0, smp_y1, yDistance, smp;
+	int32_t mouseY, x, smp_x0, smp_x1, xDistance, smp_y0, smp_y1, yDistance, smp, editFrom, editTo;
 	moduleSample_t *s;
 
 	assert(editor.currSample >= 0 && editor.currSample <= 30);
@@ -2428,6 +2585,9 @@ void samplerEditSample(bool mouseButtonHeld)
 
 	modEntry->sampleData[s->offset+x] = y;
 
+	editFrom = x;
+	editTo = x + 1;
+
 	// interpolate x gaps
 	if (input.mouse.x != editor.sampler.lastMouseX)
 	{
@@ -2444,6 +2604,8 @@ void samplerEditSample(bool mouseButtonHeld)
 			xDistance = smp_x1 - smp_x0;
 			if (xDistance > 0)
 			{
+				editFrom = smp_x0;
+
 				for (x = smp_x0; x < smp_x1; x++)
 				{
 					assert(x < s->length);
@@ -2462,6 +2624,8 @@ void samplerEditSample(bool mouseButtonHeld)
 			xDistance = smp_x1 - smp_x0;
 			if (xDistance > 0)
 			{
+				editTo = smp_x1;
+
 				for (x = smp_x0; x < smp_x1; x++)
 				{
 					assert(x < s->length);
@@ -2479,6 +2643,7 @@ void samplerEditSample(bool mouseButtonHeld)
 			editor.sampler.lastMouseY = input.mouse.y;
 	}
 
+	updateSamplePeaks(&modEntry->sampleData[s->offset], editFrom, editTo);
 	displaySample();
 }
 
@@ -2744,6 +2909,9 @@ void samplerScreen(void)
 		return;
 	}
 
+	if (!unpackLazyBMP(&samplerScreenBMP))
+		return;
+
 	editor.ui.samplerScreenShown = true;
 	memcpy(&pixelBuffer[(121 * SCREEN_W)], samplerScreenBMP, 320 * 134 * sizeof (int32_t));
 	hideSprite(SPRITE_PATTERN_CURSOR);
@@ -6,6 +6,8 @@
 int32_t smpPos2Scr(int32_t pos);
 int32_t scr2SmpPos(int32_t x);
 void fixSampleBeep(moduleSample_t *s);
+void invalidateSamplePeaks(void);
+void updateSamplePeaks(const int8_t *smpPtr, int32_t from, int32_t to);
 void highPassSample(int32_t cutOff);
 void lowPassSample(int32_t cutOff);
 void samplerRemoveDcOffset(void);
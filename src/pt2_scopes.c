@@ -5,10 +5,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include <math.h> // modf()
-#ifndef _WIN32
-#include <unistd.h> // usleep()
-#endif
+#include <string.h>
+#include <math.h> // fabsf()
 #include "pt2_header.h"
 #include "pt2_helpers.h"
 #include "pt2_visuals.h"
@@ -17,17 +15,28 @@
 #include "pt2_palette.h"
 #include "pt2_tables.h"
 
-// this uses code that is not entirely thread safe, but I have never had any issues so far...
+/* The audio thread publishes mixer snapshots into a ring of seqlocked slots.
+** A slot's sequence number is odd while it's being written, and the reader
+** retries with an older slot if the number changed during its copy. The
+** writer never waits for the reader, and nobody spins.
+*/
+
+typedef struct scopeSlot_t
+{
+	SDL_atomic_t seq;
+	uint32_t index; // ring write position this slot was written at
+	scopeSnapshot_t snapshot;
+} scopeSlot_t;
 
-static volatile bool scopesReading;
-static uint32_t scopeTimeLen, scopeTimeLenFrac;
-static uint64_t timeNext64, timeNext64Frac;
-static SDL_Thread *scopeThread;
+static uint32_t snapshotClearPos, tapDisplayPos; // main thread only
+static SDL_atomic_t snapshotWritePos, tapReadablePos;
+static scopeSlot_t slots[SCOPE_SNAPSHOTS];
 
 scopeChannel_t scope[4]; // global
-scopeChannelExt_t scopeExt[4]; // global
+scopeTap_t scopeTap[4]; // global
+float fMixTap[SCOPE_TAP_LEN]; // global
+uint32_t scopeTapWritePos; // global
 
-extern bool forceMixerOff; // pt_audio.c
 extern uint32_t *pixelBuffer; // pt_main.c
 
 int32_t getSampleReadPos(uint8_t ch, uint8_t smpNum)
@@ -43,7 +52,7 @@ int32_t getSampleReadPos(uint8_t ch, uint8_t smpNum)
 	data = sc->data;
 	pos = sc->pos;
 
-	if (scopeExt[ch].active && pos >= 2)
+	if (sc->active && pos >= 2)
 	{
 		s = &modEntry->samples[smpNum];
 
@@ -60,180 +69,282 @@ int32_t getSampleReadPos(uint8_t ch, uint8_t smpNum)
 	return -1;
 }
 
-void setScopeDelta(uint8_t ch, uint32_t delta)
+// called from the audio thread once per mixed chunk (replayer tick)
+void publishScopeSnapshot(const scopeSnapshot_t *snapshot)
 {
-	scope[ch].delta = delta;
+	int32_t seq;
+	uint32_t writePos;
+	scopeSlot_t *slot;
+
+	writePos = (uint32_t)SDL_AtomicGet(&snapshotWritePos);
+	slot = &slots[writePos & (SCOPE_SNAPSHOTS-1)];
+
+	/* SDL_AtomicSet() is only an acquire barrier with GCC/Clang (__sync_lock_test_and_set),
+	** so the stores are ordered with explicit release barriers, like a plain seqlock. */
+	seq = SDL_AtomicGet(&slot->seq);
+	SDL_AtomicSet(&slot->seq, seq + 1); // odd: write in progress
+	SDL_MemoryBarrierRelease();
+
+	slot->index = writePos;
+	slot->snapshot = *snapshot;
+
+	SDL_MemoryBarrierRelease(); // the data must be visible before the even sequence number
+	SDL_AtomicSet(&slot->seq, seq + 2);
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&snapshotWritePos, (int32_t)(writePos + 1));
 }
 
-void updateScopes(void)
+/* Moves a tap read window so that it lies inside the part of the taps
+** that has been written, and that the mixer won't overwrite soon. */
+static uint32_t clampTapWindow(uint32_t readPos, uint32_t windowLen)
 {
-	scopeChannel_t *sc, tmp;
-	scopeChannelExt_t *se, tmpExt;
+	const uint32_t readablePos = (uint32_t)SDL_AtomicGet(&tapReadablePos);
 
-	if (editor.isWAVRendering)
-		return;
+	if ((int32_t)(readablePos - readPos) < (int32_t)windowLen)
+		readPos = readablePos - windowLen;
+	else if (readablePos - readPos > SCOPE_TAP_LEN / 2)
+		readPos = readablePos - (SCOPE_TAP_LEN / 2);
 
-	for (uint32_t i = 0; i < AMIGA_VOICES; i++)
-	{
-		sc = &scope[i];
-		se = &scopeExt[i];
+	return readPos;
+}
 
-		// cache these
-		tmp = *sc;
-		tmpExt = *se;
+// copies numSamples of the final mix, centered on what is currently heard
+void getMixTapWindow(float *fDst, int32_t numSamples)
+{
+	uint32_t readPos;
 
-		if (!tmpExt.active)
-			continue; // scope is not active
+	readPos = clampTapWindow(tapDisplayPos - (numSamples / 2), numSamples);
+	for (int32_t i = 0; i < numSamples; i++)
+		fDst[i] = fMixTap[(readPos + i) & SCOPE_TAP_MASK];
+}
 
-		tmp.posFrac += tmp.delta;
-		tmp.pos += tmp.posFrac >> 16;
-		tmp.posFrac &= 0xFFFF;
+// returns false if the slot is being written or has been reused for a newer snapshot
+static bool readSnapshot(uint32_t index, scopeSnapshot_t *dst)
+{
+	int32_t seq;
+	uint32_t slotIndex;
+	scopeSlot_t *slot;
 
-		if (tmp.pos >= tmp.length)
-		{
-			// sample reached end, simulate Paula register update (sample swapping)
+	slot = &slots[index & (SCOPE_SNAPSHOTS-1)];
+
+	seq = SDL_AtomicGet(&slot->seq);
+	if (seq & 1)
+		return false;
 
-			/* wrap pos around one time with current length, then set new length
-			** and wrap around it (handles one-shot loops and sample swapping) */
-			tmp.pos -= tmp.length;
-			tmp.length = tmpExt.newLength;
+	SDL_MemoryBarrierAcquire(); // don't read the data before the sequence number
+	slotIndex = slot->index;
+	*dst = slot->snapshot;
 
-			if (tmp.length > 0)
-				tmp.pos %= tmp.length;
+	SDL_MemoryBarrierAcquire(); // ...or the sequence number before the data
+	if (SDL_AtomicGet(&slot->seq) != seq)
+		return false;
+
+	return slotIndex == index;
+}
+
+static float getTapPeak(const float *fSrc, int32_t numSamples)
+{
+	float fPeak = 0.0f;
 
-			tmp.data = tmpExt.newData;
-			tmp.loopFlag = tmpExt.newLoopFlag;
-			tmp.loopStart = tmpExt.newLoopStart;
+	// simple enough for the compiler to vectorize
+	for (int32_t i = 0; i < numSamples; i++)
+	{
+		const float fSmp = fabsf(fSrc[i]);
+		fPeak = (fSmp > fPeak) ? fSmp : fPeak;
+	}
 
-			se->didSwapData = true;
+	return fPeak;
+}
+
+/* Called from the mixer after it has written numSamples to each voice tap
+** and the mix tap, starting at scopeTapWritePos. Calculates the block peaks for the real
+** VU-meters and makes the new samples visible to the scopes. */
+void publishScopeTap(int32_t numSamples)
+{
+	int32_t peak, oldPeak, samplesToEnd, readPos;
+	float fPeak, fPeak2;
+	scopeTap_t *t;
+
+	readPos = scopeTapWritePos & SCOPE_TAP_MASK;
+	samplesToEnd = SCOPE_TAP_LEN - readPos;
+
+	for (int32_t i = 0; i < AMIGA_VOICES; i++)
+	{
+		t = &scopeTap[i];
+
+		if (numSamples <= samplesToEnd)
+		{
+			fPeak = getTapPeak(&t->fData[readPos], numSamples);
+		}
+		else
+		{
+			fPeak = getTapPeak(&t->fData[readPos], samplesToEnd);
+			fPeak2 = getTapPeak(t->fData, numSamples - samplesToEnd);
+			if (fPeak2 > fPeak)
+				fPeak = fPeak2;
 		}
 
-		*sc = tmp; // update it
+		peak = (int32_t)(fPeak * 32767.0f);
+		if (peak > 32767)
+			peak = 32767;
+
+		// raise the pending peak, the VU-meter update resets it to zero
+		do
+		{
+			oldPeak = SDL_AtomicGet(&t->peak);
+			if (peak <= oldPeak)
+				break;
+		}
+		while (!SDL_AtomicCAS(&t->peak, oldPeak, peak));
 	}
+
+	scopeTapWritePos += numSamples;
+	SDL_AtomicSet(&tapReadablePos, (int32_t)scopeTapWritePos);
 }
 
-/* This routine gets the average sample peak through the running scope voices.
-** This gives a much more smooth and stable result than getting the peak from
-** the mixer, and we don't care about including filters/BLEP in the peak calculation. */
+/* The real VU-meters show the peak of each voice's actual mixer output
+** (after BLEP and volume) since the last update. */
 static void updateRealVuMeters(void) 
 {
-	bool didSwapData;
-	int16_t volume;
-	int32_t i, x, readPos, samplesToScan, smpDat, smpPeak;
-	scopeChannel_t tmpScope, *sc;
-	scopeChannelExt_t *se;
+	int32_t i, smpPeak;
 
-	// sink VU-meters first
 	for (i = 0; i < AMIGA_VOICES; i++)
 	{
+		// sink VU-meters first
 		editor.realVuMeterVolumes[i] -= 3;
 		if (editor.realVuMeterVolumes[i] < 0)
 			editor.realVuMeterVolumes[i] = 0;
+
+		smpPeak = SDL_AtomicSet(&scopeTap[i].peak, 0); // fetch and reset
+		smpPeak = ((smpPeak * 48) + (1 << 14)) >> 15;
+		if (smpPeak > editor.realVuMeterVolumes[i])
+			editor.realVuMeterVolumes[i] = smpPeak;
 	}
+}
 
-	// get peak sample data from running scope voices
-	for (i = 0; i < AMIGA_VOICES; i++)
-	{
-		sc = &scope[i];
-		se = &scopeExt[i];
+/* Interpolates the newest audible mixer snapshot to the current time.
+** Called once per video frame from the main thread. */
+void updateScopes(void)
+{
+	int32_t pos;
+	bool snapshotFound;
+	uint32_t writePos, numSnapshots;
+	uint64_t time64, elapsed64, maxElapsed64;
+	double dOutputSamples;
+	scopeSnapshot_t snapshot;
+	const scopeVoice_t *v;
+	scopeChannel_t *sc, tmp;
 
-		// cache these two
-		tmpScope = *sc;
-		didSwapData = se->didSwapData;
+	if (editor.isWAVRendering)
+		return;
 
-		samplesToScan = tmpScope.delta >> 16;
-		if (samplesToScan <= 0)
-			continue;
+	time64 = SDL_GetPerformanceCounter();
 
-		if (samplesToScan > 512) // don't waste cycles on reading a ton of samples
-			samplesToScan = 512;
+	writePos = (uint32_t)SDL_AtomicGet(&snapshotWritePos);
 
-		volume = modEntry->channels[i].n_volume;
+	numSnapshots = writePos - snapshotClearPos;
+	if (numSnapshots > SCOPE_SNAPSHOTS)
+		numSnapshots = SCOPE_SNAPSHOTS;
 
-		if (se->active && tmpScope.data != NULL && volume != 0 && !editor.muted[i] && tmpScope.length > 0)
-		{
-			smpPeak = 0;
-			readPos = tmpScope.pos;
+	// find the newest snapshot that has reached the speakers (falls back to the oldest one)
+	snapshotFound = false;
+	for (uint32_t i = 1; i <= numSnapshots; i++)
+	{
+		if (!readSnapshot(writePos - i, &snapshot))
+			continue; // overwritten by the audio thread while copying, try an older one
 
-			if (tmpScope.loopFlag)
-			{
-				for (x = 0; x < samplesToScan; x += 2) // loop enabled
-				{
-					if (didSwapData)
-					{
-						if (readPos >= tmpScope.length)
-							readPos %= tmpScope.length; // s.data = loopStartPtr, wrap readPos to 0
-					}
-					else if (readPos >= tmpScope.length)
-					{
-						readPos = tmpScope.loopStart; // s.data = sampleStartPtr, wrap readPos to loop start
-					}
+		snapshotFound = true;
+		if (snapshot.time64 <= time64)
+			break;
+	}
 
-					smpDat = tmpScope.data[readPos] * volume;
+	if (!snapshotFound)
+	{
+		for (uint32_t i = 0; i < AMIGA_VOICES; i++)
+			scope[i].active = false;
+	}
+	else
+	{
+		elapsed64 = (time64 > snapshot.time64) ? (time64 - snapshot.time64) : 0;
 
-					smpDat = ABS(smpDat);
-					if (smpDat > smpPeak)
-						smpPeak = smpDat;
+		// don't run away if the audio thread stalls or the mixer is turned off
+		maxElapsed64 = (uint64_t)((audio.audioBufferSize * 2) * (editor.dPerfFreq / audio.dAudioFreq));
+		if (elapsed64 > maxElapsed64)
+			elapsed64 = maxElapsed64;
 
-					readPos += 2;
-				}
-			}
-			else
+		dOutputSamples = elapsed64 * (audio.dAudioFreq / editor.dPerfFreq);
+		tapDisplayPos = snapshot.tapPos + (uint32_t)dOutputSamples;
+
+		for (uint32_t i = 0; i < AMIGA_VOICES; i++)
+		{
+			v = &snapshot.voice[i];
+			sc = &scope[i];
+
+			tmp.active = v->active && v->data != NULL && v->length > 0;
+			tmp.emptyScopeDrawn = sc->emptyScopeDrawn;
+			tmp.data = v->data;
+			tmp.newData = (v->newData != NULL) ? v->newData : &modEntry->sampleData[RESERVED_SAMPLE_OFFSET];
+			tmp.length = v->length;
+			tmp.newLength = v->newLength;
+
+			pos = v->pos + (int32_t)(v->dPhase + (dOutputSamples * v->dDelta));
+			if (tmp.active && pos >= tmp.length)
 			{
-				for (x = 0; x < samplesToScan; x += 2) // no loop
-				{
-					if (readPos >= tmpScope.length)
-						break;
+				// sample reached end, simulate Paula register update (sample swapping)
 
-					smpDat = tmpScope.data[readPos] * volume;
+				/* wrap pos around one time with current length, then set new length
+				** and wrap around it (handles one-shot loops and sample swapping) */
+				pos -= tmp.length;
+				tmp.length = tmp.newLength;
 
-					smpDat = ABS(smpDat);
-					if (smpDat > smpPeak)
-						smpPeak = smpDat;
+				if (tmp.length > 0)
+					pos %= tmp.length;
 
-					readPos += 2;
-				}
+				tmp.data = tmp.newData;
 			}
+			tmp.pos = pos;
 
-			smpPeak = ((smpPeak * 48) + (1 << 12)) >> 13;
-			if (smpPeak > editor.realVuMeterVolumes[i])
-				editor.realVuMeterVolumes[i] = smpPeak;
+			*sc = tmp; // update it
 		}
 	}
+
+	if (ptConfig.realVuMeters)
+		updateRealVuMeters();
 }
 
 void drawScopes(void)
 {
-	bool didSwapData;
-	int16_t scopeData, volume;
-	int32_t i, x, y, readPos;
-	uint32_t *dstPtr, *scopePtr, scopePixel;
-	scopeChannel_t tmpScope, *sc;
-	scopeChannelExt_t *se;
-
-	scopesReading = true;
+	const float *fTapData;
+	int16_t volume;
+	int32_t i, x, y, scopeData;
+	uint32_t *dstPtr, *scopePtr, scopePixel, readPos, windowLen, delta, posFrac;
+	scopeChannel_t *sc;
+
 	if (editor.ui.visualizerMode == VISUAL_QUADRASCOPE)
 	{
 		// --- QUADRASCOPE ---
 
+		/* One pixel per output sample would only show a fraction of a millisecond,
+		** so step through the tap at the rate of a C-2 note. C-2 looks like on
+		** the Amiga, other notes are compressed/stretched like on an oscilloscope. */
+		delta = (uint32_t)((audio.dAudioFreq / (PAULA_PAL_CLK / 428.0)) * 65536.0);
+		windowLen = ((SCOPE_WIDTH * delta) >> 16) + 1;
+
+		readPos = clampTapWindow(tapDisplayPos, windowLen);
+
 		scopePtr = &pixelBuffer[(71 * SCREEN_W) + 128];
 		for (i = 0; i < AMIGA_VOICES; i++)
 		{
 			sc = &scope[i];
-			se = &scopeExt[i];
 
-			// cache these two
-			tmpScope = *sc;
-			didSwapData = se->didSwapData;
-
-			volume = -modEntry->channels[i].n_volume; // 0..64 -> -64..0
+			volume = modEntry->channels[i].n_volume;
 
 			// render scope
-			if (se->active && tmpScope.data != NULL && volume != 0 && !editor.muted[i] && tmpScope.length > 0)
+			if (sc->active && volume != 0 && !editor.muted[i])
 			{
 				// scope is active
 
-				se->emptyScopeDrawn = false;
+				sc->emptyScopeDrawn = false;
 
 				// draw scope background
 
@@ -251,51 +362,23 @@ void drawScopes(void)
 				// render scope data
 
 				scopePixel = palette[PAL_QADSCP];
+				fTapData = scopeTap[i].fData;
 
-				readPos = tmpScope.pos;
-				if (tmpScope.loopFlag)
+				posFrac = 0;
+				for (x = 0; x < SCOPE_WIDTH; x++)
 				{
-					// loop enabled
+					scopeData = (int32_t)(fTapData[(readPos + (posFrac >> 16)) & SCOPE_TAP_MASK] * -16.0f); // -1.0..1.0 -> 16..-16
+					scopeData = CLAMP(scopeData, -16, 16); // BLEP can overshoot slightly
 
-					for (x = 0; x < SCOPE_WIDTH; x++)
-					{
-						if (didSwapData)
-						{
-							if (readPos >= tmpScope.length)
-								readPos %= tmpScope.length; // s.data = loopStartPtr, wrap readPos to 0
-						}
-						else if (readPos >= tmpScope.length)
-						{
-							readPos = tmpScope.loopStart; // s.data = sampleStartPtr, wrap readPos to loop start
-						}
-
-						scopeData = (tmpScope.data[readPos++] * volume) >> 9; // (-128..127)*(-64..0) / 2^9 = -15..16
-						scopePtr[(scopeData * SCREEN_W) + x] = scopePixel;
-					}
-				}
-				else
-				{
-					// no loop
-
-					for (x = 0; x < SCOPE_WIDTH; x++)
-					{
-						if (readPos >= tmpScope.length)
-						{
-							scopePtr[x] = scopePixel; // end of data, draw center pixel
-						}
-						else
-						{
-							scopeData = (tmpScope.data[readPos++] * volume) >> 9; // (-128..127)*(-64..0) / 2^9 = -15..16
-							scopePtr[(scopeData * SCREEN_W) + x] = scopePixel;
-						}
-					}
+					scopePtr[(scopeData * SCREEN_W) + x] = scopePixel;
+					posFrac += delta;
 				}
 			}
 			else
 			{
 				// scope is inactive, draw empty scope once until it gets active again
 
-				if (!se->emptyScopeDrawn)
+				if (!sc->emptyScopeDrawn)
 				{
 					// draw scope background
 
@@ -316,105 +399,22 @@ void drawScopes(void)
 					for (x = 0; x < SCOPE_WIDTH; x++)
 						scopePtr[x] = scopePixel;
 
-					se->emptyScopeDrawn = true;
+					sc->emptyScopeDrawn = true;
 				}
 			}
 
 			scopePtr += SCOPE_WIDTH+8;
 		}
 	}
-	scopesReading = false;
-}
-
-static int32_t SDLCALL scopeThreadFunc(void *ptr)
-{
-	int32_t time32;
-	uint32_t diff32;
-	uint64_t time64;
-
-	(void)ptr;
-
-	// this is needed for scope stability (confirmed)
-	SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
-
-	// set next frame time
-	timeNext64 = SDL_GetPerformanceCounter() + scopeTimeLen;
-	timeNext64Frac = scopeTimeLenFrac;
-
-	while (editor.programRunning)
-	{
-		if (ptConfig.realVuMeters)
-			updateRealVuMeters();
-
-		updateScopes();
-
-		time64 = SDL_GetPerformanceCounter();
-		if (time64 < timeNext64)
-		{
-			assert(timeNext64-time64 <= 0xFFFFFFFFULL);
-			diff32 = (uint32_t)(timeNext64 - time64);
-
-			// convert to microseconds and round to integer
-			time32 = (uint32_t)((diff32 * editor.dPerfFreqMulMicro) + 0.5);
-
-			// delay until we have reached next tick
-			if (time32 > 0)
-				usleep(time32);
-		}
-
-		// update next tick time
-		timeNext64 += scopeTimeLen;
-
-		timeNext64Frac += scopeTimeLenFrac;
-		if (timeNext64Frac >= (1ULL << 32))
-		{
-			timeNext64Frac &= 0xFFFFFFFF;
-			timeNext64++;
-		}
-	}
-
-	return true;
-}
-
-bool initScopes(void)
-{
-	double dInt, dFrac;
-
-	// calculate scope time for performance counters and split into int/frac
-	dFrac = modf(editor.dPerfFreq / SCOPE_HZ, &dInt);
-
-	// integer part
-	scopeTimeLen = (uint32_t)dInt;
-
-	// fractional part scaled to 0..2^32-1
-	dFrac *= UINT32_MAX + 1.0;
-	if (dFrac > (double)UINT32_MAX)
-		dFrac = (double)UINT32_MAX;
-	scopeTimeLenFrac = (uint32_t)round(dFrac);
-
-	scopeThread = SDL_CreateThread(scopeThreadFunc, NULL, NULL);
-	if (scopeThread == NULL)
-	{
-		showErrorMsgBox("Couldn't create scope thread!");
-		return false;
-	}
-
-	SDL_DetachThread(scopeThread);
-	return true;
-}
-
-void waitOnScopes(void)
-{
-	while (scopesReading);
 }
 
 void clearScopes(void)
 {
-	waitOnScopes();
+	// forget the snapshots published so far (the ring itself is only written by the audio thread)
+	snapshotClearPos = (uint32_t)SDL_AtomicGet(&snapshotWritePos);
 
 	memset(scope, 0, sizeof (scope));
-	memset(scopeExt, 0, sizeof (scopeExt));
 
 	for (uint8_t i = 0; i < AMIGA_VOICES; i++)
-		scope[i].length = scopeExt[i].newLength = 2;
+		scope[i].length = scope[i].newLength = 2;
 }
@@ -1,31 +1,50 @@
 #pragma once
 
+#include <SDL2/SDL.h>
 #include <stdint.h>
 #include <stdbool.h>
 
-typedef struct scopeChannel_t // internal scope state
+#define SCOPE_SNAPSHOTS 32 /* must be 2^n */
+#define SCOPE_TAP_LEN 16384 /* per voice, in output samples, must be 2^n */
+#define SCOPE_TAP_MASK (SCOPE_TAP_LEN-1)
+
+typedef struct scopeVoice_t // mixer voice state, published from the audio thread
+{
+	bool active;
+	const int8_t *data, *newData;
+	int32_t length, newLength, pos;
+	double dPhase, dDelta;
+} scopeVoice_t;
+
+typedef struct scopeSnapshot_t
+{
+	uint64_t time64; // performance counter time when the first sample of the mixed chunk is heard
+	uint32_t tapPos; // mixer tap write position at the start of the chunk
+	scopeVoice_t voice[4];
+} scopeSnapshot_t;
+
+typedef struct scopeChannel_t // voice state interpolated to display time (main thread only)
 {
-	const int8_t *data;
-	bool loopFlag;
-	int32_t length, pos, loopStart;
-	uint32_t delta, posFrac;
+	bool active, emptyScopeDrawn;
+	const int8_t *data, *newData;
+	int32_t length, newLength, pos;
 } scopeChannel_t;
 
-typedef struct scopeChannelExt // external scope state
+typedef struct scopeTap_t // voice output after BLEP and volume, written by the mixer (single producer/consumer)
 {
-	const int8_t *newData;
-	volatile bool active, didSwapData;
-	bool emptyScopeDrawn, newLoopFlag;
-	int32_t newLength, newLoopStart;
-} scopeChannelExt_t;
+	SDL_atomic_t peak; // highest peak since the last VU-meter update (0..32767)
+	float fData[SCOPE_TAP_LEN];
+} scopeTap_t;
 
-void setScopeDelta(uint8_t ch, uint32_t delta);
+void publishScopeSnapshot(const scopeSnapshot_t *snapshot);
+void publishScopeTap(int32_t numSamples);
+void getMixTapWindow(float *fDst, int32_t numSamples);
 int32_t getSampleReadPos(uint8_t ch, uint8_t smpNum);
 void updateScopes(void);
 void drawScopes(void);
-bool initScopes(void);
-void waitOnScopes(void);
 void clearScopes(void);
 
 extern scopeChannel_t scope[4];
-extern scopeChannelExt_t scopeExt[4];
+extern scopeTap_t scopeTap[4];
+extern float fMixTap[SCOPE_TAP_LEN]; // final output (after filters), mono
+extern uint32_t scopeTapWritePos; // only changed by the audio thread
@@ -0,0 +1,193 @@
+/* Spectrum analyzer. Runs a Hann windowed FFT over the final mix output
+** (see fMixTap in pt2_scopes.c) once per video frame, and bins the result
+** logarithmically into the visualizer bars. The bars sink in sinkVisualizerBars().
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "pt2_header.h"
+#include "pt2_helpers.h"
+#include "pt2_scopes.h"
+#include "pt2_spectrum.h"
+
+#define FFT_HALF (SPECTRUM_FFT_LEN / 2) /* length of the complex FFT doing the real FFT */
+#define SPECTRUM_LO_HZ 50.0
+#define SPECTRUM_HI_HZ 16000.0
+#define SPECTRUM_RANGE_DB 60.0
+
+static int16_t bitRevTab[FFT_HALF];
+static int32_t barFirstBin[SPECTRUM_BAR_NUM], barLastBin[SPECTRUM_BAR_NUM];
+static uint32_t binAudioFreq;
+static float fWindow[SPECTRUM_FFT_LEN], fInput[SPECTRUM_FFT_LEN], fRe[FFT_HALF], fIm[FFT_HALF];
+static float fTwiddleRe[FFT_HALF / 2], fTwiddleIm[FFT_HALF / 2], fSplitRe[FFT_HALF], fSplitIm[FFT_HALF];
+static float fPower[FFT_HALF];
+
+void initSpectrumAnalyzer(void)
+{
+	int32_t i, j, bits;
+
+	const double dPi = 3.14159265358979323846;
+
+	for (i = 0; i < SPECTRUM_FFT_LEN; i++)
+		fWindow[i] = (float)(0.5 - (0.5 * cos((2.0 * dPi * i) / (SPECTRUM_FFT_LEN - 1))));
+
+	for (i = 0; i < FFT_HALF / 2; i++)
+	{
+		fTwiddleRe[i] = (float)cos((-2.0 * dPi * i) / FFT_HALF);
+		fTwiddleIm[i] = (float)sin((-2.0 * dPi * i) / FFT_HALF);
+	}
+
+	// used to get the real spectrum from the half-length complex FFT
+	for (i = 0; i < FFT_HALF; i++)
+	{
+		fSplitRe[i] = (float)cos((-2.0 * dPi * i) / SPECTRUM_FFT_LEN);
+		fSplitIm[i] = (float)sin((-2.0 * dPi * i) / SPECTRUM_FFT_LEN);
+	}
+
+	for (bits = 0; (1 << bits) < FFT_HALF; bits++);
+	for (i = 0; i < FFT_HALF; i++)
+	{
+		int32_t rev = 0;
+		for (j = 0; j < bits; j++)
+		{
+			if (i & (1 << j))
+				rev |= 1 << (bits - 1 - j);
+		}
+
+		bitRevTab[i] = (int16_t)rev;
+	}
+
+	binAudioFreq = 0; // bar bins are calculated on first update
+}
+
+// logarithmic bar bands, depends on the audio output rate
+static void calcBarBins(void)
+{
+	int32_t lo, hi;
+	double dHiHz, dBinHz, dLoEdge, dHiEdge;
+
+	dBinHz = audio.dAudioFreq / SPECTRUM_FFT_LEN;
+
+	dHiHz = SPECTRUM_HI_HZ;
+	if (dHiHz > audio.dAudioFreq * 0.45)
+		dHiHz = audio.dAudioFreq * 0.45;
+
+	for (int32_t i = 0; i < SPECTRUM_BAR_NUM; i++)
+	{
+		dLoEdge = SPECTRUM_LO_HZ * pow(dHiHz / SPECTRUM_LO_HZ, (double)i / SPECTRUM_BAR_NUM);
+		dHiEdge = SPECTRUM_LO_HZ * pow(dHiHz / SPECTRUM_LO_HZ, (double)(i + 1) / SPECTRUM_BAR_NUM);
+
+		lo = (int32_t)ceil(dLoEdge / dBinHz);
+		hi = (int32_t)floor(dHiEdge / dBinHz);
+
+		if (lo < 1) lo = 1; // skip DC
+		if (hi < lo) hi = lo; // band narrower than one bin, use the nearest one
+		if (hi > FFT_HALF-1) hi = FFT_HALF-1;
+		if (lo > hi) lo = hi;
+
+		barFirstBin[i] = lo;
+		barLastBin[i] = hi;
+	}
+
+	binAudioFreq = audio.audioFreq;
+}
+
+// in-place iterative radix-2 complex FFT on fRe/fIm (input in bit-reversed order)
+static void fft(void)
+{
+	int32_t half, step, i, j, k;
+	float fWr, fWi, fTr, fTi;
+
+	for (half = 1, step = FFT_HALF / 2; half < FFT_HALF; half <<= 1, step >>= 1)
+	{
+		for (i = 0; i < FFT_HALF; i += half << 1)
+		{
+			for (j = 0, k = 0; j < half; j++, k += step)
+			{
+				fWr = fTwiddleRe[k];
+				fWi = fTwiddleIm[k];
+
+				fTr = (fWr * fRe[i+j+half]) - (fWi * fIm[i+j+half]);
+				fTi = (fWr * fIm[i+j+half]) + (fWi * fRe[i+j+half]);
+
+				fRe[i+j+half] = fRe[i+j] - fTr;
+				fIm[i+j+half] = fIm[i+j] - fTi;
+				fRe[i+j] += fTr;
+				fIm[i+j] += fTi;
+			}
+		}
+	}
+}
+
+static void calcPowerSpectrum(void)
+{
+	int32_t i, k;
+	float fZr, fZi, fCr, fCi, fEr, fEi, fOr, fOi, fXr, fXi;
+
+	// pack even/odd samples as real/imaginary, in bit-reversed order for the FFT
+	for (i = 0; i < FFT_HALF; i++)
+	{
+		k = bitRevTab[i];
+		fRe[k] = fInput[(i << 1) + 0] * fWindow[(i << 1) + 0];
+		fIm[k] = fInput[(i << 1) + 1] * fWindow[(i << 1) + 1];
+	}
+
+	fft();
+
+	// split the result into the spectrum of the real input (bins 0..N/2-1)
+	for (k = 0; k < FFT_HALF; k++)
+	{
+		fZr = fRe[k];
+		fZi = fIm[k];
+		fCr = fRe[(FFT_HALF - k) & (FFT_HALF-1)];
+		fCi = -fIm[(FFT_HALF - k) & (FFT_HALF-1)];
+
+		fEr = (fZr + fCr) * 0.5f;
+		fEi = (fZi + fCi) * 0.5f;
+		fOr = (fZi - fCi) * 0.5f;
+		fOi = (fCr - fZr) * 0.5f;
+
+		fXr = fEr + (fSplitRe[k] * fOr) - (fSplitIm[k] * fOi);
+		fXi = fEi + (fSplitRe[k] * fOi) + (fSplitIm[k] * fOr);
+
+		fPower[k] = (fXr * fXr) + (fXi * fXi);
+	}
+}
+
+void updateSpectrumAnalyzer(void)
+{
+	int32_t height;
+	float fPeak;
+	double dDb;
+
+	// full scale sine -> magnitude of N/4 with a Hann window
+	const double dNormalize = 4.0 / SPECTRUM_FFT_LEN;
+
+	if (binAudioFreq != audio.audioFreq)
+		calcBarBins();
+
+	getMixTapWindow(fInput, SPECTRUM_FFT_LEN);
+	calcPowerSpectrum();
+
+	for (int32_t i = 0; i < SPECTRUM_BAR_NUM; i++)
+	{
+		fPeak = 0.0f;
+		for (int32_t j = barFirstBin[i]; j <= barLastBin[i]; j++)
+		{
+			if (fPower[j] > fPeak)
+				fPeak = fPower[j];
+		}
+
+		if (fPeak <= 0.0f)
+			continue;
+
+		dDb = 10.0 * log10(fPeak * (dNormalize * dNormalize)); // power -> dBFS
+		height = (int32_t)(((dDb + SPECTRUM_RANGE_DB) * SPECTRUM_BAR_HEIGHT) / SPECTRUM_RANGE_DB);
+		height = CLAMP(height, 0, SPECTRUM_BAR_HEIGHT);
+
+		// bars rise instantly and sink slowly
+		if (height > editor.spectrumVolumes[i])
+			editor.spectrumVolumes[i] = (int8_t)height;
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#define SPECTRUM_FFT_LEN 2048 /* real input samples, must be 2^n */
+
+void initSpectrumAnalyzer(void);
+void updateSpectrumAnalyzer(void);
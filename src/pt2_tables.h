@@ -15,7 +15,7 @@ extern int8_t pNoteTable[32];
 // GFX
 extern uint32_t iconBMP[1024];
 extern const uint8_t mousePointerBMP[256];
-extern const uint8_t fontBMP[5120];
+extern const uint8_t fontBMP[1280];
 extern const uint8_t arrowPaletteBMP[30];
 
 // PACKED GFX
@@ -12,591 +12,436 @@ static const char hexTable[16] =
 	'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
 };
 
-void charOut(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, char ch, uint32_t color)
+/* Pixel masks for every packed font row (bit 7 = leftmost pixel), so that a
+** glyph row is one masked write over eight pixels that the compiler can vectorize.
+*/
+#define PIXEL_MASK(bits, x) ((((bits) >> (7 - (x))) & 1) ? 0xFFFFFFFF : 0x00000000)
+#define ROW_MASK(b) { PIXEL_MASK(b, 0), PIXEL_MASK(b, 1), PIXEL_MASK(b, 2), PIXEL_MASK(b, 3), \
+                      PIXEL_MASK(b, 4), PIXEL_MASK(b, 5), PIXEL_MASK(b, 6), PIXEL_MASK(b, 7) }
+#define ROW_MASKS4(b) ROW_MASK(b), ROW_MASK((b)+1), ROW_MASK((b)+2), ROW_MASK((b)+3)
+#define ROW_MASKS16(b) ROW_MASKS4(b), ROW_MASKS4((b)+4), ROW_MASKS4((b)+8), ROW_MASKS4((b)+12)
+
+static const uint32_t rowMask[256][FONT_CHAR_W] =
+{
+	ROW_MASKS16(0x00), ROW_MASKS16(0x10), ROW_MASKS16(0x20), ROW_MASKS16(0x30),
+	ROW_MASKS16(0x40), ROW_MASKS16(0x50), ROW_MASKS16(0x60), ROW_MASKS16(0x70),
+	ROW_MASKS16(0x80), ROW_MASKS16(0x90), ROW_MASKS16(0xA0), ROW_MASKS16(0xB0),
+	ROW_MASKS16(0xC0), ROW_MASKS16(0xD0), ROW_MASKS16(0xE0), ROW_MASKS16(0xF0)
+};
+
+static inline void rowOut(uint32_t *dstPtr, uint8_t bits, uint32_t color)
 {
-	const uint8_t *srcPtr;
-	uint32_t *dstPtr;
+	uint32_t mask[FONT_CHAR_W];
 
-	if (ch == '\0' && (ch <= ' ' || ch > '~'))
-		return;
+	memcpy(mask, rowMask[bits], sizeof (mask)); // a local copy can't alias dstPtr, so this vectorizes
+	for (uint32_t x = 0; x < FONT_CHAR_W; x++)
+		dstPtr[x] = (dstPtr[x] & ~mask[x]) | (color & mask[x]);
+}
 
-	srcPtr = &fontBMP[(uint8_t)ch * (FONT_CHAR_W * FONT_CHAR_H)];
-	dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
+static inline void rowOutBg(uint32_t *dstPtr, uint8_t bits, uint32_t bgColor, uint32_t xorColor)
+{
+	uint32_t mask[FONT_CHAR_W];
+
+	memcpy(mask, rowMask[bits], sizeof (mask));
+	for (uint32_t x = 0; x < FONT_CHAR_W; x++)
+		dstPtr[x] = bgColor ^ (xorColor & mask[x]);
+}
 
-	for (uint32_t y = 0; y < FONT_CHAR_H; y++)
+static inline void glyphOut(uint32_t *dstPtr, char ch, uint32_t color)
+{
+	const uint8_t *srcPtr = &fontBMP[(uint8_t)ch * FONT_CHAR_H];
+	for (uint32_t y = 0; y < FONT_CHAR_H; y++, dstPtr += SCREEN_W)
+		rowOut(dstPtr, srcPtr[y], color);
+}
+
+static inline void glyphOutBg(uint32_t *dstPtr, char ch, uint32_t bgColor, uint32_t xorColor)
+{
+	const uint8_t *srcPtr = &fontBMP[(uint8_t)ch * FONT_CHAR_H];
+	for (uint32_t y = 0; y < FONT_CHAR_H; y++, dstPtr += SCREEN_W)
+		rowOutBg(dstPtr, srcPtr[y], bgColor, xorColor);
+}
+
+static inline void glyphOutBig(uint32_t *dstPtr, char ch, uint32_t color)
+{
+	const uint8_t *srcPtr = &fontBMP[(uint8_t)ch * FONT_CHAR_H];
+	for (uint32_t y = 0; y < FONT_CHAR_H; y++, dstPtr += SCREEN_W * 2)
 	{
-		for (uint32_t x = 0; x < FONT_CHAR_W; x++)
-		{
-			if (srcPtr[x])
-				dstPtr[x] = color;
-		}
-
-		srcPtr += FONT_CHAR_W;
-		dstPtr += SCREEN_W;
+		rowOut(dstPtr, srcPtr[y], color);
+		rowOut(dstPtr + SCREEN_W, srcPtr[y], color);
 	}
 }
 
-void charOutBg(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, char ch, uint32_t fgColor, uint32_t bgColor)
+static inline void glyphOutBigBg(uint32_t *dstPtr, char ch, uint32_t bgColor, uint32_t xorColor)
 {
-	const uint8_t *srcPtr;
-	uint32_t *dstPtr;
+	const uint8_t *srcPtr = &fontBMP[(uint8_t)ch * FONT_CHAR_H];
+	for (uint32_t y = 0; y < FONT_CHAR_H; y++, dstPtr += SCREEN_W * 2)
+	{
+		rowOutBg(dstPtr, srcPtr[y], bgColor, xorColor);
+		rowOutBg(dstPtr + SCREEN_W, srcPtr[y], bgColor, xorColor);
+	}
+}
 
+void charOut(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, char ch, uint32_t color)
+{
 	if (ch == '\0')
 		return;
 
-	if (ch < ' ' || ch > '~')
-		ch = ' ';
+	glyphOut(&frameBuffer[(yPos * SCREEN_W) + xPos], ch, color);
+}
 
-	srcPtr = &fontBMP[(uint8_t)ch * (FONT_CHAR_W * FONT_CHAR_H)];
-	dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
+void charOutBg(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, char ch, uint32_t fgColor, uint32_t bgColor)
+{
+	if (ch == '\0')
+		return;
 
-	for (uint32_t y = 0; y < FONT_CHAR_H; y++)
-	{
-		for (uint32_t x = 0; x < FONT_CHAR_W; x++)
-			dstPtr[x] = srcPtr[x] ? fgColor : bgColor;
+	if (ch < ' ' || ch > '~')
+		ch = ' ';
 
-		srcPtr += FONT_CHAR_W;
-		dstPtr += SCREEN_W;
-	}
+	glyphOutBg(&frameBuffer[(yPos * SCREEN_W) + xPos], ch, bgColor, fgColor ^ bgColor);
 }
 
 void charOutBig(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, char ch, uint32_t color)
 {
-	const uint8_t *srcPtr;
-	uint32_t *dstPtr;
-
 	if (ch != '\0' && (ch <= ' ' || ch > '~'))
 		return;
 
-	srcPtr = &fontBMP[(uint8_t)ch * (FONT_CHAR_W * FONT_CHAR_H)];
-	dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
-
-	for (uint32_t y = 0; y < FONT_CHAR_H; y++)
-	{
-		for (uint32_t x = 0; x < FONT_CHAR_W; x++)
-		{
-			if (srcPtr[x])
-			{
-				dstPtr[x] = color;
-				dstPtr[x+SCREEN_W] = color;
-			}
-		}
-
-		srcPtr += FONT_CHAR_W;
-		dstPtr += SCREEN_W * 2;
-	}
+	glyphOutBig(&frameBuffer[(yPos * SCREEN_W) + xPos], ch, color);
 }
 
 void charOutBigBg(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, char ch, uint32_t fgColor, uint32_t bgColor)
 {
-	const uint8_t *srcPtr;
-	uint32_t *dstPtr;
-
 	if (ch == '\0')
 		return;
 
 	if (ch < ' ' || ch > '~')
 		ch = ' ';
 
-	srcPtr = &fontBMP[(uint8_t)ch * (FONT_CHAR_W * FONT_CHAR_H)];
-	dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
-
-	for (uint32_t y = 0; y < FONT_CHAR_H; y++)
-	{
-		for (uint32_t x = 0; x < FONT_CHAR_W; x++)
-		{
-			if (srcPtr[x])
-			{
-				dstPtr[x] = fgColor;
-				dstPtr[x+SCREEN_W] = fgColor;
-			}
-			else
-			{
-				dstPtr[x] = bgColor;
-				dstPtr[x+SCREEN_W] = bgColor;
-			}
-		}
-
-		srcPtr += FONT_CHAR_W;
-		dstPtr += SCREEN_W * 2;
-	}
+	glyphOutBigBg(&frameBuffer[(yPos * SCREEN_W) + xPos], ch, bgColor, fgColor ^ bgColor);
 }
 
+// the string routines below draw the glyphs directly instead of going through charOut*()
+
 void textOut(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, const char *text, uint32_t color)
 {
-	uint32_t x = xPos;
+	uint32_t *dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
 	while (*text != '\0')
 	{
-		charOut(frameBuffer, x, yPos, *text++, color);
-		x += FONT_CHAR_W;
+		glyphOut(dstPtr, *text++, color);
+		dstPtr += FONT_CHAR_W;
 	}
 }
 
 void textOutTight(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, const char *text, uint32_t color)
 {
-	uint32_t x = xPos;
+	uint32_t *dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
 	while (*text != '\0')
 	{
-		charOut(frameBuffer, x, yPos, *text++, color);
-		x += (FONT_CHAR_W - 1);
+		glyphOut(dstPtr, *text++, color);
+		dstPtr += FONT_CHAR_W - 1;
 	}
 }
 
 void textOutBg(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, const char *text, uint32_t fgColor, uint32_t bgColor)
 {
-	uint32_t x = xPos;
+	char ch;
+	uint32_t *dstPtr, xorColor;
+
+	dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
+	xorColor = fgColor ^ bgColor;
+
 	while (*text != '\0')
 	{
-		charOutBg(frameBuffer, x, yPos, *text++, fgColor, bgColor);
-		x += FONT_CHAR_W;
+		ch = *text++;
+		if (ch < ' ' || ch > '~')
+			ch = ' ';
+
+		glyphOutBg(dstPtr, ch, bgColor, xorColor);
+		dstPtr += FONT_CHAR_W;
 	}
 }
 
 void textOutBig(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, const char *text, uint32_t color)
 {
-	uint32_t x = xPos;
+	char ch;
+	uint32_t *dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
+
 	while (*text != '\0')
 	{
-		charOutBig(frameBuffer, x, yPos, *text++, color);
-		x += FONT_CHAR_W;
+		ch = *text++;
+		if (ch > ' ' && ch <= '~')
+			glyphOutBig(dstPtr, ch, color);
+
+		dstPtr += FONT_CHAR_W;
 	}
 }
 
 void textOutBigBg(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, const char *text, uint32_t fgColor, uint32_t bgColor)
 {
-	uint32_t x = xPos;
+	char ch;
+	uint32_t *dstPtr, xorColor;
+
+	dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
+	xorColor = fgColor ^ bgColor;
+
 	while (*text != '\0')
 	{
-		charOutBigBg(frameBuffer, x, yPos, *text++, fgColor, bgColor);
-		x += FONT_CHAR_W;
+		ch = *text++;
+		if (ch < ' ' || ch > '~')
+			ch = ' ';
+
+		glyphOutBigBg(dstPtr, ch, bgColor, xorColor);
+		dstPtr += FONT_CHAR_W;
 	}
 }
 
-void printTwoDecimals(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
+// value -> zero padded text (clamped to the amount of digits)
+static void decimalsToText(char *textPtr, uint32_t value, uint32_t numDigits)
 {
-	if (value == 0)
+	uint32_t maxValue = 9;
+	for (uint32_t i = 1; i < numDigits; i++)
+		maxValue = (maxValue * 10) + 9;
+
+	if (value > maxValue)
+		value = maxValue;
+
+	textPtr[numDigits] = '\0';
+	for (int32_t i = numDigits-1; i >= 0; i--)
 	{
-		textOut(frameBuffer, x, y, "00", fontColor);
+		textPtr[i] = '0' + (value % 10);
+		value /= 10;
 	}
-	else
-	{
-		if (value > 99)
-			value = 99;
+}
 
-		charOut(frameBuffer, x + (FONT_CHAR_W * 1), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 0), y, '0' + (value % 10), fontColor);
+// value -> zero padded hex text (masked to the amount of digits)
+static void hexToText(char *textPtr, uint32_t value, uint32_t numDigits)
+{
+	textPtr[numDigits] = '\0';
+	for (int32_t i = numDigits-1; i >= 0; i--)
+	{
+		textPtr[i] = hexTable[value & 15];
+		value >>= 4;
 	}
 }
 
+// replaces leading zeroes with spaces, last digit is always kept
+static void padZeroesWithSpace(char *textPtr)
+{
+	while (textPtr[0] == '0' && textPtr[1] != '\0')
+		*textPtr++ = ' ';
+}
+
+void printTwoDecimals(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
+{
+	char text[3];
+
+	decimalsToText(text, value, 2);
+	textOut(frameBuffer, x, y, text, fontColor);
+}
+
 void printTwoDecimalsBig(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	if (value == 0)
-	{
-		textOutBig(frameBuffer, x, y, "00", fontColor);
-	}
-	else
-	{
-		if (value > 99)
-			value = 99;
+	char text[3];
 
-		charOutBig(frameBuffer, x + (FONT_CHAR_W * 1), y, '0' + (value % 10), fontColor); value /= 10;
-		charOutBig(frameBuffer, x + (FONT_CHAR_W * 0), y, '0' + (value % 10), fontColor);
-	}
+	decimalsToText(text, value, 2);
+	textOutBig(frameBuffer, x, y, text, fontColor);
 }
 
 void printThreeDecimals(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	if (value == 0)
-	{
-		textOut(frameBuffer, x, y, "000", fontColor);
-	}
-	else
-	{
-		if (value > 999)
-			value = 999;
+	char text[4];
 
-		charOut(frameBuffer, x + (FONT_CHAR_W * 2), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 1), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 0), y, '0' + (value % 10), fontColor);
-	}
+	decimalsToText(text, value, 3);
+	textOut(frameBuffer, x, y, text, fontColor);
 }
 
 void printFourDecimals(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	if (value == 0)
-	{
-		textOut(frameBuffer, x, y, "0000", fontColor);
-	}
-	else
-	{
-		if (value > 9999)
-			value = 9999;
+	char text[5];
 
-		charOut(frameBuffer, x + (FONT_CHAR_W * 3), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 2), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 1), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 0), y, '0' + (value % 10), fontColor);
-	}
+	decimalsToText(text, value, 4);
+	textOut(frameBuffer, x, y, text, fontColor);
 }
 
 void printFiveDecimals(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	if (value == 0)
-	{
-		textOut(frameBuffer, x, y, "00000", fontColor);
-	}
-	else
-	{
-		if (value > 99999)
-			value = 99999;
-
-		charOut(frameBuffer, x + (FONT_CHAR_W * 4), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 3), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 2), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 1), y, '0' + (value % 10), fontColor); value /= 10;
-		charOut(frameBuffer, x + (FONT_CHAR_W * 0), y, '0' + (value % 10), fontColor);
-	}
+	char text[6];
+
+	decimalsToText(text, value, 5);
+	textOut(frameBuffer, x, y, text, fontColor);
 }
 
 // this one is used for module size and sampler screen display length (zeroes are padded with space)
 void printSixDecimals(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	char numberText[7];
-	uint8_t i;
+	char text[7];
 
-	if (value == 0)
-	{
-		textOut(frameBuffer, x, y, "     0", fontColor);
-	}
-	else
-	{
-		if (value > 999999)
-			value = 999999;
-
-		numberText[6] = 0;
-		numberText[5] = '0' + (value % 10); value /= 10;
-		numberText[4] = '0' + (value % 10); value /= 10;
-		numberText[3] = '0' + (value % 10); value /= 10;
-		numberText[2] = '0' + (value % 10); value /= 10;
-		numberText[1] = '0' + (value % 10); value /= 10;
-		numberText[0] = '0' + (value % 10);
-
-		i = 0;
-		while (numberText[i] == '0')
-			numberText[i++] = ' ';
-
-		textOut(frameBuffer, x, y, numberText, fontColor);
-	}
+	decimalsToText(text, value, 6);
+	padZeroesWithSpace(text);
+	textOut(frameBuffer, x, y, text, fontColor);
 }
 
 void printOneHex(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	charOut(frameBuffer, x, y, hexTable[value & 15], fontColor);
+	char text[2];
+
+	hexToText(text, value, 1);
+	textOut(frameBuffer, x, y, text, fontColor);
 }
 
 void printOneHexBig(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	charOutBig(frameBuffer, x, y, hexTable[value & 15], fontColor);
+	char text[2];
+
+	hexToText(text, value, 1);
+	textOutBig(frameBuffer, x, y, text, fontColor);
 }
 
 void printTwoHex(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	if (value == 0)
-	{
-		textOut(frameBuffer, x, y, "00", fontColor);
-	}
-	else
-	{
-		value &= 0xFF;
+	char text[3];
 
-		charOut(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value >> 4], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[value & 15], fontColor);
-	}
+	hexToText(text, value, 2);
+	textOut(frameBuffer, x, y, text, fontColor);
 }
 
 void printTwoHexBig(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	if (value == 0)
-	{
-		textOutBig(frameBuffer, x, y, "00", fontColor);
-	}
-	else
-	{
-		value &= 0xFF;
+	char text[3];
 
-		charOutBig(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value >> 4], fontColor);
-		charOutBig(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[value & 15], fontColor);
-	}
+	hexToText(text, value, 2);
+	textOutBig(frameBuffer, x, y, text, fontColor);
 }
 
 void printThreeHex(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	if (value == 0)
-	{
-		textOut(frameBuffer, x, y, "000", fontColor);
-	}
-	else
-	{
-		value &= 0xFFF;
+	char text[4];
 
-		charOut(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value >> 8], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[(value & (15 << 4)) >> 4], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 2), y, hexTable[value & 15], fontColor);
-	}
+	hexToText(text, value, 3);
+	textOut(frameBuffer, x, y, text, fontColor);
 }
 
 void printFourHex(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	if (value == 0)
-	{
-		textOut(frameBuffer, x, y, "0000", fontColor);
-	}
-	else
-	{
-		value &= 0xFFFF;
+	char text[5];
 
-		charOut(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value >> 12], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[(value & (15 << 8)) >> 8], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 2), y, hexTable[(value & (15 << 4)) >> 4], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 3), y, hexTable[value & 15], fontColor);
-	}
+	hexToText(text, value, 4);
+	textOut(frameBuffer, x, y, text, fontColor);
 }
 
 void printFiveHex(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor)
 {
-	if (value == 0)
-	{
-		textOut(frameBuffer, x, y, "00000", fontColor);
-	}
-	else
-	{
-		value &= 0xFFFFF;
+	char text[6];
 
-		charOut(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value  >> 16], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[(value & (15 << 12)) >> 12], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 2), y, hexTable[(value & (15 << 8)) >> 8], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 3), y, hexTable[(value & (15 << 4)) >> 4], fontColor);
-		charOut(frameBuffer, x + (FONT_CHAR_W * 4), y, hexTable[value & 15], fontColor);
-	}
+	hexToText(text, value, 5);
+	textOut(frameBuffer, x, y, text, fontColor);
 }
 
 void printTwoDecimalsBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	if (value == 0)
-	{
-		textOutBg(frameBuffer, x, y, "00", fontColor, backColor);
-	}
-	else
-	{
-		if (value > 99)
-			value = 99;
+	char text[3];
 
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 1), y, '0' + (value % 10), fontColor, backColor); value /= 10;
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 0), y, '0' + (value % 10), fontColor, backColor);
-	}
+	decimalsToText(text, value, 2);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printTwoDecimalsBigBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	if (value == 0)
-	{
-		textOutBigBg(frameBuffer, x, y, "00", fontColor, backColor);
-	}
-	else
-	{
-		if (value > 99)
-			value = 99;
+	char text[3];
 
-		charOutBigBg(frameBuffer, x + (FONT_CHAR_W * 1), y, '0' + (value % 10), fontColor, backColor); value /= 10;
-		charOutBigBg(frameBuffer, x + (FONT_CHAR_W * 0), y, '0' + (value % 10), fontColor, backColor);
-	}
+	decimalsToText(text, value, 2);
+	textOutBigBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printThreeDecimalsBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	if (value == 0)
-	{
-		textOutBg(frameBuffer, x, y, "000", fontColor, backColor);
-	}
-	else
-	{
-		if (value > 999)
-			value = 999;
+	char text[4];
 
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 2), y, '0' + (value % 10), fontColor, backColor); value /= 10;
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 1), y, '0' + (value % 10), fontColor, backColor); value /= 10;
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 0), y, '0' + (value % 10), fontColor, backColor);
-	}
+	decimalsToText(text, value, 3);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printFourDecimalsBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	if (value == 0)
-	{
-		textOutBg(frameBuffer, x, y, "0000", fontColor, backColor);
-	}
-	else
-	{
-		if (value > 9999)
-			value = 9999;
+	char text[5];
 
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 3), y, '0' + (value % 10), fontColor, backColor); value /= 10;
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 2), y, '0' + (value % 10), fontColor, backColor); value /= 10;
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 1), y, '0' + (value % 10), fontColor, backColor); value /= 10;
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 0), y, '0' + (value % 10), fontColor, backColor);
-	}
+	decimalsToText(text, value, 4);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 // this one is used for "DISP:" in the sampler screen (zeroes are padded with space)
 void printFiveDecimalsBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	char numberText[6];
-	uint8_t i;
-
-	if (value == 0)
-	{
-		textOutBg(frameBuffer, x, y, "    0", fontColor, backColor);
-	}
-	else
-	{
-		if (value > 99999)
-			value = 99999;
-
-		numberText[5] = 0;
-		numberText[4] = '0' + (value % 10); value /= 10;
-		numberText[3] = '0' + (value % 10); value /= 10;
-		numberText[2] = '0' + (value % 10); value /= 10;
-		numberText[1] = '0' + (value % 10); value /= 10;
-		numberText[0] = '0' + (value % 10);
-
-		i = 0;
-		while (numberText[i] == '0')
-			numberText[i++] = ' ';
+	char text[6];
 
-		textOutBg(frameBuffer, x, y, numberText, fontColor, backColor);
-	}
+	decimalsToText(text, value, 5);
+	padZeroesWithSpace(text);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 // this one is used for module size (zeroes are padded with space)
 void printSixDecimalsBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	char numberText[7];
-	uint8_t i;
+	char text[7];
 
-	if (value == 0)
-	{
-		textOutBg(frameBuffer, x, y, "     0", fontColor, backColor);
-	}
-	else
-	{
-		if (value > 999999)
-			value = 999999;
-
-		numberText[6] = 0;
-		numberText[5] = '0' + (value % 10); value /= 10;
-		numberText[4] = '0' + (value % 10); value /= 10;
-		numberText[3] = '0' + (value % 10); value /= 10;
-		numberText[2] = '0' + (value % 10); value /= 10;
-		numberText[1] = '0' + (value % 10); value /= 10;
-		numberText[0] = '0' + (value % 10);
-
-		i = 0;
-		while (numberText[i] == '0')
-			numberText[i++] = ' ';
-
-		textOutBg(frameBuffer, x, y, numberText, fontColor, backColor);
-	}
+	decimalsToText(text, value, 6);
+	padZeroesWithSpace(text);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printOneHexBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	charOutBg(frameBuffer, x, y, hexTable[value & 0xF], fontColor, backColor);
+	char text[2];
+
+	hexToText(text, value, 1);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printOneHexBigBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	charOutBigBg(frameBuffer, x, y, hexTable[value & 0xF], fontColor, backColor);
+	char text[2];
+
+	hexToText(text, value, 1);
+	textOutBigBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printTwoHexBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	if (value == 0)
-	{
-		textOutBg(frameBuffer, x, y, "00", fontColor, backColor);
-	}
-	else
-	{
-		value &= 0xFF;
+	char text[3];
 
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value >> 4], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[value & 15], fontColor, backColor);
-	}
+	hexToText(text, value, 2);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printTwoHexBigBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	if (value == 0)
-	{
-		textOutBigBg(frameBuffer, x, y, "00", fontColor, backColor);
-	}
-	else
-	{
-		value &= 0xFF;
+	char text[3];
 
-		charOutBigBg(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value >> 4], fontColor, backColor);
-		charOutBigBg(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[value & 15], fontColor, backColor);
-	}
+	hexToText(text, value, 2);
+	textOutBigBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printThreeHexBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	if (value == 0)
-	{
-		textOutBg(frameBuffer, x, y, "000", fontColor, backColor);
-	}
-	else
-	{
-		value &= 0xFFF;
+	char text[4];
 
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value >> 8], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[(value & (15 << 4)) >> 4], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 2), y, hexTable[value & 15], fontColor, backColor);
-	}
+	hexToText(text, value, 3);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printFourHexBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	if (value == 0)
-	{
-		textOutBg(frameBuffer, x, y, "0000", fontColor, backColor);
-	}
-	else
-	{
-		value &= 0xFFFF;
+	char text[5];
 
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value >> 12], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[(value & (15 << 8)) >> 8], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 2), y, hexTable[(value & (15 << 4)) >> 4], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 3), y, hexTable[value & 15], fontColor, backColor);
-	}
+	hexToText(text, value, 4);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void printFiveHexBg(uint32_t *frameBuffer, uint32_t x, uint32_t y, uint32_t value, uint32_t fontColor, uint32_t backColor)
 {
-	if (value == 0)
-	{
-		textOutBg(frameBuffer, x, y, "00000", fontColor, backColor);
-	}
-	else
-	{
-		value &= 0xFFFFF;
+	char text[6];
 
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 0), y, hexTable[value >> 16], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 1), y, hexTable[(value & (15 << 12)) >> 12], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 2), y, hexTable[(value & (15 << 8)) >> 8], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 3), y, hexTable[(value & (15 << 4)) >> 4], fontColor, backColor);
-		charOutBg(frameBuffer, x + (FONT_CHAR_W * 4), y, hexTable[value & 15], fontColor, backColor);
-	}
+	hexToText(text, value, 5);
+	textOutBg(frameBuffer, x, y, text, fontColor, backColor);
 }
 
 void setPrevStatusMessage(void)
@@ -0,0 +1,167 @@
+/* Replayer tick trace. When enabled, intMusic() stores one record per tick in a
+** static ring buffer (no allocation), holding the order/row and what was written
+** to Paula for each voice. The ring can be dumped as text or JSON lines, to diff
+** replayer behavior between builds (also see --trace in pt2_cli.c).
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "pt2_header.h"
+#include "pt2_helpers.h"
+#include "pt2_textout.h"
+#include "pt2_audio.h"
+#include "pt2_trace.h"
+
+static traceRecord_t traceRing[TRACE_RECORDS];
+
+replayerTrace_t trace; // global
+
+// these two are called from intMusic() (audio thread), only when the trace is enabled
+void traceNewRow(uint8_t order, uint8_t row)
+{
+	trace.order = order;
+	trace.row = row;
+}
+
+void traceEndTick(uint8_t rowTick, uint8_t speed, uint16_t bpm)
+{
+	traceRecord_t *r;
+	traceVoice_t *v;
+	moduleChannel_t *ch;
+
+	r = &traceRing[trace.tick & TRACE_MASK];
+
+	r->tick = trace.tick;
+	r->order = trace.order;
+	r->row = trace.row;
+	r->rowTick = rowTick;
+	r->speed = speed;
+	r->bpm = bpm;
+
+	paulaGetTraceState(r->voice);
+	for (int32_t i = 0; i < AMIGA_VOICES; i++)
+	{
+		v = &r->voice[i];
+		ch = &modEntry->channels[i];
+
+		v->sample = (ch->n_start != NULL) ? ch->n_samplenum + 1 : 0;
+		v->command = (ch->n_cmd >> 8) & 0x0F;
+		v->param = ch->n_cmd & 0xFF;
+	}
+
+	trace.tick++;
+}
+
+void startReplayerTrace(void)
+{
+	traceVoice_t dummy[AMIGA_VOICES];
+
+	lockAudio();
+	paulaGetTraceState(dummy); // clear old DMA flags
+	trace.tick = 0;
+	trace.order = trace.row = 0;
+	trace.enabled = true;
+	unlockAudio();
+}
+
+void toggleReplayerTrace(void)
+{
+	if (trace.enabled)
+	{
+		lockAudio();
+		trace.enabled = false;
+		unlockAudio();
+	}
+	else
+	{
+		startReplayerTrace();
+	}
+
+	displayMsg(trace.enabled ? "TRACE: ON" : "TRACE: OFF");
+}
+
+// writes the ring, oldest tick first. Don't call this while the trace is enabled!
+bool writeReplayerTrace(FILE *f, bool json)
+{
+	uint32_t numRecords;
+	traceRecord_t *r;
+	traceVoice_t *v;
+
+	numRecords = (trace.tick < TRACE_RECORDS) ? trace.tick : TRACE_RECORDS;
+
+	if (!json)
+		fprintf(f, "  tick ord row tck spd bpm | per  vol smp eff dma (x4)\n");
+
+	for (uint32_t i = trace.tick - numRecords; i != trace.tick; i++)
+	{
+		r = &traceRing[i & TRACE_MASK];
+
+		if (json)
+			fprintf(f, "{\"tick\":%u,\"order\":%u,\"row\":%u,\"rowTick\":%u,\"speed\":%u,\"bpm\":%u,\"voices\":[",
+				r->tick, r->order, r->row, r->rowTick, r->speed, r->bpm);
+		else
+			fprintf(f, "%6u %3u %3u %3u %3u %3u", r->tick, r->order, r->row, r->rowTick, r->speed, r->bpm);
+
+		for (int32_t j = 0; j < AMIGA_VOICES; j++)
+		{
+			v = &r->voice[j];
+
+			if (json)
+			{
+				fprintf(f, "%s{\"period\":%u,\"volume\":%u,\"sample\":%u,\"effect\":\"%X%02X\",\"dmaStart\":%s,\"dmaStop\":%s}",
+					(j > 0) ? "," : "", v->period, v->volume, v->sample, v->command, v->param,
+					(v->flags & TRACE_DMA_START) ? "true" : "false",
+					(v->flags & TRACE_DMA_STOP) ? "true" : "false");
+			}
+			else
+			{
+				fprintf(f, " | %4u %3u %3u %X%02X %c%c", v->period, v->volume, v->sample, v->command, v->param,
+					(v->flags & TRACE_DMA_START) ? 'S' : '-', (v->flags & TRACE_DMA_STOP) ? 'X' : '-');
+			}
+		}
+
+		fprintf(f, json ? "]}\n" : "\n");
+	}
+
+	return !ferror(f);
+}
+
+bool dumpReplayerTrace(void)
+{
+	bool result;
+	UNICHAR pathU[PATH_MAX + 32];
+	FILE *f;
+
+	// freeze the ring before reading it
+	lockAudio();
+	trace.enabled = false;
+	unlockAudio();
+
+	if (trace.tick == 0)
+	{
+		displayMsg("NO TRACE DATA !");
+		return false;
+	}
+
+	// in the config directory, Disk Op. changes the current directory
+	f = getConfigFilePath(pathU, "pt2-trace.txt") ? UNICHAR_FOPEN(pathU, "w") : NULL;
+	if (f == NULL)
+	{
+		displayErrorMsg("FILE I/O ERROR");
+		return false;
+	}
+
+	result = writeReplayerTrace(f, false);
+	fclose(f);
+
+	if (!result)
+	{
+		displayErrorMsg("FILE I/O ERROR");
+		return false;
+	}
+
+	displayMsg("TRACE SAVED !");
+	return true;
+}
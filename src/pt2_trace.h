@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// replayer tick trace (toggled with CTRL+ALT+F12, CTRL+ALT+SHIFT+F12 dumps to a file)
+
+#define TRACE_RECORDS 32768 /* ring buffer length, in ticks, must be 2^n */
+#define TRACE_MASK (TRACE_RECORDS-1)
+
+// traceVoice_t flags
+#define TRACE_DMA_START 1
+#define TRACE_DMA_STOP 2
+
+typedef struct traceVoice_t
+{
+	uint16_t period; // last period written to Paula (after arpeggio/vibrato etc.)
+	uint8_t volume; // last volume written to Paula (after tremolo)
+	uint8_t sample; // 1..31, 0 = none
+	uint8_t command, param; // effect on the current row
+	uint8_t flags; // DMA events during this tick
+} traceVoice_t;
+
+typedef struct traceRecord_t
+{
+	uint32_t tick; // ticks since the trace was started
+	uint8_t order, row, rowTick, speed; // the row being played, and the tick within it
+	uint16_t bpm;
+	traceVoice_t voice[4];
+} traceRecord_t;
+
+typedef struct replayerTrace_t
+{
+	volatile bool enabled;
+	uint8_t order, row;
+	uint32_t tick;
+} replayerTrace_t;
+
+extern replayerTrace_t trace; // pt2_trace.c
+
+void traceNewRow(uint8_t order, uint8_t row);
+void traceEndTick(uint8_t rowTick, uint8_t speed, uint16_t bpm);
+void startReplayerTrace(void);
+void toggleReplayerTrace(void);
+bool writeReplayerTrace(FILE *f, bool json);
+bool dumpReplayerTrace(void);
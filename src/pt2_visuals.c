@@ -35,14 +35,19 @@
 #include "pt2_helpers.h"
 #include "pt2_scopes.h"
 #include "pt2_edit.h"
+#include "pt2_profiler.h"
+#include "pt2_spectrum.h"
+
+#define MAX_SPRITE_PIXELS 256
 
 typedef struct sprite_t
 {
-	bool visible;
+	bool visible, texturePixelsValid;
 	int8_t pixelType;
 	uint16_t newX, newY, x, y, w, h;
-	uint32_t colorKey, *refreshBuffer;
+	uint32_t colorKey, *texturePixels;
 	const void *data;
+	SDL_Texture *texture;
 } sprite_t;
 
 static uint32_t vuMetersBg[4 * (10 * 48)];
@@ -151,18 +156,55 @@ void waitVBL(void)
 
 void renderFrame(void)
 {
+	profilerBegin(PROF_RENDER_FRAME);
+
+	updateScopes(); // interpolate the mixer voice state to display time
+
+	profilerBegin(PROF_MOD2WAV);
 	updateMOD2WAVDialog(); // must be first to avoid flickering issues
+	profilerEnd(PROF_MOD2WAV);
 
+	profilerBegin(PROF_SONG_INFO1);
 	updateSongInfo1(); // top left side of screen, when "disk op"/"pos ed" is hidden
+	profilerEnd(PROF_SONG_INFO1);
+
+	profilerBegin(PROF_SONG_INFO2);
 	updateSongInfo2(); // two middle rows of screen, always visible
+	profilerEnd(PROF_SONG_INFO2);
+
+	profilerBegin(PROF_EDIT_OP);
 	updateEditOp();
+	profilerEnd(PROF_EDIT_OP);
+
+	profilerBegin(PROF_PATTERN);
 	updatePatternData();
+	profilerEnd(PROF_PATTERN);
+
+	profilerBegin(PROF_DISK_OP);
 	updateDiskOp();
+	profilerEnd(PROF_DISK_OP);
+
+	profilerBegin(PROF_SAMPLER);
 	updateSampler();
+	profilerEnd(PROF_SAMPLER);
+
+	profilerBegin(PROF_POS_ED);
 	updatePosEd();
+	profilerEnd(PROF_POS_ED);
+
+	profilerBegin(PROF_VISUALIZER);
 	updateVisualizer();
+	profilerEnd(PROF_VISUALIZER);
+
+	profilerBegin(PROF_DRAG_BARS);
 	updateDragBars();
+	profilerEnd(PROF_DRAG_BARS);
+
+	profilerBegin(PROF_SAMPLER_LINE);
 	drawSamplerLine();
+	profilerEnd(PROF_SAMPLER_LINE);
+
+	profilerEnd(PROF_RENDER_FRAME);
 }
 
 void resetAllScreens(void)
@@ -202,6 +244,9 @@ void renderAskDialog(void)
 	const uint32_t *srcPtr;
 	uint32_t *dstPtr;
 
+	if (!unpackLazyBMP(editor.ui.pat2SmpDialogShown ? &pat2SmpDialogBMP : &yesNoDialogBMP))
+		return;
+
 	editor.ui.disablePosEd = true;
 	editor.ui.disableVisualizer = true;
 
@@ -729,6 +774,9 @@ void renderSamplerVolBox(void)
 	const uint32_t *srcPtr;
 	uint32_t *dstPtr;
 
+	if (!unpackLazyBMP(&samplerVolumeBMP))
+		return;
+
 	srcPtr = samplerVolumeBMP;
 	dstPtr = &pixelBuffer[(154 * SCREEN_W) + 72];
 
@@ -760,6 +808,9 @@ void renderSamplerFiltersBox(void)
 	const uint32_t *srcPtr;
 	uint32_t *dstPtr;
 
+	if (!unpackLazyBMP(&samplerFiltersBMP))
+		return;
+
 	srcPtr = samplerFiltersBMP;
 	dstPtr = &pixelBuffer[(154 * SCREEN_W) + 65];
 
@@ -790,6 +841,9 @@ void removeSamplerFiltersBox(void)
 
 void renderDiskOpScreen(void)
 {
+	if (!unpackLazyBMP(&diskOpScreenBMP))
+		return;
+
 	memcpy(pixelBuffer, diskOpScreenBMP, (99 * 320) * sizeof (int32_t));
 
 	editor.ui.updateDiskOpPathText = true;
@@ -949,6 +1003,9 @@ void renderPosEdScreen(void)
 	const uint32_t *srcPtr;
 	uint32_t *dstPtr;
 
+	if (!unpackLazyBMP(&posEdBMP))
+		return;
+
 	srcPtr = posEdBMP;
 	dstPtr = &pixelBuffer[120];
 
@@ -1001,6 +1058,9 @@ void renderClearScreen(void)
 	const uint32_t *srcPtr;
 	uint32_t *dstPtr;
 
+	if (!unpackLazyBMP(&clearDialogBMP))
+		return;
+
 	editor.ui.disablePosEd = true;
 	editor.ui.disableVisualizer = true;
 
@@ -1139,6 +1199,8 @@ void updateVisualizer(void)
 	{
 		// spectrum analyzer
 
+		updateSpectrumAnalyzer();
+
 		dstPtr = &pixelBuffer[(59 * SCREEN_W) + 129];
 		for (uint32_t i = 0; i < SPECTRUM_BAR_NUM; i++)
 		{
@@ -1186,7 +1248,7 @@ void renderQuadrascopeBg(void)
 	}
 
 	for (uint32_t i = 0; i < AMIGA_VOICES; i++)
-		scopeExt[i].emptyScopeDrawn = false;
+		scope[i].emptyScopeDrawn = false;
 }
 
 void renderSpectrumAnalyzerBg(void)
@@ -1194,6 +1256,9 @@ void renderSpectrumAnalyzerBg(void)
 	const uint32_t *srcPtr;
 	uint32_t *dstPtr;
 
+	if (!unpackLazyBMP(&spectrumVisualsBMP))
+		return;
+
 	srcPtr = spectrumVisualsBMP;
 	dstPtr = &pixelBuffer[(44 * SCREEN_W) + 120];
 
@@ -1215,6 +1280,9 @@ void renderAboutScreen(void)
 	if (!editor.ui.aboutScreenShown || editor.ui.diskOpScreenShown || editor.ui.posEdScreenShown || editor.ui.editOpScreenShown)
 		return;
 
+	if (!unpackLazyBMP(&aboutScreenBMP))
+		return;
+
 	srcPtr = aboutScreenBMP;
 	dstPtr = &pixelBuffer[(44 * SCREEN_W) + 120];
 
@@ -1238,6 +1306,9 @@ void renderEditOpMode(void)
 	const uint32_t *srcPtr;
 	uint32_t *dstPtr;
 
+	if (!unpackLazyBMP(&editOpModeCharsBMP))
+		return;
+
 	// select what character box to render
 
 	switch (editor.ui.editOpScreen)
@@ -1280,18 +1351,23 @@ void renderEditOpMode(void)
 void renderEditOpScreen(void)
 {
 	const uint32_t *srcPtr;
-	uint32_t *dstPtr;
+	uint32_t *dstPtr, **bmp;
 
 	// select which background to render
 	switch (editor.ui.editOpScreen)
 	{
 		default:
-		case 0: srcPtr = editOpScreen1BMP; break;
-		case 1: srcPtr = editOpScreen2BMP; break;
-		case 2: srcPtr = editOpScreen3BMP; break;
-		case 3: srcPtr = editOpScreen4BMP; break;
+		case 0: bmp = &editOpScreen1BMP; break;
+		case 1: bmp = &editOpScreen2BMP; break;
+		case 2: bmp = &editOpScreen3BMP; break;
+		case 3: bmp = &editOpScreen4BMP; break;
 	}
 
+	if (!unpackLazyBMP(bmp))
+		return;
+
+	srcPtr = *bmp;
+
 	// render background
 	dstPtr = &pixelBuffer[(44 * SCREEN_W) + 120];
 	for (uint32_t y = 0; y < 55; y++)
@@ -1347,6 +1423,9 @@ void renderMOD2WAVDialog(void)
 	const uint32_t *srcPtr;
 	uint32_t *dstPtr;
 
+	if (!unpackLazyBMP(&mod2wavBMP))
+		return;
+
 	srcPtr = mod2wavBMP;
 	dstPtr = &pixelBuffer[(27 * SCREEN_W) + 64];
 
@@ -1703,6 +1782,13 @@ void handleAskNo(void)
 		}
 		break;
 
+		case ASK_DISCARD_LOADED_SONG:
+		{
+			restoreStatusAndMousePointer();
+			abortModLoadThread(); // keep the edited song, throw the loaded one away
+		}
+		break;
+
 		default:
 		{
 			restoreStatusAndMousePointer();
@@ -1741,6 +1827,12 @@ void handleAskYes(void)
 		}
 		break;
 
+		case ASK_DISCARD_LOADED_SONG:
+		{
+			restoreStatusAndMousePointer(); // the loaded module is swapped in on the next frame
+		}
+		break;
+
 		case ASK_RESTORE_SAMPLE:
 		{
 			restoreStatusAndMousePointer();
@@ -1834,6 +1926,7 @@ void handleAskYes(void)
 			setMsgPointer();
 			editor.samplePos = 0;
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			updateCurrSample();
 		}
 		break;
@@ -1934,6 +2027,7 @@ void handleAskYes(void)
 			}
 
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			updateCurrSample();
 
 			editor.ui.updateSongSize = true;
@@ -1989,6 +2083,7 @@ void handleAskYes(void)
 			}
 
 			fixSampleBeep(s);
+			invalidateSamplePeaks();
 			updateCurrSample();
 
 			editor.ui.updateSongSize = true;
@@ -2013,6 +2108,7 @@ void handleAskYes(void)
 			memset(&modEntry->sampleData[(editor.currSample * MAX_SAMPLE_LEN)], 0, MAX_SAMPLE_LEN);
 
 			editor.samplePos = 0;
+			invalidateSamplePeaks();
 			updateCurrSample();
 
 			editor.ui.updateSongSize = true;
@@ -2360,36 +2456,73 @@ uint32_t *unpackBMP(const uint8_t *src, uint32_t packedLen)
 	return dst;
 }
 
+/* Screens and dialogs that are not part of the main screen stay in their packed
+** 2-bit form until they are shown for the first time, to keep startup fast.
+*/
+typedef struct lazyBMP_t
+{
+	uint32_t **bmp;
+	const uint8_t *packedBMP;
+	uint32_t packedLen;
+} lazyBMP_t;
+
+static const lazyBMP_t lazyBMPs[] =
+{
+	{ &samplerScreenBMP, samplerScreenPackedBMP, sizeof (samplerScreenPackedBMP) },
+	{ &samplerVolumeBMP, samplerVolumePackedBMP, sizeof (samplerVolumePackedBMP) },
+	{ &samplerFiltersBMP, samplerFiltersPackedBMP, sizeof (samplerFiltersPackedBMP) },
+	{ &clearDialogBMP, clearDialogPackedBMP, sizeof (clearDialogPackedBMP) },
+	{ &diskOpScreenBMP, diskOpScreenPackedBMP, sizeof (diskOpScreenPackedBMP) },
+	{ &mod2wavBMP, mod2wavPackedBMP, sizeof (mod2wavPackedBMP) },
+	{ &posEdBMP, posEdPackedBMP, sizeof (posEdPackedBMP) },
+	{ &spectrumVisualsBMP, spectrumVisualsPackedBMP, sizeof (spectrumVisualsPackedBMP) },
+	{ &yesNoDialogBMP, yesNoDialogPackedBMP, sizeof (yesNoDialogPackedBMP) },
+	{ &pat2SmpDialogBMP, pat2SmpDialogPackedBMP, sizeof (pat2SmpDialogPackedBMP) },
+	{ &editOpScreen1BMP, editOpScreen1PackedBMP, sizeof (editOpScreen1PackedBMP) },
+	{ &editOpScreen2BMP, editOpScreen2PackedBMP, sizeof (editOpScreen2PackedBMP) },
+	{ &editOpScreen3BMP, editOpScreen3PackedBMP, sizeof (editOpScreen3PackedBMP) },
+	{ &editOpScreen4BMP, editOpScreen4PackedBMP, sizeof (editOpScreen4PackedBMP) },
+	{ &editOpModeCharsBMP, editOpModeCharsPackedBMP, sizeof (editOpModeCharsPackedBMP) },
+	{ &aboutScreenBMP, aboutScreenPackedBMP, sizeof (aboutScreenPackedBMP) }
+};
+
+// unpacks a lazily loaded BMP on first use, returns false (and shows an error) if we're out of memory
+bool unpackLazyBMP(uint32_t **bmp)
+{
+	const lazyBMP_t *l;
+
+	if (*bmp != NULL)
+		return true;
+
+	for (uint32_t i = 0; i < sizeof (lazyBMPs) / sizeof (lazyBMP_t); i++)
+	{
+		l = &lazyBMPs[i];
+		if (l->bmp == bmp)
+		{
+			*bmp = unpackBMP(l->packedBMP, l->packedLen);
+			if (*bmp == NULL)
+			{
+				statusOutOfMemory();
+				return false;
+			}
+
+			return true;
+		}
+	}
+
+	assert(false); // not a lazily loaded BMP
+	return false;
+}
+
 bool unpackBMPs(void)
 {
+	// only the main screen graphics are unpacked here, the rest is done in unpackLazyBMP()
 	trackerFrameBMP = unpackBMP(trackerFramePackedBMP, sizeof (trackerFramePackedBMP));
-	samplerScreenBMP = unpackBMP(samplerScreenPackedBMP, sizeof (samplerScreenPackedBMP));
-	samplerVolumeBMP = unpackBMP(samplerVolumePackedBMP, sizeof (samplerVolumePackedBMP));
-	samplerFiltersBMP = unpackBMP(samplerFiltersPackedBMP, sizeof (samplerFiltersPackedBMP));
-	clearDialogBMP = unpackBMP(clearDialogPackedBMP, sizeof (clearDialogPackedBMP));
-	diskOpScreenBMP = unpackBMP(diskOpScreenPackedBMP, sizeof (diskOpScreenPackedBMP));
-	mod2wavBMP = unpackBMP(mod2wavPackedBMP, sizeof (mod2wavPackedBMP));
-	posEdBMP = unpackBMP(posEdPackedBMP, sizeof (posEdPackedBMP));
-	spectrumVisualsBMP = unpackBMP(spectrumVisualsPackedBMP, sizeof (spectrumVisualsPackedBMP));
-	yesNoDialogBMP = unpackBMP(yesNoDialogPackedBMP, sizeof (yesNoDialogPackedBMP));
-	pat2SmpDialogBMP = unpackBMP(pat2SmpDialogPackedBMP, sizeof (pat2SmpDialogPackedBMP));
-	editOpScreen1BMP = unpackBMP(editOpScreen1PackedBMP, sizeof (editOpScreen1PackedBMP));
-	editOpScreen2BMP = unpackBMP(editOpScreen2PackedBMP, sizeof (editOpScreen2PackedBMP));
-	editOpScreen3BMP = unpackBMP(editOpScreen3PackedBMP, sizeof (editOpScreen3PackedBMP));
-	editOpScreen4BMP = unpackBMP(editOpScreen4PackedBMP, sizeof (editOpScreen4PackedBMP));
-	aboutScreenBMP = unpackBMP(aboutScreenPackedBMP, sizeof (aboutScreenPackedBMP));
 	muteButtonsBMP = unpackBMP(muteButtonsPackedBMP, sizeof (muteButtonsPackedBMP));
-	editOpModeCharsBMP = unpackBMP(editOpModeCharsPackedBMP, sizeof (editOpModeCharsPackedBMP));
 
 	arrowBMP = (uint32_t *)malloc(30 * sizeof (int32_t)); // different format
 
-	if (trackerFrameBMP    == NULL || samplerScreenBMP   == NULL || samplerVolumeBMP  == NULL ||
-		clearDialogBMP     == NULL || diskOpScreenBMP    == NULL || mod2wavBMP        == NULL ||
-		posEdBMP           == NULL || spectrumVisualsBMP == NULL || yesNoDialogBMP    == NULL ||
-		editOpScreen1BMP   == NULL || editOpScreen2BMP   == NULL || editOpScreen3BMP  == NULL ||
-		editOpScreen4BMP   == NULL || aboutScreenBMP     == NULL || muteButtonsBMP    == NULL ||
-		editOpModeCharsBMP == NULL || arrowBMP           == NULL || samplerFiltersBMP == NULL ||
-		yesNoDialogBMP     == NULL)
+	if (trackerFrameBMP == NULL || muteButtonsBMP == NULL || arrowBMP == NULL)
 	{
 		showErrorMsgBox("Out of memory!");
 		return false; // BMPs are free'd in cleanUp()
@@ -2407,8 +2540,10 @@ void videoClose(void)
 	free(pixelBuffer);
 }
 
-void setupSprites(void)
+bool setupSprites(void)
 {
+	sprite_t *s;
+
 	memset(sprites, 0, sizeof (sprites));
 
 	sprites[SPRITE_MOUSE_POINTER].data = mousePointerBMP;
@@ -2446,15 +2581,50 @@ void setupSprites(void)
 	sprites[SPRITE_SAMPLING_POS_LINE].h = 64;
 	hideSprite(SPRITE_SAMPLING_POS_LINE);
 
-	// setup refresh buffer (used to clear sprites after each frame)
+	/* Sprites are separate textures that are composited on top of the frame
+	** buffer texture when presenting, so they never touch the frame buffer. */
 	for (uint32_t i = 0; i < SPRITE_NUM; i++)
-		sprites[i].refreshBuffer = (uint32_t *)malloc((sprites[i].w * sprites[i].h) * sizeof (int32_t));
+	{
+		s = &sprites[i];
+		assert(s->w * s->h <= MAX_SPRITE_PIXELS);
+
+		s->texturePixels = (uint32_t *)malloc((s->w * s->h) * sizeof (int32_t));
+		if (s->texturePixels == NULL)
+		{
+			showErrorMsgBox("Out of memory!");
+			return false;
+		}
+
+		s->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, s->w, s->h);
+		if (s->texture == NULL)
+		{
+			showErrorMsgBox("Couldn't create %dx%d GPU texture:\n%s\n\n" \
+			                "Is your GPU (+ driver) too old?", s->w, s->h, SDL_GetError());
+			return false;
+		}
+
+		SDL_SetTextureBlendMode(s->texture, SDL_BLENDMODE_BLEND);
+	}
+
+	return true;
 }
 
 void freeSprites(void)
 {
 	for (uint8_t i = 0; i < SPRITE_NUM; i++)
-		free(sprites[i].refreshBuffer);
+	{
+		if (sprites[i].texture != NULL)
+		{
+			SDL_DestroyTexture(sprites[i].texture);
+			sprites[i].texture = NULL;
+		}
+
+		if (sprites[i].texturePixels != NULL)
+		{
+			free(sprites[i].texturePixels);
+			sprites[i].texturePixels = NULL;
+		}
+	}
 }
 
 void setSpritePos(uint8_t sprite, uint16_t x, uint16_t y)
@@ -2468,58 +2638,66 @@ void hideSprite(uint8_t sprite)
 	sprites[sprite].newX = SCREEN_W;
 }
 
-void eraseSprites(void)
+// converts the sprite to ARGB (color key -> transparent), and re-uploads it only if it changed
+static void updateSpriteTexture(sprite_t *s)
 {
-	int32_t sw, sh, srcPitch, dstPitch;
+	const uint8_t *src8;
 	const uint32_t *src32;
-	uint32_t *dst32;
-	sprite_t *s;
-
-	for (int32_t i = SPRITE_NUM-1; i >= 0; i--) // erasing must be done in reverse order
-	{
-		s = &sprites[i];
-		if (s->x >= SCREEN_W) // sprite is hidden, don't erase
-			continue;
-
-		assert(s->x >= 0 && s->y >= 0 && s->refreshBuffer != NULL);
-
-		sw = s->w;
-		sh = s->h;
-		dst32 = &pixelBuffer[(s->y * SCREEN_W) + s->x];
-		src32 = s->refreshBuffer;
+	uint32_t pixels[MAX_SPRITE_PIXELS], colorKey;
+	int32_t numPixels;
 
-		// handle xy clipping
-		if (s->y+sh >= SCREEN_H) sh = SCREEN_H - s->y;
-		if (s->x+sw >= SCREEN_W) sw = SCREEN_W - s->x;
+	numPixels = s->w * s->h;
+	colorKey = s->colorKey;
 
-		srcPitch = s->w - sw;
-		dstPitch = SCREEN_W - sw;
-
-		for (int32_t y = 0; y < sh; y++)
+	if (s->pixelType == SPRITE_TYPE_RGB)
+	{
+		// 24-bit RGB sprite
+		src32 = (const uint32_t *)s->data;
+		for (int32_t i = 0; i < numPixels; i++)
+			pixels[i] = (src32[i] != colorKey) ? (0xFF000000 | src32[i]) : 0;
+	}
+	else
+	{
+		// 8-bit paletted sprite (colors can change at any time, f.ex. the mouse pointer)
+		src8 = (const uint8_t *)s->data;
+		for (int32_t i = 0; i < numPixels; i++)
 		{
-			for (int32_t x = 0; x < sw; x++)
-				*dst32++ = *src32++;
-
-			src32 += srcPitch;
-			dst32 += dstPitch;
+			if (src8[i] != colorKey)
+			{
+				assert(src8[i] < PALETTE_NUM);
+				pixels[i] = 0xFF000000 | palette[src8[i]];
+			}
+			else
+			{
+				pixels[i] = 0;
+			}
 		}
 	}
 
-	fillFromVuMetersBgBuffer(); // let's put it here even though it's not sprite-based
+	if (s->texturePixelsValid && !memcmp(pixels, s->texturePixels, numPixels * sizeof (int32_t)))
+		return;
+
+	memcpy(s->texturePixels, pixels, numPixels * sizeof (int32_t));
+	s->texturePixelsValid = true;
+
+	SDL_UpdateTexture(s->texture, NULL, s->texturePixels, s->w * sizeof (int32_t));
 }
 
+// must be called after the frame buffer texture has been copied to the renderer
 void renderSprites(void)
 {
-	const uint8_t *src8;
-	int32_t x, y, sw, sh, srcPitch, dstPitch;
-	const uint32_t *src32;
-	uint32_t *dst32, *clr32;
-	register uint32_t colorKey;
+	int32_t sw, sh, logicalW, logicalH;
+	SDL_Rect srcRect, dstRect;
 	sprite_t *s;
 
-	renderVuMeters(); // let's put it here even though it's not sprite-based
+	SDL_RenderGetLogicalSize(renderer, &logicalW, &logicalH);
+	if (logicalW <= 0 || logicalH <= 0)
+	{
+		logicalW = SCREEN_W;
+		logicalH = SCREEN_H;
+	}
 
-	for (int32_t i = 0; i < SPRITE_NUM; i++)
+	for (int32_t i = 0; i < SPRITE_NUM; i++) // sprites with a higher number are drawn on top
 	{
 		s = &sprites[i];
 
@@ -2527,69 +2705,34 @@ void renderSprites(void)
 		s->x = s->newX;
 		s->y = s->newY;
 
-		if (s->x >= SCREEN_W) // sprite is hidden, don't draw nor fill clear buffer
+		if (s->x >= SCREEN_W) // sprite is hidden
 			continue;
 
-		assert(s->x >= 0 && s->y >= 0 && s->data != NULL && s->refreshBuffer != NULL);
+		assert(s->x >= 0 && s->y >= 0 && s->data != NULL && s->texture != NULL);
 
-		sw = s->w;
-		sh = s->h;
-		dst32 = &pixelBuffer[(s->y * SCREEN_W) + s->x];
-		clr32 = s->refreshBuffer;
+		updateSpriteTexture(s);
 
 		// handle xy clipping
+		sw = s->w;
+		sh = s->h;
 		if (s->y+sh >= SCREEN_H) sh = SCREEN_H - s->y;
 		if (s->x+sw >= SCREEN_W) sw = SCREEN_W - s->x;
 
-		srcPitch = s->w - sw;
-		dstPitch = SCREEN_W - sw;
-
-		colorKey = sprites[i].colorKey;
-		if (sprites[i].pixelType == SPRITE_TYPE_RGB)
-		{
-			// 24-bit RGB sprite
-			src32 = (uint32_t *)sprites[i].data;
-			for (y = 0; y < sh; y++)
-			{
-				for (x = 0; x < sw; x++)
-				{
-					*clr32++ = *dst32; // fill clear buffer
-					if (*src32 != colorKey)
-						*dst32 = *src32;
+		if (sw <= 0 || sh <= 0)
+			continue;
 
-					dst32++;
-					src32++;
-				}
+		srcRect.x = 0;
+		srcRect.y = 0;
+		srcRect.w = sw;
+		srcRect.h = sh;
 
-				clr32 += srcPitch;
-				src32 += srcPitch;
-				dst32 += dstPitch;
-			}
-		}
-		else
-		{
-			// 8-bit paletted sprite
-			src8 = (uint8_t *)sprites[i].data;
-			for (y = 0; y < sh; y++)
-			{
-				for (x = 0; x < sw; x++)
-				{
-					*clr32++ = *dst32; // fill clear buffer
-					if (*src8 != colorKey)
-					{
-						assert(*src8 < PALETTE_NUM);
-						*dst32 = palette[*src8];
-					}
-
-					dst32++;
-					src8++;
-				}
+		// the logical render size is not SCREEN_W*SCREEN_H in stretched fullscreen mode
+		dstRect.x = (s->x * logicalW) / SCREEN_W;
+		dstRect.y = (s->y * logicalH) / SCREEN_H;
+		dstRect.w = (((s->x + sw) * logicalW) / SCREEN_W) - dstRect.x;
+		dstRect.h = (((s->y + sh) * logicalH) / SCREEN_H) - dstRect.y;
 
-				clr32 += srcPitch;
-				src8 += srcPitch;
-				dst32 += dstPitch;
-			}
-		}
+		SDL_RenderCopy(renderer, s->texture, &srcRect, &dstRect);
 	}
 }
 
@@ -2597,12 +2740,19 @@ void flipFrame(void)
 {
 	uint32_t windowFlags = SDL_GetWindowFlags(window);
 
-	renderSprites();
+	renderVuMeters(); // drawn into the frame buffer, the background is restored after presenting
+
 	SDL_UpdateTexture(texture, NULL, pixelBuffer, SCREEN_W * sizeof (int32_t));
 	SDL_RenderClear(renderer);
 	SDL_RenderCopy(renderer, texture, NULL, NULL);
+	renderSprites();
+	renderProfilerOverlay();
+
+	profilerBegin(PROF_PRESENT);
 	SDL_RenderPresent(renderer);
-	eraseSprites();
+	profilerEnd(PROF_PRESENT);
+
+	fillFromVuMetersBgBuffer();
 
 	if (!editor.ui.vsync60HzPresent)
 	{
@@ -2628,48 +2778,6 @@ void flipFrame(void)
 	}
 }
 
-void updateSpectrumAnalyzer(int8_t vol, int16_t period)
-{
-	const uint8_t maxHeight = SPECTRUM_BAR_HEIGHT + 1; // +1 because of audio latency - allows full height to be seen
-	int16_t scaledVol;
-	int32_t scaledNote;
-
-	if (editor.ui.visualizerMode != VISUAL_SPECTRUM || vol <= 0)
-		return;
-
-	scaledVol = (vol * 256) / ((64 * 256) / (SPECTRUM_BAR_NUM+1)); // 64 = max sample vol
-
-	period = CLAMP(period, 113, 856);
-
-	// 856 = C-1 period, 113 = B-3 period
-	scaledNote = (856-113) - (period - 113);
-	scaledNote *= scaledNote;
-	scaledNote /= ((856 - 113) * (856 - 113)) / (SPECTRUM_BAR_NUM-1);
-
-	// scaledNote now ranges 0..22, no need to clamp
-
-	// increment main spectrum bar
-	editor.spectrumVolumes[scaledNote] += scaledVol;
-	if (editor.spectrumVolumes[scaledNote] > maxHeight)
-		editor.spectrumVolumes[scaledNote] = maxHeight;
-
-	// increment left side of spectrum bar with half volume
-	if (scaledNote > 0)
-	{
-		editor.spectrumVolumes[scaledNote-1] += scaledVol >> 1;
-		if (editor.spectrumVolumes[scaledNote-1] > maxHeight)
-			editor.spectrumVolumes[scaledNote-1] = maxHeight;
-	}
-
-	// increment right side of spectrum bar with half volume
-	if (scaledNote < SPECTRUM_BAR_NUM-1)
-	{
-		editor.spectrumVolumes[scaledNote+1] += scaledVol >> 1;
-		if (editor.spectrumVolumes[scaledNote+1] > maxHeight)
-			editor.spectrumVolumes[scaledNote+1] = maxHeight;
-	}
-}
-
 void sinkVisualizerBars(void)
 {
 	// sink stuff @ 50Hz rate
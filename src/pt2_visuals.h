@@ -30,7 +30,6 @@ void handleAskYes(void);
 bool setupVideo(void);
 void renderFrame(void);
 void flipFrame(void);
-void updateSpectrumAnalyzer(int8_t vol, int16_t period);
 void sinkVisualizerBars(void);
 void updatePosEd(void);
 void updateVisualizer(void);
@@ -39,6 +38,7 @@ void updateDiskOp(void);
 void toggleFullScreen(void);
 void videoClose(void);
 bool unpackBMPs(void);
+bool unpackLazyBMP(uint32_t **bmp);
 void createBitmaps(void);
 void displayMainScreen(void);
 void renderAskDialog(void);
@@ -64,13 +64,12 @@ void fillToVuMetersBgBuffer(void);
 void showVolFromSlider(void);
 void showVolToSlider(void);
 void updateCurrSample(void);
-void eraseSprites(void);
 void renderSprites(void);
 void updateDragBars(void);
 void invertRange(void);
 void updateCursorPos(void);
 void renderVuMeters(void);
-void setupSprites(void);
+bool setupSprites(void);
 void freeSprites(void);
 void setSpritePos(uint8_t sprite, uint16_t x, uint16_t y);
 void hideSprite(uint8_t sprite);
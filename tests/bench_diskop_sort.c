@@ -0,0 +1,337 @@
+/* Benchmark for the Disk Op. directory listing (pt2_diskop.c): lists a
+** directory with 50000 synthetic entries (files and directories with mixed-case
+** names) and checks that the shown order is the _stricmp() order, directories
+** first. The old sort (shell/bubble hybrid, two malloc'd names per comparison)
+** is timed on the same names for comparison.
+**
+** usage: bench_diskop_sort [entries] [entries for the old sort (default: all)]
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <SDL2/SDL.h>
+#include "pt2_header.h"
+#include "pt2_config.h"
+#include "pt2_diskop.h"
+
+#define DEFAULT_ENTRIES 50000
+#define DIR_EVERY 50 /* every 50th entry is a directory */
+
+typedef struct sortEntry_t
+{
+	char *name;
+	bool isDir;
+} sortEntry_t;
+
+static char tempDir[] = "/tmp/pt2_bench_diskop_XXXXXX";
+static uint32_t randSeed = 0x12345678;
+
+static uint32_t random32(void)
+{
+	randSeed = (randSeed * 1103515245) + 12345;
+	return randSeed >> 8;
+}
+
+static void makeEntryName(char *name, int32_t i)
+{
+	static const char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 _-";
+	static const char *exts[] = { ".wav", ".IFF", ".raw", ".aiff", ".8SVX" };
+
+	const int32_t len = 4 + (random32() % 24);
+	for (int32_t j = 0; j < len; j++)
+		name[j] = chars[random32() % (sizeof (chars) - 1)];
+
+	// the entry number makes the name unique
+	sprintf(&name[len], "%05d%s", i, (i % DIR_EVERY == 0) ? "" : exts[random32() % 5]);
+}
+
+static bool createEntries(int32_t numEntries)
+{
+	char name[64];
+	int fd;
+
+	for (int32_t i = 0; i < numEntries; i++)
+	{
+		makeEntryName(name, i);
+
+		if (i % DIR_EVERY == 0)
+		{
+			if (mkdir(name, 0755) != 0)
+				return false;
+		}
+		else
+		{
+			fd = open(name, O_WRONLY | O_CREAT | O_EXCL, 0644);
+			if (fd < 0)
+				return false;
+
+			close(fd);
+		}
+	}
+
+	return true;
+}
+
+static void removeEntries(int32_t numEntries)
+{
+	char name[64];
+
+	randSeed = 0x12345678; // same names as in createEntries()
+	for (int32_t i = 0; i < numEntries; i++)
+	{
+		makeEntryName(name, i);
+
+		if (i % DIR_EVERY == 0)
+			rmdir(name);
+		else
+			unlink(name);
+	}
+}
+
+// the order the list must have, directories first and ".." before everything else
+static int32_t compareEntries(const sortEntry_t *a, const sortEntry_t *b)
+{
+	if (a->isDir != b->isDir)
+		return a->isDir ? -1 : 1;
+
+	if (a->isDir)
+	{
+		const bool parentA = !strcmp(a->name, ".."), parentB = !strcmp(b->name, "..");
+		if (parentA != parentB)
+			return parentA ? -1 : 1;
+	}
+
+	return _stricmp(a->name, b->name);
+}
+
+// the sort before precomputed sort keys, as it was in pt2_diskop.c
+static char *getSortEntryOld(const sortEntry_t *entry)
+{
+	char *p;
+
+	const int32_t nameLen = (int32_t)strlen(entry->name);
+	if (nameLen == 0)
+		return NULL;
+
+	p = (char *)malloc(nameLen + 2);
+	if (p == NULL)
+		return NULL;
+
+	if (entry->isDir)
+	{
+		if (nameLen == 2 && entry->name[0] == '.' && entry->name[1] == '.')
+			p[0] = 0x01; // make ".." directory first priority
+		else
+			p[0] = 0x02; // make second priority
+
+		strcpy(&p[1], entry->name);
+	}
+	else
+	{
+		strcpy(p, entry->name);
+	}
+
+	return p;
+}
+
+static bool sortEntriesOld(sortEntry_t *entries, int32_t numEntries)
+{
+	bool didSwap;
+	char *p1, *p2;
+	uint32_t offset, limit, i;
+	sortEntry_t tmp;
+
+	if (numEntries < 2)
+		return true;
+
+	offset = numEntries / 2;
+	while (offset > 0)
+	{
+		limit = numEntries - offset;
+		do
+		{
+			didSwap = false;
+			for (i = 0; i < limit; i++)
+			{
+				p1 = getSortEntryOld(&entries[i]);
+				p2 = getSortEntryOld(&entries[offset + i]);
+
+				if (p1 == NULL || p2 == NULL)
+				{
+					if (p1 != NULL) free(p1);
+					if (p2 != NULL) free(p2);
+					return false;
+				}
+
+				if (_stricmp(p1, p2) > 0)
+				{
+					tmp = entries[i];
+					entries[i] = entries[offset + i];
+					entries[offset + i] = tmp;
+
+					didSwap = true;
+				}
+
+				free(p1);
+				free(p2);
+			}
+		}
+		while (didSwap);
+
+		offset /= 2;
+	}
+
+	return true;
+}
+
+static double getSeconds(uint64_t time64)
+{
+	return time64 / (double)SDL_GetPerformanceFrequency();
+}
+
+// lists tempDir like the Disk Op. screen does, returns the time until the list is complete
+static double listDir(void)
+{
+	static uint32_t frameBuffer[SCREEN_W * SCREEN_H];
+	uint64_t time64;
+
+	editor.diskop.rescan = true; // don't show the cached listing
+	diskOpSetPath(tempDir, DISKOP_CACHE);
+
+	time64 = SDL_GetPerformanceCounter();
+	diskOpRenderFileList(frameBuffer); // starts the fill thread
+	while (editor.diskop.isFilling)
+		SDL_Delay(1);
+	time64 = SDL_GetPerformanceCounter() - time64;
+
+	return getSeconds(time64);
+}
+
+int main(int argc, char *argv[])
+{
+	bool ok = false;
+	int32_t numEntries, numOldEntries, numShown;
+	uint64_t time64;
+	double dListTime, dBestListTime, dOldSortTime;
+	sortEntry_t *shown = NULL;
+
+	numEntries = (argc >= 2) ? atoi(argv[1]) : DEFAULT_ENTRIES;
+	numOldEntries = (argc >= 3) ? atoi(argv[2]) : INT32_MAX;
+	if (numEntries < 1)
+		numEntries = 1;
+
+	if (!allocDiskOpVars())
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	ptConfig.diskOpModTitles = false;
+	editor.diskop.mode = DISKOP_MODE_SMP; // lists all files
+
+	if (mkdtemp(tempDir) == NULL || chdir(tempDir) != 0)
+	{
+		fprintf(stderr, "can't create %s\n", tempDir);
+		return 1;
+	}
+
+	if (!createEntries(numEntries))
+	{
+		fprintf(stderr, "can't create the entries in %s\n", tempDir);
+		goto error;
+	}
+
+	dBestListTime = listDir();
+	for (int32_t run = 0; run < 2; run++)
+	{
+		dListTime = listDir();
+		if (dListTime < dBestListTime)
+			dBestListTime = dListTime;
+	}
+
+	// read back the shown order (the ".." directory is listed too)
+	numShown = editor.diskop.numEntries;
+	if (numShown != numEntries+1)
+	{
+		fprintf(stderr, "%d entries listed, expected %d\n", numShown, numEntries+1);
+		goto error;
+	}
+
+	shown = (sortEntry_t *)calloc(numShown, sizeof (sortEntry_t));
+	if (shown == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		goto error;
+	}
+
+	for (int32_t i = 0; i < numShown; i++)
+	{
+		editor.diskop.scrollOffset = i;
+		shown[i].name = strdup(diskOpGetAnsiEntry(0));
+		shown[i].isDir = diskOpEntryIsDir(0);
+
+		if (shown[i].name == NULL)
+		{
+			fprintf(stderr, "out of memory\n");
+			goto error;
+		}
+
+		if (i > 0 && compareEntries(&shown[i-1], &shown[i]) > 0)
+		{
+			fprintf(stderr, "wrong order at entry %d: \"%s\" before \"%s\"\n", i, shown[i-1].name, shown[i].name);
+			goto error;
+		}
+	}
+
+	// the old sort on the same entries, shuffled like a directory listing
+	if (numOldEntries > numShown)
+		numOldEntries = numShown;
+
+	for (int32_t i = 0; i < numOldEntries; i++)
+	{
+		const int32_t j = (int32_t)(random32() % (uint32_t)(numShown - i)) + i;
+		sortEntry_t tmp = shown[i];
+		shown[i] = shown[j];
+		shown[j] = tmp;
+	}
+
+	time64 = SDL_GetPerformanceCounter();
+	if (!sortEntriesOld(shown, numOldEntries))
+	{
+		fprintf(stderr, "out of memory\n");
+		goto error;
+	}
+	dOldSortTime = getSeconds(SDL_GetPerformanceCounter() - time64);
+
+	printf("list %d entries (read + sort): %8.2fms\n", numShown, dBestListTime * 1000.0);
+	if (numOldEntries > 0)
+		printf("old sort of %d entries:        %8.2fms\n", numOldEntries, dOldSortTime * 1000.0);
+
+	ok = true;
+
+error:
+	if (shown != NULL)
+	{
+		for (int32_t i = 0; i < numEntries+1; i++)
+		{
+			if (shown[i].name != NULL)
+				free(shown[i].name);
+		}
+
+		free(shown);
+	}
+
+	freeDiskOpMem();
+
+	removeEntries(numEntries);
+	if (chdir("/tmp") == 0)
+		rmdir(tempDir);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+/* Benchmark for the Disk Op. directory listing on slow file systems
+** (pt2_diskop.c). The same directory is listed three times:
+**
+**  - local: as is
+**  - remote: every stat()/fstatat() call is delayed, like on NFS/SMB/FUSE
+**  - remote, no d_type: also readdir() doesn't know the entry types (DT_UNKNOWN),
+**    like on many network and FUSE file systems
+**
+** The delays come from wrapping the libc calls at link time (-Wl,--wrap, see
+** tests/CMakeLists.txt), so this only builds on Linux. Each run lists the
+** directory and draws the first screen of it. Files must not be stat'ed while
+** listing when readdir() knows the entry types, only when they are shown.
+**
+** usage: bench_diskop_stat [entries] [stat latency in microseconds]
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <SDL2/SDL.h>
+#include "pt2_header.h"
+#include "pt2_config.h"
+#include "pt2_diskop.h"
+
+#define DEFAULT_ENTRIES 2000
+#define DEFAULT_LATENCY_US 500 /* a stat() round trip to a file server */
+#define NUM_DIRS 5 /* the first screen shows ".." and these, then files */
+
+int __real_stat(const char *path, struct stat *st);
+int __real_fstatat(int fd, const char *path, struct stat *st, int flag);
+struct dirent *__real_readdir(DIR *dir);
+
+static char tempDir[] = "/tmp/pt2_bench_diskop_XXXXXX";
+static volatile bool remote, noDirEntryTypes;
+static int32_t latencyUs;
+static SDL_atomic_t numStatCalls;
+
+static void remoteDelay(void)
+{
+	SDL_AtomicAdd(&numStatCalls, 1);
+	if (remote)
+		usleep(latencyUs);
+}
+
+int __wrap_stat(const char *path, struct stat *st)
+{
+	remoteDelay();
+	return __real_stat(path, st);
+}
+
+int __wrap_fstatat(int fd, const char *path, struct stat *st, int flag)
+{
+	remoteDelay();
+	return __real_fstatat(fd, path, st, flag);
+}
+
+struct dirent *__wrap_readdir(DIR *dir)
+{
+	struct dirent *entry = __real_readdir(dir);
+	if (entry != NULL && noDirEntryTypes)
+		entry->d_type = DT_UNKNOWN;
+
+	return entry;
+}
+
+static void getEntryName(char *name, int32_t i)
+{
+	sprintf(name, (i < NUM_DIRS) ? "Dir%05d" : "Sample%05d.wav", i);
+}
+
+static bool createEntries(int32_t numEntries)
+{
+	char name[64];
+	int fd;
+
+	for (int32_t i = 0; i < numEntries; i++)
+	{
+		getEntryName(name, i);
+
+		if (i < NUM_DIRS)
+		{
+			if (mkdir(name, 0755) != 0)
+				return false;
+		}
+		else
+		{
+			fd = open(name, O_WRONLY | O_CREAT | O_EXCL, 0644);
+			if (fd < 0)
+				return false;
+
+			close(fd);
+		}
+	}
+
+	return true;
+}
+
+static void removeEntries(int32_t numEntries)
+{
+	char name[64];
+
+	for (int32_t i = 0; i < numEntries; i++)
+	{
+		getEntryName(name, i);
+
+		if (i < NUM_DIRS)
+			rmdir(name);
+		else
+			unlink(name);
+	}
+}
+
+static double getMs(uint64_t time64)
+{
+	return (time64 * 1000.0) / (double)SDL_GetPerformanceFrequency();
+}
+
+// lists tempDir and draws the first screen of it, like the Disk Op. screen does
+static bool listDir(const char *text, int32_t numEntries)
+{
+	static uint32_t frameBuffer[SCREEN_W * SCREEN_H];
+	int32_t numFillStats, numShowStats;
+	uint64_t time64, fillTime64;
+
+	editor.diskop.rescan = true; // don't show the cached listing
+	diskOpSetPath(tempDir, DISKOP_CACHE);
+
+	SDL_AtomicSet(&numStatCalls, 0);
+
+	time64 = SDL_GetPerformanceCounter();
+	diskOpRenderFileList(frameBuffer); // starts the fill thread
+	while (editor.diskop.isFilling)
+		SDL_Delay(1);
+	fillTime64 = SDL_GetPerformanceCounter() - time64;
+
+	numFillStats = SDL_AtomicGet(&numStatCalls);
+	diskOpRenderFileList(frameBuffer); // the shown files are stat'ed here
+	time64 = SDL_GetPerformanceCounter() - time64;
+	numShowStats = SDL_AtomicGet(&numStatCalls) - numFillStats;
+
+	printf("%-20s %9.2fms (listing: %9.2fms, %5d stats, first screen: %2d stats)\n",
+		text, getMs(time64), getMs(fillTime64), numFillStats, numShowStats);
+
+	if (editor.diskop.numEntries != numEntries+1) // the ".." directory is listed too
+	{
+		fprintf(stderr, "%d entries listed, expected %d\n", editor.diskop.numEntries, numEntries+1);
+		return false;
+	}
+
+	if (!noDirEntryTypes && numFillStats > 1) // the directory itself may be stat'ed to see if it changed
+	{
+		fprintf(stderr, "files were stat'ed while listing\n");
+		return false;
+	}
+
+	if (numShowStats > DISKOP_LINES)
+	{
+		fprintf(stderr, "more files were stat'ed than shown\n");
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	bool ok = false;
+	int32_t numEntries;
+
+	numEntries = (argc >= 2) ? atoi(argv[1]) : DEFAULT_ENTRIES;
+	latencyUs = (argc >= 3) ? atoi(argv[2]) : DEFAULT_LATENCY_US;
+	if (numEntries < 1)
+		numEntries = 1;
+
+	if (latencyUs < 0)
+		latencyUs = 0;
+
+	if (!allocDiskOpVars())
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	ptConfig.diskOpModTitles = false;
+	editor.diskop.mode = DISKOP_MODE_SMP; // lists all files
+
+	if (mkdtemp(tempDir) == NULL || chdir(tempDir) != 0)
+	{
+		fprintf(stderr, "can't create %s\n", tempDir);
+		return 1;
+	}
+
+	if (!createEntries(numEntries))
+	{
+		fprintf(stderr, "can't create the entries in %s\n", tempDir);
+		goto error;
+	}
+
+	printf("%d entries, remote stat latency %dus:\n", numEntries, latencyUs);
+
+	if (!listDir("local:", numEntries))
+		goto error;
+
+	remote = true;
+	if (!listDir("remote:", numEntries))
+		goto error;
+
+	noDirEntryTypes = true;
+	if (!listDir("remote, no d_type:", numEntries))
+		goto error;
+
+	ok = true;
+
+error:
+	remote = noDirEntryTypes = false;
+	freeDiskOpMem();
+
+	removeEntries(numEntries);
+	if (chdir("/tmp") == 0)
+		rmdir(tempDir);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+/* Benchmark for the text renderer (pt2_textout.c): draws a full screen of text
+** (40x42 characters) with textOut() and textOutBg(), and with the old
+** pixel-by-pixel renderer for comparison. The outputs must be identical.
+**
+** usage: bench_font [screens per run]
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+#include "pt2_header.h"
+#include "pt2_tables.h"
+#include "pt2_textout.h"
+
+#define DEFAULT_SCREENS 500
+#define TEXT_COLS (SCREEN_W / FONT_CHAR_W)
+#define TEXT_ROWS (SCREEN_H / (FONT_CHAR_H + 1))
+#define FG_COLOR 0xBBBBBB
+#define BG_COLOR 0x000000
+
+static char screenText[TEXT_ROWS][TEXT_COLS + 1];
+static uint32_t frameNew[SCREEN_W * SCREEN_H], frameRef[SCREEN_W * SCREEN_H];
+
+/* The renderer before the font was stored as packed rows (one byte per pixel,
+** tested one pixel at a time). Its font is expanded from fontBMP. */
+static uint8_t fontBytes[256 * FONT_CHAR_W * FONT_CHAR_H];
+
+static void charOutRef(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, char ch, uint32_t color)
+{
+	const uint8_t *srcPtr;
+	uint32_t *dstPtr;
+
+	if (ch == '\0')
+		return;
+
+	srcPtr = &fontBytes[(uint8_t)ch * (FONT_CHAR_W * FONT_CHAR_H)];
+	dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
+
+	for (uint32_t y = 0; y < FONT_CHAR_H; y++)
+	{
+		for (uint32_t x = 0; x < FONT_CHAR_W; x++)
+		{
+			if (srcPtr[x])
+				dstPtr[x] = color;
+		}
+
+		srcPtr += FONT_CHAR_W;
+		dstPtr += SCREEN_W;
+	}
+}
+
+static void charOutBgRef(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, char ch, uint32_t fgColor, uint32_t bgColor)
+{
+	const uint8_t *srcPtr;
+	uint32_t *dstPtr;
+
+	if (ch == '\0')
+		return;
+
+	if (ch < ' ' || ch > '~')
+		ch = ' ';
+
+	srcPtr = &fontBytes[(uint8_t)ch * (FONT_CHAR_W * FONT_CHAR_H)];
+	dstPtr = &frameBuffer[(yPos * SCREEN_W) + xPos];
+
+	for (uint32_t y = 0; y < FONT_CHAR_H; y++)
+	{
+		for (uint32_t x = 0; x < FONT_CHAR_W; x++)
+			dstPtr[x] = srcPtr[x] ? fgColor : bgColor;
+
+		srcPtr += FONT_CHAR_W;
+		dstPtr += SCREEN_W;
+	}
+}
+
+static void textOutRef(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, const char *text, uint32_t color)
+{
+	uint32_t x = xPos;
+	while (*text != '\0')
+	{
+		charOutRef(frameBuffer, x, yPos, *text++, color);
+		x += FONT_CHAR_W;
+	}
+}
+
+static void textOutBgRef(uint32_t *frameBuffer, uint32_t xPos, uint32_t yPos, const char *text, uint32_t fgColor, uint32_t bgColor)
+{
+	uint32_t x = xPos;
+	while (*text != '\0')
+	{
+		charOutBgRef(frameBuffer, x, yPos, *text++, fgColor, bgColor);
+		x += FONT_CHAR_W;
+	}
+}
+
+static void expandFont(void)
+{
+	for (uint32_t i = 0; i < 256 * FONT_CHAR_H; i++)
+	{
+		for (uint32_t x = 0; x < FONT_CHAR_W; x++)
+			fontBytes[(i * FONT_CHAR_W) + x] = (fontBMP[i] >> (7 - x)) & 1;
+	}
+}
+
+static void drawScreen(int32_t mode, uint32_t *frameBuffer)
+{
+	for (uint32_t i = 0; i < TEXT_ROWS; i++)
+	{
+		const uint32_t y = i * (FONT_CHAR_H + 1);
+
+		switch (mode)
+		{
+			case 0: textOut(frameBuffer, 0, y, screenText[i], FG_COLOR); break;
+			case 1: textOutRef(frameBuffer, 0, y, screenText[i], FG_COLOR); break;
+			case 2: textOutBg(frameBuffer, 0, y, screenText[i], FG_COLOR, BG_COLOR); break;
+			default: textOutBgRef(frameBuffer, 0, y, screenText[i], FG_COLOR, BG_COLOR); break;
+		}
+	}
+}
+
+// microseconds per screen, best of five runs
+static double timeScreens(int32_t mode, uint32_t *frameBuffer, int32_t numScreens)
+{
+	uint64_t time64, bestTime64 = UINT64_MAX;
+
+	for (int32_t run = 0; run < 5; run++)
+	{
+		time64 = SDL_GetPerformanceCounter();
+		for (int32_t i = 0; i < numScreens; i++)
+			drawScreen(mode, frameBuffer);
+		time64 = SDL_GetPerformanceCounter() - time64;
+
+		if (time64 < bestTime64)
+			bestTime64 = time64;
+	}
+
+	return (bestTime64 * 1000000.0) / ((double)SDL_GetPerformanceFrequency() * numScreens);
+}
+
+int main(int argc, char *argv[])
+{
+	bool same;
+	int32_t numScreens;
+	double dNewUs, dRefUs, dNewBgUs, dRefBgUs;
+
+	numScreens = (argc >= 2) ? atoi(argv[1]) : DEFAULT_SCREENS;
+	if (numScreens < 1)
+		numScreens = 1;
+
+	expandFont();
+
+	// all printable characters, shifted on every line
+	for (uint32_t i = 0; i < TEXT_ROWS; i++)
+	{
+		for (uint32_t j = 0; j < TEXT_COLS; j++)
+			screenText[i][j] = (char)(' ' + ((i + (j * 7)) % 95));
+
+		screenText[i][TEXT_COLS] = '\0';
+	}
+
+	// same output?
+	memset(frameNew, 0, sizeof (frameNew));
+	memset(frameRef, 0, sizeof (frameRef));
+	drawScreen(0, frameNew);
+	drawScreen(1, frameRef);
+	same = !memcmp(frameNew, frameRef, sizeof (frameNew));
+
+	drawScreen(2, frameNew);
+	drawScreen(3, frameRef);
+	same = same && !memcmp(frameNew, frameRef, sizeof (frameNew));
+
+	if (!same)
+	{
+		fprintf(stderr, "textOut()/textOutBg() output differs from the reference\n");
+		return 1;
+	}
+
+	dNewUs = timeScreens(0, frameNew, numScreens);
+	dRefUs = timeScreens(1, frameRef, numScreens);
+	dNewBgUs = timeScreens(2, frameNew, numScreens);
+	dRefBgUs = timeScreens(3, frameRef, numScreens);
+
+	printf("full screen (%dx%d chars):\n", TEXT_COLS, TEXT_ROWS);
+	printf("  textOut():   %7.2fus (old: %7.2fus)\n", dNewUs, dRefUs);
+	printf("  textOutBg(): %7.2fus (old: %7.2fus)\n", dNewBgUs, dRefBgUs);
+
+	return 0;
+}
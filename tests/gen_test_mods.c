@@ -0,0 +1,520 @@
+/* Writes the module corpus for the render hash test (see render_hash.cmake).
+**
+** usage: gen_test_mods <output dir>
+**
+** Every module is made from fixed pattern data and a fixed-seed PRNG, so the
+** files are the same on every run and platform. The fx_*.mod modules each
+** exercise one group of effects (with the replayer quirks the clone has to
+** match), the rnd_*.mod modules are dense random patterns with all effects.
+** If you add a module here, regenerate golden/render_hash.txt with a known
+** good build (see tests/CMakeLists.txt).
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define MOD_HEADER_LEN 1084
+#define MAX_PATTERNS 16
+#define PATTERN_LEN 1024
+#define MAX_SAMPLE_LEN 8192 /* in bytes */
+
+enum
+{
+	WAVE_SQUARE = 0,
+	WAVE_SAW = 1,
+	WAVE_SINE = 2,
+	WAVE_NOISE = 3
+};
+
+typedef struct testSample_t
+{
+	uint16_t length, loopStart, loopLength; // in words
+	uint8_t fineTune, volume;
+	int8_t data[MAX_SAMPLE_LEN];
+} testSample_t;
+
+static const int16_t periods[36] =
+{
+	856,808,762,720,678,640,604,570,538,508,480,453, // C-1 to B-1
+	428,404,381,360,339,320,302,285,269,254,240,226, // C-2 to B-2
+	214,202,190,180,170,160,151,143,135,127,120,113  // C-3 to B-3
+};
+
+// 8-bit sine, quarter wave
+static const uint8_t sineTable[17] =
+{
+	0x00,0x0C,0x18,0x24,0x2F,0x3A,0x45,0x4F,0x59,0x62,0x6A,0x71,0x77,0x7C,0x7F,0x80,0x80
+};
+
+static char songName[21];
+static uint8_t orders[128], numOrders, patterns[MAX_PATTERNS][PATTERN_LEN];
+static uint32_t randSeed;
+static testSample_t samples[31];
+
+static uint32_t random32(void)
+{
+	randSeed = (randSeed * 1103515245) + 12345;
+	return randSeed >> 8;
+}
+
+static int32_t randomRange(int32_t min, int32_t max) // inclusive
+{
+	return min + (int32_t)(random32() % (uint32_t)(max - min + 1));
+}
+
+static void newMod(const char *name, uint32_t seed)
+{
+	memset(songName, 0, sizeof (songName));
+	strncpy(songName, name, 20);
+
+	memset(orders, 0, sizeof (orders));
+	memset(patterns, 0, sizeof (patterns));
+	memset(samples, 0, sizeof (samples));
+	numOrders = 0;
+
+	randSeed = seed;
+}
+
+static void setOrders(const uint8_t *list, uint8_t num)
+{
+	memcpy(orders, list, num);
+	numOrders = num;
+}
+
+// length/loop in words, loopLength 0 = no loop
+static void setSample(int32_t smp, int32_t wave, uint16_t length, uint16_t loopStart, uint16_t loopLength, uint8_t fineTune, uint8_t volume)
+{
+	int32_t i, phase;
+	testSample_t *s = &samples[smp-1];
+
+	s->length = length;
+	s->loopStart = (loopLength > 1) ? loopStart : 0;
+	s->loopLength = (loopLength > 1) ? loopLength : 1;
+	s->fineTune = fineTune & 0xF;
+	s->volume = volume;
+
+	for (i = 0; i < length*2; i++)
+	{
+		phase = i & 63;
+		switch (wave)
+		{
+			case WAVE_SQUARE: s->data[i] = (phase < 32) ? 96 : -96; break;
+			case WAVE_SAW: s->data[i] = (int8_t)((phase * 4) - 128); break;
+			case WAVE_SINE:
+			{
+				const int32_t q = phase & 15;
+				int32_t y = sineTable[(phase & 16) ? (16-q) : q];
+				if (y > 127)
+					y = 127;
+
+				s->data[i] = (int8_t)((phase < 32) ? y : -y);
+			}
+			break;
+
+			default: s->data[i] = (int8_t)random32(); break;
+		}
+	}
+}
+
+// note = 0..35 (C-1..B-3), -1 = none
+static void setNote(int32_t pat, int32_t row, int32_t ch, int32_t note, int32_t smp, int32_t cmd, int32_t param)
+{
+	uint8_t *p = &patterns[pat][(row * 16) + (ch * 4)];
+	const int32_t period = (note >= 0) ? periods[note] : 0;
+
+	p[0] = (uint8_t)((smp & 0xF0) | (period >> 8));
+	p[1] = (uint8_t)(period & 0xFF);
+	p[2] = (uint8_t)(((smp & 0x0F) << 4) | (cmd & 0x0F));
+	p[3] = (uint8_t)param;
+}
+
+static void setFx(int32_t pat, int32_t row, int32_t ch, int32_t cmd, int32_t param)
+{
+	uint8_t *p = &patterns[pat][(row * 16) + (ch * 4)];
+
+	p[2] = (uint8_t)((p[2] & 0xF0) | (cmd & 0x0F));
+	p[3] = (uint8_t)param;
+}
+
+static void putWord(uint8_t *dst, uint16_t x)
+{
+	dst[0] = (uint8_t)(x >> 8);
+	dst[1] = (uint8_t)(x & 0xFF);
+}
+
+static bool writeMod(const char *dir, const char *fileName)
+{
+	char path[1024];
+	uint8_t header[MOD_HEADER_LEN], numPatterns;
+	int32_t i;
+	FILE *f;
+
+	memset(header, 0, sizeof (header));
+	memcpy(header, songName, 20);
+
+	for (i = 0; i < 31; i++)
+	{
+		uint8_t *h = &header[20 + (i * 30)];
+		testSample_t *s = &samples[i];
+
+		if (s->length > 0)
+			snprintf((char *)h, 22, "sample %02d", i + 1);
+
+		putWord(&h[22], s->length);
+		h[24] = s->fineTune;
+		h[25] = s->volume;
+		putWord(&h[26], s->loopStart);
+		putWord(&h[28], s->loopLength);
+	}
+
+	numPatterns = 0;
+	for (i = 0; i < numOrders; i++)
+	{
+		if (orders[i] >= numPatterns)
+			numPatterns = orders[i] + 1;
+	}
+
+	header[950] = numOrders;
+	header[951] = 127;
+	memcpy(&header[952], orders, 128);
+	memcpy(&header[1080], "M.K.", 4);
+
+	snprintf(path, sizeof (path), "%s/%s", dir, fileName);
+
+	f = fopen(path, "wb");
+	if (f == NULL)
+	{
+		fprintf(stderr, "gen_test_mods: can't write %s\n", path);
+		return false;
+	}
+
+	fwrite(header, 1, MOD_HEADER_LEN, f);
+	fwrite(patterns, PATTERN_LEN, numPatterns, f);
+
+	for (i = 0; i < 31; i++)
+		fwrite(samples[i].data, 1, samples[i].length * 2, f);
+
+	if (fclose(f) != 0)
+	{
+		fprintf(stderr, "gen_test_mods: can't write %s\n", path);
+		return false;
+	}
+
+	return true;
+}
+
+// E6x pattern loop: single loops, two channels looping at once, loop on row 0, and E6x + Dxx
+static bool genPatternLoop(const char *dir)
+{
+	const uint8_t list[] = { 0, 1, 2 };
+	int32_t row;
+
+	newMod("fx pattern loop", 1);
+	setOrders(list, sizeof (list));
+	setSample(1, WAVE_SQUARE, 32, 0, 32, 0, 48);
+	setSample(2, WAVE_SAW, 1200, 0, 0, 0, 64);
+
+	for (row = 0; row < 64; row += 2)
+		setNote(0, row, 0, (row / 2) % 24, 1, 0, 0);
+
+	setFx(0, 4, 1, 0xE, 0x60);
+	setNote(0, 6, 1, 12, 2, 0, 0);
+	setFx(0, 10, 1, 0xE, 0x62);
+	setFx(0, 16, 2, 0xE, 0x60); // two loops on the same rows
+	setFx(0, 16, 3, 0xE, 0x60);
+	setNote(0, 18, 2, 19, 2, 0xC, 0x20);
+	setFx(0, 20, 2, 0xE, 0x61);
+	setFx(0, 22, 3, 0xE, 0x63);
+	setFx(0, 30, 1, 0xE, 0x60);
+	setNote(0, 34, 1, 17, 2, 0, 0);
+	setFx(0, 40, 1, 0xE, 0x63);
+
+	setFx(1, 0, 0, 0xE, 0x60); // loop start on row 0
+	for (row = 0; row < 8; row++)
+		setNote(1, row, 1, 24 - row, 2, 0, 0);
+	setFx(1, 7, 0, 0xE, 0x62);
+	setFx(1, 12, 0, 0xE, 0x60);
+	setNote(1, 13, 2, 7, 1, 0, 0);
+	setFx(1, 14, 0, 0xE, 0x61);
+	setFx(1, 14, 3, 0xD, 0x10); // break on the same row as the loop end
+
+	setFx(2, 0, 0, 0xF, 0x03);
+	setNote(2, 2, 1, 5, 2, 0, 0);
+	setFx(2, 4, 1, 0xE, 0x60);
+	setNote(2, 5, 2, 9, 1, 0, 0);
+	setFx(2, 8, 1, 0xE, 0x6F); // long loop
+	setFx(2, 9, 0, 0xD, 0x00);
+
+	return writeMod(dir, "fx_pattern_loop.mod");
+}
+
+// EEx pattern delay, with note delay, retrig, pattern loop and position jump on delayed rows
+static bool genPatternDelay(const char *dir)
+{
+	const uint8_t list[] = { 0, 1 };
+	int32_t row;
+
+	newMod("fx pattern delay", 2);
+	setOrders(list, sizeof (list));
+	setSample(1, WAVE_SINE, 64, 0, 64, 0, 64);
+	setSample(2, WAVE_NOISE, 800, 0, 0, 3, 40);
+
+	for (row = 0; row < 64; row += 4)
+		setNote(0, row, 0, 12 + ((row / 4) % 12), 1, 0, 0);
+
+	setFx(0, 4, 1, 0xE, 0xE2);
+	setNote(0, 8, 2, 16, 2, 0xE, 0xD3); // note delay on a delayed row
+	setFx(0, 8, 1, 0xE, 0xE1);
+	setNote(0, 12, 2, 20, 2, 0xE, 0x92);
+	setFx(0, 12, 3, 0xE, 0xE3);
+	setFx(0, 20, 1, 0xE, 0x60);
+	setFx(0, 22, 2, 0xE, 0xE2);
+	setFx(0, 24, 1, 0xE, 0x61);
+	setFx(0, 25, 3, 0xE, 0xE1); // (E6x and EEx on the same row loop forever in PT)
+	setNote(0, 30, 2, 4, 2, 0xA, 0x04);
+	setFx(0, 30, 3, 0xE, 0xEF);
+	setFx(0, 32, 3, 0xE, 0xE1);
+	setFx(0, 32, 1, 0xE, 0xE3); // two delays on one row, the last channel wins
+	setFx(0, 40, 3, 0xE, 0xC2);
+
+	setNote(1, 0, 1, 7, 1, 0xE, 0xE4);
+	setNote(1, 2, 1, 9, 2, 0x3, 0x08);
+	setFx(1, 4, 0, 0xE, 0xE2);
+	setFx(1, 4, 2, 0xB, 0x00); // jump on a delayed row
+
+	return writeMod(dir, "fx_pattern_delay.mod");
+}
+
+// EFx invert loop: all speeds, turned off by EF0, a sample switch, and a one-shot sample
+static bool genInvertLoop(const char *dir)
+{
+	const uint8_t list[] = { 0, 1 };
+	int32_t row;
+
+	newMod("fx invert loop", 3);
+	setOrders(list, sizeof (list));
+	setSample(1, WAVE_SAW, 64, 0, 64, 0, 64);
+	setSample(2, WAVE_SQUARE, 96, 32, 64, 0, 48);
+	setSample(3, WAVE_SINE, 400, 0, 0, 0, 64);
+
+	setNote(0, 0, 0, 12, 1, 0, 0);
+	setNote(0, 0, 1, 19, 2, 0, 0);
+	for (row = 0; row < 16; row++)
+	{
+		setFx(0, row * 2, 0, 0xE, 0xF0 | row);
+		setFx(0, (row * 2) + 1, 1, 0xE, 0xFF - row);
+	}
+
+	setFx(0, 32, 0, 0xE, 0xF0);
+	setNote(0, 34, 0, 14, 2, 0xE, 0xF8); // other sample while inverting
+	setNote(0, 36, 2, 24, 3, 0xE, 0xFF); // one-shot sample
+	setNote(0, 40, 3, 16, 1, 0xE, 0xFC);
+	setNote(0, 48, 0, 12, 1, 0, 0); // sample 1 was changed in memory
+
+	setNote(1, 0, 0, 12, 1, 0xE, 0xF7);
+	setFx(1, 8, 0, 0xE, 0x60);
+	setFx(1, 12, 0, 0xE, 0xFA);
+	setFx(1, 16, 0, 0xE, 0x62); // invert loop inside a pattern loop
+
+	return writeMod(dir, "fx_invert_loop.mod");
+}
+
+// 9xx sample offset: memory (900), past the sample end, on looping samples, and without a note
+static bool genSampleOffset(const char *dir)
+{
+	const uint8_t list[] = { 0 };
+
+	newMod("fx sample offset", 4);
+	setOrders(list, sizeof (list));
+	setSample(1, WAVE_NOISE, 4000, 0, 0, 0, 64);
+	setSample(2, WAVE_SAW, 3000, 1000, 2000, 5, 56);
+	setSample(3, WAVE_SQUARE, 200, 0, 0, 0, 64);
+
+	setNote(0, 0, 0, 12, 1, 0x9, 0x10);
+	setNote(0, 4, 0, 12, 1, 0x9, 0x00); // uses the last offset
+	setNote(0, 8, 0, 14, 1, 0x9, 0x30);
+	setNote(0, 12, 0, 14, 0, 0x9, 0x20); // no sample number
+	setFx(0, 14, 0, 0x9, 0x08); // no note, no effect
+	setNote(0, 16, 0, 12, 1, 0x9, 0xFF); // past the end of the sample
+	setNote(0, 20, 1, 10, 2, 0x9, 0x20);
+	setNote(0, 24, 1, 10, 2, 0x9, 0x0C); // past the end, into the loop
+	setNote(0, 28, 1, 10, 2, 0x9, 0xF0);
+	setNote(0, 32, 2, 20, 3, 0x9, 0x02);
+	setNote(0, 36, 2, 20, 3, 0x9, 0x04);
+	setNote(0, 40, 3, 16, 1, 0x9, 0x40);
+	setNote(0, 40, 2, 20, 3, 0x9, 0x00);
+	setNote(0, 44, 3, 16, 2, 0x3, 0x04); // tone portamento keeps the position
+	setFx(0, 46, 3, 0x9, 0x10);
+	setNote(0, 48, 3, 18, 1, 0xE, 0xD2); // note delay after an offset
+	setNote(0, 52, 3, 18, 1, 0x9, 0x20);
+	setFx(0, 53, 3, 0xE, 0x93); // retrig restarts from the offset
+
+	return writeMod(dir, "fx_sample_offset.mod");
+}
+
+// Fxx speed/tempo: every speed, a range of tempos, several Fxx on one row, and F00 to stop the song
+static bool genSpeedTempo(const char *dir)
+{
+	const uint8_t list[] = { 0, 1 };
+	int32_t row;
+
+	newMod("fx speed tempo", 5);
+	setOrders(list, sizeof (list));
+	setSample(1, WAVE_SQUARE, 16, 0, 16, 0, 40);
+	setSample(2, WAVE_NOISE, 300, 0, 0, 0, 64);
+
+	for (row = 0; row < 64; row++)
+		setNote(0, row, 0, row % 36, 1 + (row & 1), 0, 0);
+
+	for (row = 0; row < 32; row++)
+		setFx(0, row, 1, 0xF, row + 1);
+
+	for (row = 32; row < 64; row++)
+		setFx(0, row, 1, 0xF, 0x20 + ((row - 32) * 7));
+
+	setFx(0, 40, 2, 0xF, 0x02); // speed and tempo on the same row
+	setFx(0, 40, 3, 0xF, 0xFF);
+	setFx(0, 48, 2, 0xF, 0x20);
+	setFx(0, 48, 3, 0xF, 0x01);
+
+	setNote(1, 0, 0, 12, 1, 0xF, 0x06);
+	setNote(1, 4, 0, 12, 2, 0xE, 0xE2);
+	setFx(1, 4, 1, 0xF, 0x02);
+	setFx(1, 8, 1, 0xF, 0x00); // F00 stops the song
+
+	return writeMod(dir, "fx_speed_tempo.mod");
+}
+
+// the remaining effects, one or two of each per channel
+static bool genMiscEffects(const char *dir)
+{
+	const uint8_t list[] = { 0, 1 };
+
+	newMod("fx misc", 6);
+	setOrders(list, sizeof (list));
+	setSample(1, WAVE_SINE, 128, 0, 128, 0, 64);
+	setSample(2, WAVE_SAW, 64, 0, 64, 13, 48);
+	setSample(3, WAVE_NOISE, 1500, 0, 0, 0, 64);
+
+	setNote(0, 0, 0, 12, 1, 0x0, 0x37); // arpeggio
+	setNote(0, 4, 0, 12, 1, 0x1, 0x08); // portamento up
+	setFx(0, 6, 0, 0x2, 0x10); // portamento down
+	setNote(0, 8, 0, 20, 0, 0x3, 0x06); // tone portamento
+	setFx(0, 10, 0, 0x3, 0x00);
+	setFx(0, 12, 0, 0x5, 0x02); // tone portamento + volume slide
+	setNote(0, 16, 0, 12, 1, 0x4, 0x48); // vibrato
+	setFx(0, 18, 0, 0x6, 0x20); // vibrato + volume slide
+	setFx(0, 20, 0, 0xE, 0x41); // vibrato waveform
+	setFx(0, 22, 0, 0x4, 0x8F);
+	setNote(0, 24, 0, 12, 2, 0x7, 0x6C); // tremolo
+	setFx(0, 26, 0, 0xE, 0x72); // tremolo waveform
+	setFx(0, 28, 0, 0x7, 0x00);
+	setFx(0, 30, 0, 0xA, 0x40);
+	setNote(0, 32, 0, 12, 1, 0xE, 0x31); // glissando
+	setFx(0, 33, 0, 0x3, 0x04);
+
+	setNote(0, 0, 1, 24, 2, 0xC, 0x20); // set volume
+	setFx(0, 2, 1, 0xE, 0xA4); // fine volume slide up
+	setFx(0, 4, 1, 0xE, 0xB8); // fine volume slide down
+	setFx(0, 6, 1, 0xE, 0x13); // fine portamento up
+	setFx(0, 8, 1, 0xE, 0x25); // fine portamento down
+	setNote(0, 10, 1, 24, 2, 0xE, 0x5F); // set finetune
+	setNote(0, 12, 1, 24, 2, 0xE, 0x93); // retrig
+	setNote(0, 16, 1, 26, 2, 0xE, 0xC2); // note cut
+	setNote(0, 20, 1, 28, 2, 0xE, 0xD4); // note delay
+	setNote(0, 24, 1, 28, 2, 0xE, 0x01); // filter
+	setFx(0, 28, 1, 0xE, 0x00);
+	setNote(0, 32, 1, 24, 2, 0xC, 0x50); // volume > 64
+	setFx(0, 36, 1, 0xE, 0x80); // E8x (karplus strong)
+
+	setNote(0, 0, 2, 0, 3, 0x8, 0x40); // unused in PT, no effect
+	setNote(0, 8, 2, 35, 3, 0x1, 0xFF); // slide past the top
+	setNote(0, 16, 2, 0, 3, 0x2, 0xFF); // slide past the bottom
+	setNote(0, 24, 2, 12, 3, 0xA, 0xF1); // both nibbles set
+
+	setFx(0, 48, 3, 0xB, 0x01);
+
+	setNote(1, 0, 3, 12, 1, 0x0, 0x00);
+	setNote(1, 1, 3, -1, 0, 0x0, 0x47);
+	setFx(1, 8, 3, 0xD, 0x63); // break to an invalid row, becomes row 0
+
+	return writeMod(dir, "fx_misc.mod");
+}
+
+// dense random patterns, with all effects except Bxx (keeps the song length predictable)
+static bool genRandom(const char *dir, int32_t num)
+{
+	char fileName[32];
+	uint8_t list[8];
+	int32_t i, pat, row, ch, cmd, param, numPatterns;
+
+	snprintf(fileName, sizeof (fileName), "rnd_%02d.mod", num);
+	newMod(fileName, 1000 + num);
+
+	for (i = 1; i <= 8; i++)
+	{
+		const uint16_t length = (uint16_t)randomRange(100, 3000);
+
+		if (random32() & 1)
+			setSample(i, WAVE_NOISE, length, 0, 0, (uint8_t)randomRange(0, 15), (uint8_t)randomRange(20, 64));
+		else
+			setSample(i, randomRange(0, 3), length, (uint16_t)randomRange(0, length/2), (uint16_t)randomRange(2, length/2), (uint8_t)randomRange(0, 15), (uint8_t)randomRange(20, 64));
+	}
+
+	numPatterns = 3;
+	for (i = 0; i < 6; i++)
+		list[i] = (uint8_t)randomRange(0, numPatterns-1);
+	list[0] = 0;
+	list[6] = 1; // make sure that all patterns are used
+	list[7] = 2;
+	setOrders(list, 8);
+
+	for (pat = 0; pat < numPatterns; pat++)
+	{
+		for (row = 0; row < 64; row++)
+		{
+			for (ch = 0; ch < 4; ch++)
+			{
+				if (random32() & 1)
+					continue;
+
+				cmd = randomRange(0, 15);
+				param = randomRange(0, 255);
+
+				if (cmd == 0xB)
+					cmd = 0; // no jumps
+				else if (cmd == 0xD)
+					param = 0x00;
+				else if (cmd == 0xF)
+					param = (random32() & 1) ? randomRange(1, 0x1F) : randomRange(0x20, 0xFF);
+				else if (cmd == 0xE && (param >> 4) == 6)
+					param &= 0xF3; // short loops only
+
+				setNote(pat, row, ch, randomRange(0, 35), randomRange(1, 8), cmd, param);
+			}
+		}
+	}
+
+	return writeMod(dir, fileName);
+}
+
+int main(int argc, char *argv[])
+{
+	bool ok;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: gen_test_mods <output dir>\n");
+		return 1;
+	}
+
+	ok = genPatternLoop(argv[1]) && genPatternDelay(argv[1]) && genInvertLoop(argv[1]) &&
+	     genSampleOffset(argv[1]) && genSpeedTempo(argv[1]) && genMiscEffects(argv[1]);
+
+	for (int32_t i = 0; ok && i < 4; i++)
+		ok = genRandom(argv[1], i);
+
+	return ok ? 0 : 1;
+}
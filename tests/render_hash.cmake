@@ -0,0 +1,73 @@
+# Replayer/mixer regression test, run by ctest (see tests/CMakeLists.txt):
+#
+#   cmake -DPT2=<pt2-clone> -DGEN=<gen_test_mods> -DWORK_DIR=<dir> -DGOLDEN=<file>
+#         [-DUPDATE_GOLDEN=ON] -P render_hash.cmake
+#
+# Generates the test modules, renders them with "pt2-clone --render-hash" and
+# compares the hashes with the golden file. The per-module load/render times
+# are written to <WORK_DIR>/render_hash_timing.txt. With UPDATE_GOLDEN=ON, the
+# golden file is rewritten instead (only do this with a known good build).
+
+foreach(var PT2 GEN WORK_DIR GOLDEN)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "render_hash.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+set(corpus_dir "${WORK_DIR}/corpus")
+file(REMOVE_RECURSE "${corpus_dir}")
+file(MAKE_DIRECTORY "${corpus_dir}")
+
+execute_process(COMMAND "${GEN}" "${corpus_dir}" RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "gen_test_mods failed (${result})")
+endif()
+
+file(GLOB mods RELATIVE "${corpus_dir}" "${corpus_dir}/*.mod")
+list(SORT mods)
+
+# relative file names, so that the output doesn't depend on the build directory
+execute_process(COMMAND "${PT2}" --render-hash ${mods}
+    WORKING_DIRECTORY "${corpus_dir}"
+    OUTPUT_VARIABLE hashes
+    ERROR_VARIABLE timing
+    RESULT_VARIABLE result)
+
+file(WRITE "${WORK_DIR}/render_hash_timing.txt" "${timing}")
+message(STATUS "render times:\n${timing}")
+
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "pt2-clone --render-hash failed (${result})")
+endif()
+
+if(UPDATE_GOLDEN)
+    file(WRITE "${GOLDEN}" "${hashes}")
+    message(STATUS "wrote ${GOLDEN}")
+    return()
+endif()
+
+file(READ "${GOLDEN}" golden)
+if(hashes STREQUAL golden)
+    return()
+endif()
+
+file(WRITE "${WORK_DIR}/render_hash.txt" "${hashes}")
+
+string(REPLACE "\n" ";" expected_lines "${golden}")
+string(REPLACE "\n" ";" actual_lines "${hashes}")
+set(report "")
+foreach(line IN LISTS expected_lines)
+    list(FIND actual_lines "${line}" index)
+    if(index EQUAL -1 AND NOT line STREQUAL "")
+        set(report "${report}  expected: ${line}\n")
+    endif()
+endforeach()
+foreach(line IN LISTS actual_lines)
+    list(FIND expected_lines "${line}" index)
+    if(index EQUAL -1 AND NOT line STREQUAL "")
+        set(report "${report}       got: ${line}\n")
+    endif()
+endforeach()
+
+message(FATAL_ERROR "render hashes differ from ${GOLDEN}:\n${report}"
+    "(the full output is in ${WORK_DIR}/render_hash.txt)")
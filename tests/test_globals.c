@@ -0,0 +1,12 @@
+/* The globals that pt2_main.c defines for the rest of the program, for test
+** programs that link against the pt2-core objects instead of pt2_main.c. */
+
+#include <stdint.h>
+#include <SDL2/SDL.h>
+#include "pt2_header.h"
+
+module_t *modEntry = NULL;
+uint32_t *pixelBuffer = NULL;
+SDL_Window *window = NULL;
+SDL_Renderer *renderer = NULL;
+SDL_Texture *texture = NULL;
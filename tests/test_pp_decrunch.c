@@ -0,0 +1,627 @@
+/* Tests ppdecrunch() (pt2_modloader.c) against the original bit-by-bit decruncher.
+**
+** usage: test_pp_decrunch [fuzz iterations per file]
+**
+** The corpus is made here with a fixed-seed PRNG: module-like data (runs, repeated
+** blocks, noise) of different sizes, crunched with a small PP20 cruncher and a few
+** offset length sets. For every file:
+**  - both decrunchers must give back the original data
+**  - the file is mutated (bit flips, offset lengths, skip bits, truncation), and
+**    whenever ppdecrunch() accepts it, the old decruncher must give the same output.
+**    Run this in an ASan build to catch out-of-bounds reads/writes on bad input.
+**  - the throughput of both is printed (not checked, it depends on the machine)
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+#include "pt2_modloader.h"
+
+#define DEFAULT_FUZZ_ITERATIONS 500
+#define MAX_CHAIN 64
+#define MAX_MATCH_LEN (5 + (7 * 100))
+
+static uint32_t randSeed;
+
+static uint32_t random32(void)
+{
+	randSeed = (randSeed * 1103515245) + 12345;
+	return randSeed >> 8;
+}
+
+/* ------------------------------------------------------------------------- */
+/*            The decruncher before it was rewritten (reference)            */
+/* ------------------------------------------------------------------------- */
+
+/* Code taken from Heikki Orsila's amigadepack. Seems to have no license,
+** so I'll assume it fits into wtfpl (wtfpl.net). Heikki should contact me
+** if it shall not.
+** Modified by 8bitbubsy */
+
+#define OPP_READ_BITS(nbits, var)            \
+  bitCnt = (nbits);                         \
+  while (bitsLeft < bitCnt) {               \
+	if (bufSrc < src) return false;         \
+	bitBuffer |= ((uint32_t)*--bufSrc << bitsLeft); \
+	bitsLeft += 8;                          \
+  }                                         \
+  (var) = 0;                                \
+  bitsLeft -= bitCnt;                       \
+  while (bitCnt--) {                        \
+	(var) = ((var) << 1) | (bitBuffer & 1); \
+	bitBuffer >>= 1;                        \
+  }                                         \
+
+/* note: reads one byte before src at the end of the stream, the caller has to allow that.
+** (the uint32_t cast in OPP_READ_BITS is the only change, for UBSan) */
+static bool ppdecrunchOld(const uint8_t *src, uint8_t *dst, const uint8_t *offsetLens, uint32_t srcLen, uint32_t dstLen, uint8_t skipBits)
+{
+	const uint8_t *bufSrc;
+	uint8_t *dstEnd, *out, bitsLeft, bitCnt;
+	uint32_t x, todo, offBits, offset, written, bitBuffer;
+
+	if (src == NULL || dst == NULL || offsetLens == NULL)
+		return false;
+
+	bitsLeft = 0;
+	bitBuffer = 0;
+	written = 0;
+	bufSrc = src + srcLen;
+	out = dst + dstLen;
+	dstEnd = out;
+
+	OPP_READ_BITS(skipBits, x);
+	while (written < dstLen)
+	{
+		OPP_READ_BITS(1, x);
+		if (x == 0)
+		{
+			todo = 1;
+
+			do
+			{
+				OPP_READ_BITS(2, x);
+				todo += x;
+			}
+			while (x == 3);
+
+			while (todo--)
+			{
+				OPP_READ_BITS(8, x);
+
+				if (out <= dst)
+					return false;
+
+				*--out = (uint8_t)x;
+				written++;
+			}
+
+			if (written == dstLen)
+				break;
+		}
+
+		OPP_READ_BITS(2, x);
+
+		offBits = offsetLens[x];
+		todo = x + 2;
+
+		if (x == 3)
+		{
+			OPP_READ_BITS(1, x);
+			if (x == 0) offBits = 7;
+
+			OPP_READ_BITS((uint8_t)offBits, offset);
+			do
+			{
+				OPP_READ_BITS(3, x);
+				todo += x;
+			}
+			while (x == 7);
+		}
+		else
+		{
+			OPP_READ_BITS((uint8_t)offBits, offset);
+		}
+
+		if (out+offset >= dstEnd)
+			return false;
+
+		while (todo--)
+		{
+			x = out[offset];
+
+			if (out <= dst)
+				return false;
+
+			*--out = (uint8_t)x;
+			written++;
+		}
+	}
+
+	return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/*            PP20 cruncher (greedy, only made to produce test data)        */
+/* ------------------------------------------------------------------------- */
+
+/* The decruncher writes the data from the end to the start, so the cruncher works
+** backwards too: at position p (bytes p.. are done), it looks for the longest run
+** of data[p-1], data[p-2], ... that also starts at data[p-1+d], with d > 0. */
+
+typedef struct bitWriter_t
+{
+	uint8_t *bits; // one bit per byte, in stream order
+	uint32_t numBits, size;
+} bitWriter_t;
+
+static bool putBits(bitWriter_t *w, uint32_t value, int32_t numBits)
+{
+	if (w->numBits+numBits > w->size)
+	{
+		uint8_t *newPtr = (uint8_t *)realloc(w->bits, (w->size * 2) + numBits);
+		if (newPtr == NULL)
+			return false;
+
+		w->bits = newPtr;
+		w->size = (w->size * 2) + numBits;
+	}
+
+	for (int32_t i = numBits-1; i >= 0; i--)
+		w->bits[w->numBits++] = (value >> i) & 1;
+
+	return true;
+}
+
+static bool putLiterals(bitWriter_t *w, const uint8_t *data, uint32_t p, uint32_t numLiterals)
+{
+	uint32_t c, todo;
+
+	// the literals are data[p+numLiterals-1] down to data[p]
+	todo = numLiterals - 1;
+	do
+	{
+		c = (todo > 3) ? 3 : todo;
+		if (!putBits(w, c, 2))
+			return false;
+
+		todo -= c;
+	}
+	while (c == 3);
+
+	for (uint32_t i = numLiterals; i-- > 0;)
+	{
+		if (!putBits(w, data[p+i], 8))
+			return false;
+	}
+
+	return true;
+}
+
+// returns a malloc'd PP20 file
+static uint8_t *ppCrunch(const uint8_t *data, uint32_t dataLen, const uint8_t *offsetLens, uint32_t *outLen)
+{
+	uint8_t *out, x = 0;
+	uint32_t p, q, i, j, len, bestLen, bestDist, matchLen, numLiterals, skip, streamLen, key, *head, *prev;
+	bitWriter_t w;
+
+	head = (uint32_t *)calloc(65536, sizeof (uint32_t)); // 0 = none (positions added are >= 2)
+	prev = (uint32_t *)calloc(dataLen + 1, sizeof (uint32_t));
+	memset(&w, 0, sizeof (w));
+	out = NULL;
+
+	if (head == NULL || prev == NULL)
+		goto error;
+
+#define ADD_POS(pos) \
+	if ((pos) >= 2) \
+	{ \
+		key = (data[(pos)-2] << 8) | data[(pos)-1]; \
+		prev[pos] = head[key]; \
+		head[key] = (pos); \
+	}
+
+	numLiterals = 0;
+	p = dataLen;
+	while (p > 0)
+	{
+		// find the longest match, nearest first
+		bestLen = bestDist = 0;
+		if (p >= 2)
+		{
+			q = head[(data[p-2] << 8) | data[p-1]];
+			for (i = 0; q != 0 && i < MAX_CHAIN; i++, q = prev[q])
+			{
+				const uint32_t d = q - p;
+				if (d-1 >= (1UL << offsetLens[3]))
+					break; // the chain only gets further away
+
+				len = 0;
+				while (len < p && len < MAX_MATCH_LEN && data[p-1-len] == data[p-1-len+d])
+					len++;
+
+				if (len > bestLen)
+				{
+					bestLen = len;
+					bestDist = d;
+				}
+			}
+		}
+
+		// short matches need an offset that fits the field of their length
+		matchLen = 0;
+		if (bestLen >= 5)
+		{
+			x = 3;
+			matchLen = bestLen;
+		}
+		else
+		{
+			for (j = (bestLen >= 2) ? bestLen-1 : 0; j-- > 0;)
+			{
+				if (bestDist-1 < (1UL << offsetLens[j]))
+				{
+					x = (uint8_t)j;
+					matchLen = j + 2;
+					break;
+				}
+			}
+		}
+
+		if (matchLen == 0)
+		{
+			numLiterals++;
+			p--;
+			ADD_POS(p+1)
+			continue;
+		}
+
+		if (numLiterals > 0)
+		{
+			if (!putBits(&w, 0, 1) || !putLiterals(&w, data, p, numLiterals))
+				goto error;
+
+			numLiterals = 0;
+		}
+		else
+		{
+			if (!putBits(&w, 1, 1))
+				goto error;
+		}
+
+		if (!putBits(&w, x, 2))
+			goto error;
+
+		if (x == 3)
+		{
+			if (bestDist-1 < 128)
+			{
+				if (!putBits(&w, 0, 1) || !putBits(&w, bestDist-1, 7))
+					goto error;
+			}
+			else
+			{
+				if (!putBits(&w, 1, 1) || !putBits(&w, bestDist-1, offsetLens[3]))
+					goto error;
+			}
+
+			len = matchLen - 5;
+			do
+			{
+				j = (len > 7) ? 7 : len;
+				if (!putBits(&w, j, 3))
+					goto error;
+
+				len -= j;
+			}
+			while (j == 7);
+		}
+		else
+		{
+			if (!putBits(&w, bestDist-1, offsetLens[x]))
+				goto error;
+		}
+
+		for (i = 0; i < matchLen; i++)
+		{
+			ADD_POS(p-i)
+		}
+
+		p -= matchLen;
+	}
+
+	if (numLiterals > 0 && (!putBits(&w, 0, 1) || !putLiterals(&w, data, 0, numLiterals)))
+		goto error;
+
+#undef ADD_POS
+
+	// the stream is padded to longwords at its start, the skip bits are read first
+	streamLen = ((w.numBits + 31) / 32) * 4;
+	skip = (streamLen * 8) - w.numBits;
+
+	*outLen = 8 + streamLen + 4;
+	out = (uint8_t *)calloc(*outLen, 1);
+	if (out == NULL)
+		goto error;
+
+	memcpy(out, "PP20", 4);
+	memcpy(&out[4], offsetLens, 4);
+
+	// bit k of the stream (counting the skip bits) is read k-th, from the end of the stream
+	for (i = 0; i < w.numBits; i++)
+	{
+		const uint32_t k = skip + i;
+		if (w.bits[i])
+			out[8 + streamLen - 1 - (k / 8)] |= (uint8_t)(1 << (k & 7));
+	}
+
+	out[8+streamLen+0] = (uint8_t)(dataLen >> 16);
+	out[8+streamLen+1] = (uint8_t)(dataLen >> 8);
+	out[8+streamLen+2] = (uint8_t)dataLen;
+	out[8+streamLen+3] = (uint8_t)skip;
+
+	free(w.bits);
+	free(prev);
+	free(head);
+	return out;
+
+error:
+	if (w.bits != NULL) free(w.bits);
+	if (prev != NULL) free(prev);
+	if (head != NULL) free(head);
+	return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+
+// module-like data: sample noise, runs of a byte, and copies of earlier blocks
+static void makeTestData(uint8_t *dst, uint32_t len)
+{
+	uint32_t i, blockLen, from;
+
+	i = 0;
+	while (i < len)
+	{
+		blockLen = 1 + (random32() % 600);
+		if (blockLen > len-i)
+			blockLen = len-i;
+
+		switch (random32() % 4)
+		{
+			case 0: // noise
+			{
+				for (uint32_t j = 0; j < blockLen; j++)
+					dst[i+j] = (uint8_t)random32();
+			}
+			break;
+
+			case 1: // run
+			{
+				const uint8_t c = (random32() & 1) ? 0 : (uint8_t)random32();
+				memset(&dst[i], c, blockLen);
+			}
+			break;
+
+			case 2: // slow waveform, like 8-bit sample data
+			{
+				int32_t y = (int8_t)random32();
+				const int32_t step = 1 + (random32() % 4);
+				for (uint32_t j = 0; j < blockLen; j++)
+				{
+					y += (random32() & 1) ? step : -step;
+					dst[i+j] = (uint8_t)y;
+				}
+			}
+			break;
+
+			default: // copy of an earlier block (pattern data repeats a lot)
+			{
+				if (i == 0)
+				{
+					memset(dst, 0x20, blockLen);
+				}
+				else
+				{
+					from = random32() % i;
+					for (uint32_t j = 0; j < blockLen; j++)
+						dst[i+j] = dst[from+j]; // may overlap, like a run of a pattern
+				}
+			}
+			break;
+		}
+
+		i += blockLen;
+	}
+}
+
+static double getMs(uint64_t time64)
+{
+	return (time64 * 1000.0) / (double)SDL_GetPerformanceFrequency();
+}
+
+// min. time of a few runs, in ms
+static double timeDecrunch(bool old, const uint8_t *file, uint32_t fileLen, uint8_t *dst, uint32_t dstLen)
+{
+	uint64_t time64, bestTime64 = UINT64_MAX;
+
+	for (int32_t i = 0; i < 5; i++)
+	{
+		time64 = SDL_GetPerformanceCounter();
+		if (old)
+			ppdecrunchOld(file + 8, dst, file + 4, fileLen - 12, dstLen, file[fileLen-1]);
+		else
+			ppdecrunch(file + 8, dst, file + 4, fileLen - 12, dstLen, file[fileLen-1]);
+		time64 = SDL_GetPerformanceCounter() - time64;
+
+		if (time64 < bestTime64)
+			bestTime64 = time64;
+	}
+
+	return getMs(bestTime64);
+}
+
+// returns the number of mismatches
+static int32_t fuzzFile(const uint8_t *file, uint32_t fileLen, uint32_t dstLen, int32_t iterations, int32_t *numAccepted)
+{
+	bool lensOk, newOk, oldOk;
+	uint8_t *mutated, *dstNew, *dstOld, skipBits;
+	uint32_t srcLen, pos;
+	int32_t i, j, numFlips, numMismatches;
+
+	numMismatches = 0;
+	for (i = 0; i < iterations; i++)
+	{
+		/* exact-size buffers, so that ASan sees every out-of-bounds access of ppdecrunch().
+		** The old decruncher reads mutated[7] at the end of the stream, that's in bounds. */
+		mutated = (uint8_t *)malloc(fileLen);
+		dstNew = (uint8_t *)malloc(dstLen);
+		dstOld = (uint8_t *)malloc(dstLen);
+		if (mutated == NULL || dstNew == NULL || dstOld == NULL)
+		{
+			fprintf(stderr, "out of memory\n");
+			exit(1);
+		}
+
+		memcpy(mutated, file, fileLen);
+
+		numFlips = 1 + (random32() % 4);
+		for (j = 0; j < numFlips; j++)
+		{
+			pos = 4 + (random32() % (fileLen - 8)); // offset lengths and stream
+			mutated[pos] ^= (uint8_t)(1 << (random32() & 7));
+		}
+
+		if ((random32() & 7) == 0)
+			mutated[fileLen-1] = (uint8_t)(random32() % 40); // skip bits
+
+		if ((random32() & 7) == 0)
+			mutated[4 + (random32() & 3)] = (uint8_t)(random32() % 20); // offset length
+
+		srcLen = fileLen - 12;
+		if ((random32() & 7) == 0)
+			srcLen = random32() % srcLen; // truncated
+
+		skipBits = mutated[fileLen-1];
+
+		memset(dstNew, 0, dstLen);
+		newOk = ppdecrunch(mutated + 8, dstNew, mutated + 4, srcLen, dstLen, skipBits);
+		if (newOk)
+		{
+			(*numAccepted)++;
+
+			// the old one reads the skip bits into a 32-bit buffer with up to 7 bits in it
+			lensOk = true;
+			for (j = 0; j < 4; j++)
+			{
+				if (mutated[4+j] > 16)
+					lensOk = false;
+			}
+
+			if (lensOk && skipBits <= 24)
+			{
+				memset(dstOld, 0, dstLen);
+				oldOk = ppdecrunchOld(mutated + 8, dstOld, mutated + 4, srcLen, dstLen, skipBits);
+				if (!oldOk || memcmp(dstOld, dstNew, dstLen) != 0)
+					numMismatches++;
+			}
+		}
+
+		free(dstOld);
+		free(dstNew);
+		free(mutated);
+	}
+
+	return numMismatches;
+}
+
+int main(int argc, char *argv[])
+{
+	const uint8_t offsetLensSets[4][4] = { { 9, 10, 12, 13 }, { 9, 10, 11, 11 }, { 9, 10, 12, 12 }, { 7, 8, 9, 16 } };
+	const uint32_t sizes[] = { 1, 2, 7, 100, 1084, 4000, 31337, 65536, 250000 };
+
+	uint8_t *data, *file, *dst;
+	uint32_t fileLen, dataLen;
+	int32_t fuzzIterations, numFiles, numFailed, numAccepted;
+	double dOldMs, dNewMs, dTotalBytes;
+
+	fuzzIterations = (argc >= 2) ? atoi(argv[1]) : DEFAULT_FUZZ_ITERATIONS;
+
+	randSeed = 1;
+	numFiles = numFailed = numAccepted = 0;
+	dOldMs = dNewMs = dTotalBytes = 0.0;
+
+	for (uint32_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+	{
+		for (int32_t l = 0; l < 4; l++)
+		{
+			dataLen = sizes[s];
+
+			data = (uint8_t *)malloc(dataLen);
+			dst = (uint8_t *)malloc(dataLen);
+			if (data == NULL || dst == NULL)
+			{
+				fprintf(stderr, "out of memory\n");
+				return 1;
+			}
+
+			makeTestData(data, dataLen);
+
+			file = ppCrunch(data, dataLen, offsetLensSets[l], &fileLen);
+			if (file == NULL)
+			{
+				fprintf(stderr, "out of memory\n");
+				return 1;
+			}
+
+			numFiles++;
+
+			memset(dst, 0, dataLen);
+			if (!ppdecrunch(file + 8, dst, file + 4, fileLen - 12, dataLen, file[fileLen-1]) || memcmp(dst, data, dataLen) != 0)
+			{
+				fprintf(stderr, "ppdecrunch() failed on %u bytes (offset lengths %d,%d,%d,%d)\n", dataLen,
+					offsetLensSets[l][0], offsetLensSets[l][1], offsetLensSets[l][2], offsetLensSets[l][3]);
+				numFailed++;
+			}
+
+			memset(dst, 0, dataLen);
+			if (!ppdecrunchOld(file + 8, dst, file + 4, fileLen - 12, dataLen, file[fileLen-1]) || memcmp(dst, data, dataLen) != 0)
+			{
+				fprintf(stderr, "the old decruncher failed on %u bytes, the test cruncher is broken\n", dataLen);
+				numFailed++;
+			}
+
+			if (dataLen >= 65536)
+			{
+				dOldMs += timeDecrunch(true, file, fileLen, dst, dataLen);
+				dNewMs += timeDecrunch(false, file, fileLen, dst, dataLen);
+				dTotalBytes += dataLen;
+			}
+
+			if (fileLen > 12)
+			{
+				const int32_t numMismatches = fuzzFile(file, fileLen, dataLen, fuzzIterations, &numAccepted);
+				if (numMismatches > 0)
+				{
+					fprintf(stderr, "%d mutated files of %u bytes decrunched differently\n", numMismatches, dataLen);
+					numFailed++;
+				}
+			}
+
+			free(file);
+			free(dst);
+			free(data);
+		}
+	}
+
+	printf("%d files, %d failed, %d mutated files accepted\n", numFiles, numFailed, numAccepted);
+	if (dOldMs > 0.0 && dNewMs > 0.0)
+	{
+		printf("throughput: old %.1f MB/s, new %.1f MB/s\n",
+			dTotalBytes / (dOldMs * 1000.0), dTotalBytes / (dNewMs * 1000.0));
+	}
+
+	return (numFailed == 0) ? 0 : 1;
+}
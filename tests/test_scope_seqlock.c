@@ -0,0 +1,121 @@
+/* Stress test for the scope snapshot seqlock (pt2_scopes.c).
+**
+** A writer thread publishes snapshots as fast as it can, while the main thread
+** reads them with updateScopes(). Every field of snapshot k is derived from k,
+** so a torn copy (fields from two different snapshots) shows up as channels or
+** fields that don't agree with each other. The newest snapshot must also never
+** go backwards.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include "pt2_header.h"
+#include "pt2_scopes.h"
+
+#define NUM_SNAPSHOTS 4000000
+
+static int8_t sampleBufA[16], sampleBufB[16];
+static SDL_atomic_t writerDone;
+
+static void makeSnapshot(scopeSnapshot_t *s, int32_t k)
+{
+	s->time64 = 0; // always audible, so updateScopes() takes the newest one
+	s->tapPos = (uint32_t)k;
+
+	for (int32_t i = 0; i < AMIGA_VOICES; i++)
+	{
+		scopeVoice_t *v = &s->voice[i];
+
+		v->active = true;
+		v->data = (k & 1) ? sampleBufA : sampleBufB;
+		v->newData = (k & 1) ? sampleBufB : sampleBufA;
+		v->pos = k + i;
+		v->length = k + 1000 + i;
+		v->newLength = k + 2000 + i;
+		v->dPhase = 0.0;
+		v->dDelta = 0.0;
+	}
+}
+
+static int32_t SDLCALL writerThreadFunc(void *ptr)
+{
+	scopeSnapshot_t s;
+
+	(void)ptr;
+
+	for (int32_t k = 1; k <= NUM_SNAPSHOTS; k++)
+	{
+		makeSnapshot(&s, k);
+		publishScopeSnapshot(&s);
+	}
+
+	SDL_AtomicSet(&writerDone, 1);
+	return 0;
+}
+
+// returns the snapshot number, or -1 if the channels don't come from one snapshot
+static int32_t checkScopes(void)
+{
+	const int32_t k = scope[0].pos;
+
+	for (int32_t i = 0; i < AMIGA_VOICES; i++)
+	{
+		const scopeChannel_t *sc = &scope[i];
+
+		if (!sc->active || sc->pos != k+i || sc->length != k+1000+i || sc->newLength != k+2000+i)
+			return -1;
+
+		if (sc->data != ((k & 1) ? sampleBufA : sampleBufB) || sc->newData != ((k & 1) ? sampleBufB : sampleBufA))
+			return -1;
+	}
+
+	return k;
+}
+
+int main(void)
+{
+	int32_t k, lastK, numReads, numTorn, numBackwards;
+	SDL_Thread *writerThread;
+
+	editor.dPerfFreq = (double)SDL_GetPerformanceFrequency();
+	audio.dAudioFreq = 48000.0;
+	audio.audioBufferSize = 1024;
+	ptConfig.realVuMeters = false;
+
+	writerThread = SDL_CreateThread(writerThreadFunc, "scope writer", NULL);
+	if (writerThread == NULL)
+	{
+		fprintf(stderr, "couldn't create the writer thread\n");
+		return 1;
+	}
+
+	lastK = 0;
+	numReads = numTorn = numBackwards = 0;
+	while (!SDL_AtomicGet(&writerDone))
+	{
+		updateScopes();
+		if (!scope[0].active)
+			continue; // nothing published yet, or every slot was being written
+
+		numReads++;
+
+		k = checkScopes();
+		if (k < 0)
+		{
+			numTorn++;
+			continue;
+		}
+
+		if (k < lastK)
+			numBackwards++;
+
+		lastK = k;
+	}
+
+	SDL_WaitThread(writerThread, NULL);
+
+	printf("%d reads, %d torn, %d went backwards\n", numReads, numTorn, numBackwards);
+	return (numReads > 0 && numTorn == 0 && numBackwards == 0) ? 0 : 1;
+}